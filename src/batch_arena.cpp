@@ -0,0 +1,161 @@
+/**
+ * @file batch_arena.cpp
+ * @brief Implémentation de l'arène des lots de synchronisation
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "batch_arena.h"
+#include <cstdint>
+#include <cstdlib>
+
+// Arène active pour le thread courant
+static thread_local BatchArena* t_currentArena = nullptr;
+
+/**
+ * @brief Constructeur - réserve le premier bloc
+ */
+BatchArena::BatchArena(size_t blockSize)
+    : m_offset(0)
+    , m_allocationCount(0)
+    , m_bytesUsed(0)
+    , m_minBlockSize(blockSize)
+    , m_averageBatch(0)
+{
+    AddBlock(blockSize);
+}
+
+/**
+ * @brief Destructeur - libère tous les blocs
+ */
+BatchArena::~BatchArena()
+{
+    for (auto& block : m_blocks)
+    {
+        free(block.data);
+    }
+}
+
+/**
+ * @brief Ajoute un bloc d'au moins minSize octets
+ *
+ * Chaque nouveau bloc double la taille du précédent pour limiter leur nombre.
+ */
+void BatchArena::AddBlock(size_t minSize)
+{
+    size_t size = m_blocks.empty() ? minSize : m_blocks.back().size * 2;
+    if (size < minSize)
+        size = minSize;
+
+    char* data = static_cast<char*>(malloc(size));
+    if (!data)
+        throw std::bad_alloc();
+
+    m_blocks.push_back({ data, size });
+    m_offset = 0;
+}
+
+/**
+ * @brief Alloue de la mémoire dans l'arène
+ */
+void* BatchArena::Allocate(size_t bytes, size_t alignment)
+{
+    Block* block = &m_blocks.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->data);
+    size_t aligned = ((base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+
+    if (aligned + bytes > block->size)
+    {
+        AddBlock(bytes + alignment);
+        block = &m_blocks.back();
+        base = reinterpret_cast<uintptr_t>(block->data);
+        aligned = ((base + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+    }
+
+    m_offset = aligned + bytes;
+    m_allocationCount++;
+    m_bytesUsed += bytes;
+    return block->data + aligned;
+}
+
+/**
+ * @brief Indique si un pointeur provient de cette arène
+ */
+bool BatchArena::Owns(const void* ptr) const
+{
+    const char* p = static_cast<const char*>(ptr);
+    for (const auto& block : m_blocks)
+    {
+        if (p >= block.data && p < block.data + block.size)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Mémoire réservée par l'arène
+ */
+size_t BatchArena::ReservedBytes() const
+{
+    size_t total = 0;
+    for (const auto& block : m_blocks)
+        total += block.size;
+    return total;
+}
+
+/**
+ * @brief Libère d'un coup tous les objets du lot
+ *
+ * La moyenne des lots suit les trois quarts de sa valeur précédente plus un
+ * quart du lot qui se termine : un lot exceptionnel l'élève, puis elle
+ * redescend de 25 % par lot ordinaire. Un bloc plus de deux fois plus grand
+ * que le plafond est rendu et remplacé par un bloc à la taille du plafond ;
+ * entre les deux, il est gardé pour ne pas réallouer à chaque lot.
+ */
+void BatchArena::Reset()
+{
+    m_averageBatch = (3 * m_averageBatch + m_bytesUsed) / 4;
+    size_t limit = RETAIN_FACTOR * m_averageBatch;
+    if (limit < m_minBlockSize)
+        limit = m_minBlockSize;
+
+    const size_t total = ReservedBytes();
+    if (m_blocks.size() > 1 || total > 2 * limit)
+    {
+        for (auto& block : m_blocks)
+        {
+            free(block.data);
+        }
+        m_blocks.clear();
+        AddBlock(total < limit ? total : limit);
+    }
+
+    m_offset = 0;
+    m_allocationCount = 0;
+    m_bytesUsed = 0;
+}
+
+/**
+ * @brief Arène active du thread courant
+ */
+BatchArena* BatchArena::Current()
+{
+    return t_currentArena;
+}
+
+/**
+ * @brief Active l'arène pour le thread courant
+ */
+BatchArena::Scope::Scope(BatchArena& arena)
+    : m_previous(t_currentArena)
+{
+    t_currentArena = &arena;
+}
+
+/**
+ * @brief Restaure l'arène précédente
+ */
+BatchArena::Scope::~Scope()
+{
+    t_currentArena = m_previous;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file batch_arena.h
+ * @brief Arène monotone pour les objets temporaires d'un lot de synchronisation
+ *
+ * Le traitement d'une réponse /sync crée beaucoup de petits objets (noeuds
+ * du DOM JSON, tableaux, maps) qui meurent tous à la fin du lot. Ils sont
+ * alloués ici par simple incrément de pointeur, puis libérés d'un coup par
+ * Reset() au lieu d'un free() par objet.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef BATCH_ARENA_H
+#define BATCH_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * @class BatchArena
+ * @brief Allocateur par incrément, remis à zéro après chaque lot
+ *
+ * L'arène active du thread courant est définie par un BatchArena::Scope ;
+ * BatchAllocator s'en sert pour les conteneurs qui ne peuvent pas porter
+ * d'état (comme ceux de nlohmann::basic_json).
+ */
+class BatchArena
+{
+public:
+    /**
+     * @brief Constructeur
+     * @param blockSize Taille du premier bloc (en octets)
+     */
+    explicit BatchArena(size_t blockSize = 64 * 1024);
+
+    /**
+     * @brief Destructeur - libère tous les blocs
+     */
+    ~BatchArena();
+
+    BatchArena(const BatchArena&) = delete;
+    BatchArena& operator=(const BatchArena&) = delete;
+
+    /**
+     * @brief Alloue de la mémoire dans l'arène
+     * @param bytes Taille demandée
+     * @param alignment Alignement demandé (puissance de 2)
+     */
+    void* Allocate(size_t bytes, size_t alignment);
+
+    /**
+     * @brief Indique si un pointeur provient de cette arène
+     */
+    bool Owns(const void* ptr) const;
+
+    /**
+     * @brief Libère d'un coup tous les objets du lot
+     *
+     * Si le lot a débordé du premier bloc, les blocs sont fusionnés en un seul
+     * assez grand pour que le lot suivant tienne sans nouvel appel système.
+     * Le bloc gardé est plafonné à RETAIN_FACTOR fois la taille moyenne des
+     * lots récents : après une grosse synchronisation initiale, il revient
+     * à la taille des lots incrémentaux au lieu de rester au maximum atteint.
+     */
+    void Reset();
+
+    /**
+     * @brief Statistiques du lot courant
+     */
+    size_t AllocationCount() const { return m_allocationCount; }
+    size_t BytesUsed() const { return m_bytesUsed; }
+    size_t BlockCount() const { return m_blocks.size(); }
+
+    /**
+     * @brief Mémoire réservée par l'arène (tous les blocs)
+     */
+    size_t ReservedBytes() const;
+
+    /**
+     * @brief Arène active du thread courant (nullptr si aucune)
+     */
+    static BatchArena* Current();
+
+    /**
+     * @class Scope
+     * @brief Active une arène pour le thread courant le temps d'un bloc
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(BatchArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        BatchArena* m_previous;
+    };
+
+private:
+    struct Block
+    {
+        char* data;
+        size_t size;
+    };
+
+    // Plafond du bloc gardé par Reset, en multiple de la taille moyenne d'un lot
+    static constexpr size_t RETAIN_FACTOR = 2;
+
+    std::vector<Block> m_blocks;
+    size_t m_offset;            // Position libre dans le dernier bloc
+    size_t m_allocationCount;   // Allocations servies depuis le dernier Reset
+    size_t m_bytesUsed;         // Octets servis depuis le dernier Reset
+    size_t m_minBlockSize;      // Taille du premier bloc, jamais rendue
+    size_t m_averageBatch;      // Moyenne glissante des octets servis par lot
+
+    /**
+     * @brief Ajoute un bloc d'au moins minSize octets
+     */
+    void AddBlock(size_t minSize);
+};
+
+/**
+ * @class BatchAllocator
+ * @brief Allocateur standard qui sert depuis l'arène active du thread
+ *
+ * Sans arène active, se comporte comme std::allocator. La libération d'un
+ * objet de l'arène est sans effet : la mémoire est rendue au Reset().
+ */
+template <typename T>
+class BatchAllocator
+{
+public:
+    using value_type = T;
+
+    BatchAllocator() noexcept = default;
+
+    template <typename U>
+    BatchAllocator(const BatchAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        if (BatchArena* arena = BatchArena::Current())
+            return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t) noexcept
+    {
+        BatchArena* arena = BatchArena::Current();
+        if (arena && arena->Owns(ptr))
+            return;
+        ::operator delete(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const BatchAllocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const BatchAllocator<U>&) const noexcept { return false; }
+};
+
+#endif // BATCH_ARENA_H
@@ -0,0 +1,64 @@
+/**
+ * @file cached_mesh.cpp
+ * @brief Implémentation de la géométrie en cache
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "cached_mesh.h"
+#include "imgui_internal.h"
+
+/**
+ * @brief Constructeur
+ */
+CachedMesh::CachedMesh()
+    : m_recorder(nullptr)
+{
+}
+
+/**
+ * @brief Vide la géométrie et renvoie la draw list où l'enregistrer
+ *
+ * Pas de clip rect ni de texture : seuls les sommets et les indices sont
+ * gardés, la commande de dessin est celle de la draw list de destination.
+ */
+ImDrawList* CachedMesh::Begin(ImDrawListSharedData* sharedData)
+{
+    m_recorder._Data = sharedData;
+    m_recorder._ResetForNewFrame();
+    return &m_recorder;
+}
+
+/**
+ * @brief Ajoute la géométrie enregistrée à une draw list, décalée de offset
+ */
+void CachedMesh::Draw(ImDrawList* drawList, const ImVec2& offset) const
+{
+    const int vtxCount = m_recorder.VtxBuffer.Size;
+    const int idxCount = m_recorder.IdxBuffer.Size;
+    if (vtxCount == 0)
+        return;
+
+    // Lire l'index de base après PrimReserve, qui peut ouvrir une nouvelle commande
+    drawList->PrimReserve(idxCount, vtxCount);
+    const unsigned int base = drawList->_VtxCurrentIdx;
+
+    ImDrawVert* vtx = drawList->_VtxWritePtr;
+    for (int i = 0; i < vtxCount; ++i)
+    {
+        const ImDrawVert& source = m_recorder.VtxBuffer.Data[i];
+        vtx[i].pos = ImVec2(source.pos.x + offset.x, source.pos.y + offset.y);
+        vtx[i].uv = source.uv;
+        vtx[i].col = source.col;
+    }
+
+    ImDrawIdx* idx = drawList->_IdxWritePtr;
+    for (int i = 0; i < idxCount; ++i)
+    {
+        idx[i] = static_cast<ImDrawIdx>(base + m_recorder.IdxBuffer.Data[i]);
+    }
+
+    drawList->_VtxWritePtr += vtxCount;
+    drawList->_IdxWritePtr += idxCount;
+    drawList->_VtxCurrentIdx += static_cast<unsigned int>(vtxCount);
+}
@@ -0,0 +1,58 @@
+/**
+ * @file cached_mesh.h
+ * @brief Géométrie ImGui tessellée une fois puis rejouée à chaque frame
+ *
+ * Les formes sont dessinées avec l'API habituelle de ImDrawList (cercles,
+ * ellipses, triangles...) dans une draw list privée, en coordonnées
+ * locales. Les frames suivantes recopient simplement les sommets obtenus,
+ * décalés à la position voulue : aucun calcul de trigonométrie ni de
+ * frange d'antialiasing.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef CACHED_MESH_H
+#define CACHED_MESH_H
+
+#include "imgui.h"
+
+/**
+ * @class CachedMesh
+ * @brief Sommets et indices enregistrés, rejoués avec une translation
+ *
+ * @code
+ * ImDrawList* recorder = mesh.Begin(drawList->_Data);
+ * recorder->AddCircleFilled(ImVec2(0, 0), 10.0f, color, 24);
+ * ...
+ * mesh.Draw(drawList, ImVec2(x, y));   // à chaque frame
+ * @endcode
+ *
+ * Les sommets gardent l'UV du pixel blanc de l'atlas au moment de
+ * l'enregistrement : il faut réenregistrer si l'atlas est reconstruit.
+ */
+class CachedMesh
+{
+public:
+    CachedMesh();
+
+    /**
+     * @brief Vide la géométrie et renvoie la draw list où l'enregistrer
+     * @param sharedData Données partagées du contexte ImGui (drawList->_Data)
+     */
+    ImDrawList* Begin(ImDrawListSharedData* sharedData);
+
+    /**
+     * @brief Ajoute la géométrie enregistrée à une draw list, décalée de offset
+     */
+    void Draw(ImDrawList* drawList, const ImVec2& offset) const;
+
+    /**
+     * @brief Aucune géométrie enregistrée
+     */
+    bool Empty() const { return m_recorder.VtxBuffer.Size == 0; }
+
+private:
+    ImDrawList m_recorder;          // Garde sa capacité d'un enregistrement à l'autre
+};
+
+#endif // CACHED_MESH_H
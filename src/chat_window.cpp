@@ -8,7 +8,9 @@
  * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie 
  */
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 // Désactivation des macros Windows conflictuelles
 #ifdef SendMessage
@@ -16,6 +18,7 @@
 #endif
 
 #include "chat_window.h"
+#include "frame_profiler.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include <algorithm>
@@ -26,37 +29,12 @@ static const char* CAT_GIFS[] = {
     "https://media.tenor.com/eFPFHSN4rJ8AAAAM/example.gif",  // Placeholder, sera remplacé
 };
 
-// Nombre de particules pour le fond animé
-static const int NUM_PARTICLES = 50;
-
-// Structure pour une particule d'étoile
-struct Particle {
-    float x, y;
-    float speed;
-    float size;
-    float alpha;
-};
+// Temps maximum par frame pour appliquer les mises à jour de la sync (ms)
+static const double SYNC_EVENTS_BUDGET_MS = 2.0;
 
-static Particle g_particles[NUM_PARTICLES];
-static bool g_particlesInitialized = false;
-
-/**
- * @brief Initialise les particules
- */
-static void InitParticles()
-{
-    if (g_particlesInitialized) return;
-    
-    for (int i = 0; i < NUM_PARTICLES; i++)
-    {
-        g_particles[i].x = (float)(rand() % 1280);
-        g_particles[i].y = (float)(rand() % 720);
-        g_particles[i].speed = 0.2f + (float)(rand() % 100) / 200.0f;
-        g_particles[i].size = 1.0f + (float)(rand() % 30) / 10.0f;
-        g_particles[i].alpha = 0.3f + (float)(rand() % 70) / 100.0f;
-    }
-    g_particlesInitialized = true;
-}
+// Champ d'étoiles du fond animé : nombre par défaut et graine
+static const size_t DEFAULT_PARTICLES = 50;
+static const uint32_t PARTICLE_SEED = 0x4B697474;
 
 /**
  * @brief Constructeur - Initialise les buffers et charge les GIFs
@@ -70,7 +48,11 @@ ChatWindow::ChatWindow(MatrixClient* client, TextureManager* texManager)
     , m_scrollToBottom(true)
     , m_showCreateRoom(false)
     , m_showJoinRoom(false)
+    , m_visibleRoomsRevision(0)
+    , m_roomListDirty(true)
+    , m_showProfiler(false)
     , m_animTime(0.0f)
+    , m_particles(PARTICLE_SEED, DEFAULT_PARTICLES)
     , m_gifsLoaded(false)
     , m_catEyeTargetX(0.0f)
     , m_catEyeTargetY(0.0f)
@@ -81,6 +63,7 @@ ChatWindow::ChatWindow(MatrixClient* client, TextureManager* texManager)
     , m_peekAmount(0.0f)
     , m_passwordFieldFocused(false)
     , m_catBodyRotation(0.0f)
+    , m_catMeshBuilds(0)
 {
     // Initialisation des buffers à zéro
     memset(m_username, 0, sizeof(m_username));
@@ -88,16 +71,28 @@ ChatWindow::ChatWindow(MatrixClient* client, TextureManager* texManager)
     memset(m_messageInput, 0, sizeof(m_messageInput));
     memset(m_newRoomName, 0, sizeof(m_newRoomName));
     memset(m_joinRoomId, 0, sizeof(m_joinRoomId));
+    memset(m_roomFilterText, 0, sizeof(m_roomFilterText));
     
     m_startTime = std::chrono::steady_clock::now();
     
-    // Initialisation des particules
-    InitParticles();
-    
     // Chargement des GIFs
     LoadCatGifs();
 }
 
+/**
+ * @brief Destructeur - interrompt une connexion en cours
+ *
+ * Le future d'une tâche std::async attend la fin de la tâche à sa
+ * destruction : l'annulation évite d'attendre la réponse du serveur.
+ */
+ChatWindow::~ChatWindow()
+{
+    if (m_authTask.operation)
+    {
+        m_authTask.operation->Cancel();
+    }
+}
+
 /**
  * @brief Charge les GIFs de chats depuis cataas.com (Cat As A Service)
  */
@@ -109,19 +104,19 @@ void ChatWindow::LoadCatGifs()
     // Format: https://cataas.com/cat/gif?type=sq (carré)
     
     // Chat normal - GIF animé
-    m_texManager->LoadGifFromUrl(
+    m_catLooking = m_texManager->LoadGifFromUrl(
         "https://cataas.com/cat/gif",
         "cat_looking"
     );
     
     // On utilise le même GIF pour tous les états pour l'instant
     // car cataas ne permet pas de choisir le type de chat
-    m_texManager->LoadGifFromUrl(
+    m_catSleeping = m_texManager->LoadGifFromUrl(
         "https://cataas.com/cat/gif",
         "cat_sleeping"
     );
     
-    m_texManager->LoadGifFromUrl(
+    m_catPeeking = m_texManager->LoadGifFromUrl(
         "https://cataas.com/cat/gif",
         "cat_peeking"
     );
@@ -134,6 +129,7 @@ void ChatWindow::LoadCatGifs()
  */
 void ChatWindow::RenderAnimatedBackground()
 {
+    ProfileScope profile(ProfileSection::Background);
     ImDrawList* drawList = ImGui::GetWindowDrawList();
     ImVec2 windowPos = ImGui::GetWindowPos();
     ImVec2 windowSize = ImGui::GetWindowSize();
@@ -162,46 +158,8 @@ void ChatWindow::RenderAnimatedBackground()
     );
     
     // Dessiner les particules/étoiles
-    for (int i = 0; i < NUM_PARTICLES; i++)
-    {
-        Particle& p = g_particles[i];
-        
-        // Animation douce
-        float offsetY = sinf(m_animTime * p.speed + i) * 20.0f;
-        float offsetX = cosf(m_animTime * p.speed * 0.5f + i) * 10.0f;
-        
-        float px = windowPos.x + p.x + offsetX;
-        float py = windowPos.y + p.y + offsetY;
-        
-        // Wrap around
-        if (px < windowPos.x) px += windowSize.x;
-        if (px > windowPos.x + windowSize.x) px -= windowSize.x;
-        if (py < windowPos.y) py += windowSize.y;
-        if (py > windowPos.y + windowSize.y) py -= windowSize.y;
-        
-        // Scintillement
-        float twinkle = 0.5f + 0.5f * sinf(m_animTime * 3.0f + i * 0.7f);
-        int alpha = (int)(p.alpha * twinkle * 255);
-        
-        // Couleur dorée/orange pour les étoiles
-        ImU32 starColor = IM_COL32(255, 180 + (int)(twinkle * 75), 100, alpha);
-        
-        drawList->AddCircleFilled(
-            ImVec2(px, py),
-            p.size,
-            starColor
-        );
-        
-        // Halo autour des grosses étoiles
-        if (p.size > 2.5f)
-        {
-            drawList->AddCircleFilled(
-                ImVec2(px, py),
-                p.size * 2.0f,
-                IM_COL32(255, 200, 150, alpha / 4)
-            );
-        }
-    }
+    m_particles.Render(drawList, windowPos.x, windowPos.y, windowSize.x, windowSize.y,
+                       m_animTime, ImGui::GetIO().DeltaTime);
     
     // Emojis de pattes de chat flottants
     const char* pawEmojis[] = { "🐾", "✨", "💫", "⭐" };
@@ -221,17 +179,19 @@ void ChatWindow::RenderAnimatedBackground()
 /**
  * @brief Affiche un GIF animé centré
  */
-void ChatWindow::RenderGif(const std::string& name, float maxWidth, float maxHeight)
+void ChatWindow::RenderGif(ImageHandle gif, float maxWidth, float maxHeight)
 {
     if (!m_texManager) return;
     
     m_texManager->Update();
     
-    ID3D11ShaderResourceView* tex = m_texManager->GetCurrentFrame(name);
-    if (tex)
+    // Texture rangée à la taille affichée, pas à celle du fichier
+    m_texManager->SetTargetSize(gif, static_cast<int>(maxWidth), static_cast<int>(maxHeight));
+    TextureRegion frame = m_texManager->GetCurrentFrame(gif);
+    if (frame.texture)
     {
         int gifW, gifH;
-        if (m_texManager->GetGifSize(name, gifW, gifH))
+        if (m_texManager->GetGifSize(gif, gifW, gifH))
         {
             // Calculer la taille avec aspect ratio
             float scale = std::min(maxWidth / gifW, maxHeight / gifH);
@@ -244,10 +204,11 @@ void ChatWindow::RenderGif(const std::string& name, float maxWidth, float maxHei
             ImGui::SetCursorPosX(ImGui::GetCursorPosX() + offsetX);
             
             // Afficher l'image avec bordure arrondie
-            ImGui::Image((ImTextureID)tex, ImVec2(displayW, displayH));
+            ImGui::Image((ImTextureID)frame.texture, ImVec2(displayW, displayH),
+                         ImVec2(frame.u0, frame.v0), ImVec2(frame.u1, frame.v1));
         }
     }
-    else if (!m_texManager->IsLoaded(name))
+    else if (!m_texManager->IsLoaded(gif))
     {
         // Afficher un placeholder pendant le chargement
         float pulse = 0.5f + 0.5f * sinf(m_animTime * 3.0f);
@@ -269,11 +230,91 @@ void ChatWindow::RenderGif(const std::string& name, float maxWidth, float maxHei
     }
 }
 
+/**
+ * @brief Applique le thème visuel - moderne violet/rose
+ */
+void ChatWindow::ApplyStyle()
+{
+    ImGuiStyle& style = ImGui::GetStyle();
+    style.WindowRounding = 15.0f;
+    style.FrameRounding = 10.0f;
+    style.GrabRounding = 8.0f;
+    style.ScrollbarRounding = 10.0f;
+    style.TabRounding = 8.0f;
+    style.ChildRounding = 12.0f;
+    style.PopupRounding = 12.0f;
+    style.WindowPadding = ImVec2(15, 15);
+    style.FramePadding = ImVec2(12, 6);
+    style.ItemSpacing = ImVec2(10, 8);
+    style.ScrollbarSize = 12.0f;
+    style.GrabMinSize = 10.0f;
+
+    // Couleurs modernes - palette violet/rose/doré
+    ImVec4* colors = style.Colors;
+    colors[ImGuiCol_WindowBg]           = ImVec4(0.08f, 0.06f, 0.12f, 1.00f);   // Violet très foncé
+    colors[ImGuiCol_ChildBg]            = ImVec4(0.10f, 0.08f, 0.15f, 0.90f);
+    colors[ImGuiCol_PopupBg]            = ImVec4(0.12f, 0.10f, 0.18f, 0.98f);
+    colors[ImGuiCol_Border]             = ImVec4(0.50f, 0.35f, 0.55f, 0.40f);
+    colors[ImGuiCol_BorderShadow]       = ImVec4(0.00f, 0.00f, 0.00f, 0.00f);
+    colors[ImGuiCol_FrameBg]            = ImVec4(0.15f, 0.12f, 0.22f, 1.00f);
+    colors[ImGuiCol_FrameBgHovered]     = ImVec4(0.22f, 0.18f, 0.30f, 1.00f);
+    colors[ImGuiCol_FrameBgActive]      = ImVec4(0.28f, 0.22f, 0.38f, 1.00f);
+    colors[ImGuiCol_TitleBg]            = ImVec4(0.12f, 0.10f, 0.18f, 1.00f);
+    colors[ImGuiCol_TitleBgActive]      = ImVec4(0.18f, 0.14f, 0.25f, 1.00f);
+    colors[ImGuiCol_MenuBarBg]          = ImVec4(0.12f, 0.10f, 0.18f, 1.00f);
+    colors[ImGuiCol_ScrollbarBg]        = ImVec4(0.08f, 0.06f, 0.12f, 0.60f);
+    colors[ImGuiCol_ScrollbarGrab]      = ImVec4(0.40f, 0.30f, 0.50f, 1.00f);
+    colors[ImGuiCol_ScrollbarGrabHovered] = ImVec4(0.50f, 0.40f, 0.60f, 1.00f);
+    colors[ImGuiCol_ScrollbarGrabActive]  = ImVec4(0.60f, 0.50f, 0.70f, 1.00f);
+    colors[ImGuiCol_CheckMark]          = ImVec4(1.00f, 0.70f, 0.40f, 1.00f);   // Doré
+    colors[ImGuiCol_SliderGrab]         = ImVec4(0.90f, 0.60f, 0.35f, 1.00f);
+    colors[ImGuiCol_SliderGrabActive]   = ImVec4(1.00f, 0.70f, 0.45f, 1.00f);
+    colors[ImGuiCol_Button]             = ImVec4(0.45f, 0.30f, 0.50f, 1.00f);
+    colors[ImGuiCol_ButtonHovered]      = ImVec4(0.55f, 0.40f, 0.60f, 1.00f);
+    colors[ImGuiCol_ButtonActive]       = ImVec4(0.65f, 0.50f, 0.70f, 1.00f);
+    colors[ImGuiCol_Header]             = ImVec4(0.35f, 0.25f, 0.45f, 1.00f);
+    colors[ImGuiCol_HeaderHovered]      = ImVec4(0.45f, 0.35f, 0.55f, 1.00f);
+    colors[ImGuiCol_HeaderActive]       = ImVec4(0.50f, 0.40f, 0.60f, 1.00f);
+    colors[ImGuiCol_Tab]                = ImVec4(0.25f, 0.18f, 0.32f, 1.00f);
+    colors[ImGuiCol_TabHovered]         = ImVec4(0.45f, 0.35f, 0.55f, 1.00f);
+    colors[ImGuiCol_TabActive]          = ImVec4(0.38f, 0.28f, 0.48f, 1.00f);
+    colors[ImGuiCol_Text]               = ImVec4(0.95f, 0.92f, 0.98f, 1.00f);   // Blanc légèrement rose
+    colors[ImGuiCol_TextDisabled]       = ImVec4(0.55f, 0.50f, 0.60f, 1.00f);
+    colors[ImGuiCol_PlotLines]          = ImVec4(1.00f, 0.70f, 0.40f, 1.00f);
+    colors[ImGuiCol_PlotLinesHovered]   = ImVec4(1.00f, 0.80f, 0.50f, 1.00f);
+    colors[ImGuiCol_TextSelectedBg]     = ImVec4(0.50f, 0.35f, 0.60f, 0.50f);
+    colors[ImGuiCol_ModalWindowDimBg]   = ImVec4(0.05f, 0.03f, 0.08f, 0.70f);
+}
+
+/**
+ * @brief Libère les textes temporaires de la frame précédente
+ * 
+ * Le cache de textures en profite pour appliquer ses budgets.
+ */
+void ChatWindow::BeginFrame()
+{
+    m_frameArena.Reset();
+    FrameProfiler::Get().NextFrame();
+    if (m_texManager)
+        m_texManager->BeginFrame();
+}
+
 /**
  * @brief Point d'entrée principal du rendu
  */
 void ChatWindow::Render()
 {
+    ProfileScope profile(ProfileSection::Frame);
+
+    // Profileur affiché/masqué par F3
+    if (ImGui::IsKeyPressed(ImGuiKey_F3, false))
+    {
+        m_showProfiler = !m_showProfiler;
+    }
+
+    // Application des mises à jour reçues par la synchronisation
+    m_client->PumpEvents(SYNC_EVENTS_BUDGET_MS);
+
     // Configuration de la fenêtre principale
     ImGuiViewport* viewport = ImGui::GetMainViewport();
     ImGui::SetNextWindowPos(viewport->Pos);
@@ -309,6 +350,9 @@ void ChatWindow::Render()
     
     ImGui::BeginChild("MainContent", contentSize, false);
     
+    // Résultat d'une connexion lancée depuis l'écran de login
+    PollAuthTask();
+
     if (m_client->IsLoggedIn())
     {
         RenderChatInterface();
@@ -320,6 +364,11 @@ void ChatWindow::Render()
     
     ImGui::EndChild();
     ImGui::End();
+
+    if (m_showProfiler)
+    {
+        RenderProfilerOverlay();
+    }
 }
 
 /**
@@ -327,6 +376,9 @@ void ChatWindow::Render()
  */
 void ChatWindow::RenderLoginScreen()
 {
+    // Connexion au serveur ouverte pendant la saisie des identifiants
+    m_client->WarmUpConnection();
+
     ImVec2 windowSize = ImGui::GetWindowSize();
     float formWidth = 450.0f;
     float formHeight = 550.0f;  // Un peu plus haut pour le chat
@@ -510,53 +562,77 @@ void ChatWindow::RenderLoginScreen()
     ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 15.0f);
     ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(20, 12));
     
-    // Bouton Connexion (orange/doré)
-    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.8f, 0.5f, 0.2f, 1.0f));
-    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.9f, 0.6f, 0.3f, 1.0f));
-    ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(1.0f, 0.7f, 0.4f, 1.0f));
-    
-    if (ImGui::Button("🐾 Connexion", ImVec2(buttonWidth, 0)))
+    if (m_authTask.result.valid())
     {
-        m_loginError = false;
-        m_successMessage.clear();
-        if (m_client->Login(m_username, m_password))
+        // Opération en cours : progression et annulation, l'UI reste fluide
+        const char* stageText = "⏳ Connexion au serveur...";
+        switch (m_authTask.operation->GetStage())
         {
-            memset(m_password, 0, sizeof(m_password));
+        case AuthStage::Connecting:
+            stageText = "⏳ Connexion au serveur...";
+            break;
+        case AuthStage::Authenticating:
+            stageText = m_isRegistering ? "⏳ Création du compte..." : "⏳ Vérification des identifiants...";
+            break;
+        case AuthStage::InteractiveAuth:
+            stageText = "⏳ Finalisation de l'inscription...";
+            break;
+        case AuthStage::StartingSync:
+        case AuthStage::Done:
+            stageText = "⏳ Chargement des salons...";
+            break;
+        case AuthStage::Failed:
+        case AuthStage::Cancelled:
+            stageText = "⏳ ...";
+            break;
         }
-        else
+        ImGui::Text("%s", stageText);
+
+        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.5f, 0.3f, 0.3f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.6f, 0.35f, 0.35f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.7f, 0.4f, 0.4f, 1.0f));
+        if (ImGui::Button("❌ Annuler", ImVec2(formWidth - 60, 0)))
         {
-            m_loginError = true;
-            m_errorMessage = m_client->GetLastError();
+            m_authTask.operation->Cancel();
         }
+        ImGui::PopStyleColor(3);
+        ImGui::PopStyleVar(2);
     }
+    else
+    {
+        // Bouton Connexion (orange/doré)
+        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.8f, 0.5f, 0.2f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.9f, 0.6f, 0.3f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(1.0f, 0.7f, 0.4f, 1.0f));
     
-    ImGui::PopStyleColor(3);
+        if (ImGui::Button("🐾 Connexion", ImVec2(buttonWidth, 0)))
+        {
+            m_loginError = false;
+            m_successMessage.clear();
+            m_isRegistering = false;
+            m_authTask = m_client->LoginAsync(m_username, m_password);
+        }
     
-    ImGui::SameLine();
+        ImGui::PopStyleColor(3);
     
-    // Bouton Inscription (vert/émeraude)
-    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.5f, 1.0f));
-    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.7f, 0.6f, 1.0f));
-    ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.4f, 0.8f, 0.7f, 1.0f));
+        ImGui::SameLine();
     
-    if (ImGui::Button("✨ S'inscrire", ImVec2(buttonWidth, 0)))
-    {
-        m_loginError = false;
-        m_successMessage.clear();
-        if (m_client->Register(m_username, m_password))
-        {
-            memset(m_password, 0, sizeof(m_password));
-            m_successMessage = "Bienvenue petit chaton ! 🎉";
-        }
-        else
+        // Bouton Inscription (vert/émeraude)
+        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.5f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.7f, 0.6f, 1.0f));
+        ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.4f, 0.8f, 0.7f, 1.0f));
+    
+        if (ImGui::Button("✨ S'inscrire", ImVec2(buttonWidth, 0)))
         {
-            m_loginError = true;
-            m_errorMessage = m_client->GetLastError();
+            m_loginError = false;
+            m_successMessage.clear();
+            m_isRegistering = true;
+            m_authTask = m_client->RegisterAsync(m_username, m_password);
         }
-    }
     
-    ImGui::PopStyleColor(3);
-    ImGui::PopStyleVar(2);
+        ImGui::PopStyleColor(3);
+        ImGui::PopStyleVar(2);
+    }
 
     ImGui::Spacing();
     
@@ -571,6 +647,35 @@ void ChatWindow::RenderLoginScreen()
     ImGui::PopStyleColor();
 }
 
+/**
+ * @brief Récupère le résultat de la connexion/inscription quand il est prêt
+ */
+void ChatWindow::PollAuthTask()
+{
+    if (!m_authTask.result.valid())
+        return;
+    if (m_authTask.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    bool success = m_authTask.result.get();
+    AuthStage stage = m_authTask.operation->GetStage();
+
+    if (success)
+    {
+        m_client->FinishAuth(*m_authTask.operation);
+        memset(m_password, 0, sizeof(m_password));
+        if (m_isRegistering)
+            m_successMessage = "Bienvenue petit chaton ! 🎉";
+    }
+    else if (stage != AuthStage::Cancelled)
+    {
+        m_loginError = true;
+        m_errorMessage = m_authTask.operation->GetError();
+    }
+
+    m_authTask = AuthTask();
+}
+
 /**
  * @brief Affiche l'interface principale de chat
  */
@@ -639,17 +744,18 @@ void ChatWindow::RenderTitleBar()
     ImGui::SameLine();
 
     // Statut avec indicateur
-    bool connected = !m_client->GetConnectionStatus().empty();
+    const char* status = m_client->GetConnectionStatus();
+    bool connected = status[0] != '\0';
     ImVec4 statusColor = connected ? ImVec4(0.3f, 0.9f, 0.5f, 1.0f) : ImVec4(0.9f, 0.4f, 0.3f, 1.0f);
-    ImGui::TextColored(statusColor, "● %s", m_client->GetConnectionStatus().c_str());
+    ImGui::TextColored(statusColor, "● %s", status);
 
     // Utilisateur (aligné à droite)
-    std::string userInfo = "👤 " + m_client->GetUserId();
-    float textWidth = ImGui::CalcTextSize(userInfo.c_str()).x;
+    const char* userInfo = m_frameArena.Format("👤 %s", m_client->GetUserId().c_str());
+    float textWidth = ImGui::CalcTextSize(userInfo).x;
     float buttonWidth = 130.0f;
     
     ImGui::SameLine(ImGui::GetWindowWidth() - textWidth - buttonWidth - 50);
-    ImGui::TextColored(ImVec4(0.8f, 0.75f, 0.9f, 1.0f), "%s", userInfo.c_str());
+    ImGui::TextColored(ImVec4(0.8f, 0.75f, 0.9f, 1.0f), "%s", userInfo);
     
     ImGui::SameLine();
     
@@ -679,6 +785,8 @@ void ChatWindow::RenderTitleBar()
  */
 void ChatWindow::RenderSidebar()
 {
+    ProfileScope profile(ProfileSection::Sidebar);
+
     // En-tête
     ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.5f, 1.0f), "🏠 Vos Salons");
     ImGui::Separator();
@@ -735,46 +843,81 @@ void ChatWindow::RenderSidebar()
     }
     else
     {
-        ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 10.0f);
-        
-        for (const auto& room : rooms)
+        // Filtre instantané sur les noms et alias
+        ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 8.0f);
+        ImGui::SetNextItemWidth(-1);
+        if (ImGui::InputTextWithHint("##roomfilter", "🔍 Filtrer les salons...",
+                                     m_roomFilterText, sizeof(m_roomFilterText)))
         {
-            bool isSelected = (selectedRoom && selectedRoom->id == room.id);
+            m_roomFilter.SetQuery(m_roomFilterText);
+            m_roomListDirty = true;
+        }
+        ImGui::PopStyleVar();
+        ImGui::Spacing();
 
-            if (isSelected)
-            {
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.5f, 0.35f, 0.55f, 1.0f));
-                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.55f, 0.4f, 0.6f, 1.0f));
-            }
-            else
-            {
-                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.18f, 0.25f, 1.0f));
-                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.25f, 0.35f, 1.0f));
-            }
+        UpdateRoomList();
 
-            std::string displayName = "💬 " + room.name;
-            if (room.unreadCount > 0)
-            {
-                displayName += " 🔴 " + std::to_string(room.unreadCount);
-            }
+        ImGui::BeginChild("RoomList", ImVec2(0, -70), false);
+        ImGui::PushStyleVar(ImGuiStyleVar_FrameRounding, 10.0f);
 
-            if (ImGui::Button(displayName.c_str(), ImVec2(-1, 35)))
+        if (m_visibleRooms.empty())
+        {
+            ImGui::TextColored(ImVec4(0.6f, 0.55f, 0.7f, 1.0f), "Aucun salon ne correspond");
+        }
+
+        // Seules les lignes visibles sont dessinées, quel que soit le nombre de salons
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(m_visibleRooms.size()), 35.0f + ImGui::GetStyle().ItemSpacing.y);
+        while (clipper.Step())
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
             {
-                m_client->SelectRoom(room.id);
-                m_scrollToBottom = true;
+                const uint32_t index = m_visibleRooms[row];
+                const Room& room = rooms[index];
+                bool isSelected = (selectedRoom == &room);
+
+                if (isSelected)
+                {
+                    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.5f, 0.35f, 0.55f, 1.0f));
+                    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.55f, 0.4f, 0.6f, 1.0f));
+                }
+                else
+                {
+                    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.18f, 0.25f, 1.0f));
+                    ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.25f, 0.35f, 1.0f));
+                }
+
+                // Deux salons peuvent porter le même nom : l'ID ImGui vient de l'index
+                ImGui::PushID(static_cast<int>(index));
+                if (ImGui::Button(m_roomLabels[index].c_str(), ImVec2(-1, 35)))
+                {
+                    m_client->SelectRoom(room.id);
+                    m_scrollToBottom = true;
+                }
+                ImGui::PopID();
+
+                ImGui::PopStyleColor(2);
             }
-
-            ImGui::PopStyleColor(2);
         }
-        
+        clipper.End();
+
         ImGui::PopStyleVar();
+        ImGui::EndChild();
     }
 
     // Footer
     ImGui::SetCursorPosY(ImGui::GetWindowHeight() - 60);
     ImGui::Separator();
     ImGui::Spacing();
-    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.6f, 1.0f), "📊 %d salon(s)", static_cast<int>(rooms.size()));
+    if (m_roomFilter.IsActive())
+    {
+        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.6f, 1.0f), "📊 %d / %d salon(s)",
+                           static_cast<int>(m_visibleRooms.size()), static_cast<int>(rooms.size()));
+    }
+    else
+    {
+        ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.6f, 1.0f), "📊 %d salon(s)", static_cast<int>(rooms.size()));
+    }
     
     // Popups
     if (m_showCreateRoom)
@@ -841,11 +984,66 @@ void ChatWindow::RenderSidebar()
     }
 }
 
+/**
+ * @brief Met à jour les libellés et la liste des salons affichés
+ *
+ * Les salons changés sont repérés par leur révision : seuls leurs libellés
+ * et leurs entrées dans l'index de recherche sont reconstruits.
+ */
+void ChatWindow::UpdateRoomList()
+{
+    const uint64_t revision = m_client->GetRoomsRevision();
+    if (!m_roomListDirty && revision == m_visibleRoomsRevision)
+        return;
+
+    const auto& rooms = m_client->GetRooms();
+    if (revision != m_visibleRoomsRevision)
+    {
+        m_roomLabels.resize(rooms.size());
+        m_roomLabelRevisions.resize(rooms.size(), 0);
+
+        for (size_t i = 0; i < rooms.size(); ++i)
+        {
+            const Room& room = rooms[i];
+            if (m_roomLabelRevisions[i] == room.revision)
+                continue;
+
+            std::string& label = m_roomLabels[i];
+            label = room.isFavourite ? "⭐ " : "💬 ";
+            label += room.name;
+            if (room.unreadCount > 0)
+            {
+                label += " 🔴 ";
+                label += std::to_string(room.unreadCount);
+            }
+            if (room.highlightCount > 0)
+            {
+                label += " 📣 ";
+                label += std::to_string(room.highlightCount);
+            }
+
+            m_roomFilter.UpdateRoom(static_cast<uint32_t>(i), room.name, room.alias);
+            m_roomLabelRevisions[i] = room.revision;
+        }
+    }
+
+    m_visibleRooms.clear();
+    for (uint32_t index : m_client->GetRoomOrder())
+    {
+        if (m_roomFilter.Matches(index))
+            m_visibleRooms.push_back(index);
+    }
+
+    m_visibleRoomsRevision = revision;
+    m_roomListDirty = false;
+}
+
 /**
  * @brief Zone des messages
  */
 void ChatWindow::RenderMessageArea()
 {
+    ProfileScope profile(ProfileSection::MessageArea);
     const Room* room = m_client->GetSelectedRoom();
 
     if (!room)
@@ -887,9 +1085,11 @@ void ChatWindow::RenderMessageArea()
     // Affichage des messages
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8, 12));
     
-    for (const auto& message : room->messages)
+    const ImGuiID seed = ImGui::GetID("messages");
+    const TimelineStore& timeline = room->timeline;
+    for (size_t i = 0; i < timeline.Size(); ++i)
     {
-        RenderMessage(message);
+        RenderMessage(timeline.Get(i), seed);
     }
     
     ImGui::PopStyleVar();
@@ -903,10 +1103,17 @@ void ChatWindow::RenderMessageArea()
 
 /**
  * @brief Affiche un message avec style moderne
+ *
+ * La bulle est dessinée directement dans la draw list de la fenêtre
+ * (rectangle arrondi + textes) au lieu d'une fenêtre enfant par message :
+ * pas de fenêtre, de pile de styles ni de commande de dessin en plus par
+ * bulle. Une bulle hors de la zone visible n'est que mesurée.
  */
-void ChatWindow::RenderMessage(const Message& message)
+void ChatWindow::RenderMessage(const MessageView& message, uint32_t seed)
 {
-    ImGui::PushID(message.id.c_str());
+    const ImVec2 padding(12.0f, 8.0f);
+    const float rounding = 12.0f;
+    const ImGuiStyle& style = ImGui::GetStyle();
 
     // Bulle de message
     bool isOwn = message.isOwn;
@@ -920,42 +1127,61 @@ void ChatWindow::RenderMessage(const Message& message)
         : ImVec4(1.0f, 0.75f, 0.5f, 1.0f);
 
     // Indentation pour nos messages
-    if (isOwn)
-    {
-        float indent = ImGui::GetContentRegionAvail().x * 0.2f;
-        ImGui::Indent(indent);
-    }
-
-    ImGui::PushStyleColor(ImGuiCol_ChildBg, bubbleColor);
-    ImGui::PushStyleVar(ImGuiStyleVar_ChildRounding, 12.0f);
-    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(12, 8));
+    float available = ImGui::GetContentRegionAvail().x;
+    float indent = isOwn ? available * 0.2f : 0.0f;
     
     // Calculer la taille du message
-    float maxWidth = ImGui::GetContentRegionAvail().x * 0.75f;
-    ImVec2 textSize = ImGui::CalcTextSize(message.content.c_str(), nullptr, false, maxWidth - 24);
+    float maxWidth = (available - indent) * 0.75f;
+    float wrapWidth = maxWidth - padding.x * 2.0f;
+    const char* contentBegin = message.content.data();
+    const char* contentEnd = contentBegin + message.content.size();
+    ImVec2 textSize = ImGui::CalcTextSize(contentBegin, contentEnd, false, wrapWidth);
     float bubbleHeight = textSize.y + 35;
+
+    ImVec2 cursor = ImGui::GetCursorScreenPos();
+    ImRect bubble(ImVec2(cursor.x + indent, cursor.y),
+                  ImVec2(cursor.x + indent + maxWidth, cursor.y + bubbleHeight));
+    ImGui::ItemSize(ImVec2(indent + maxWidth, bubbleHeight));
+
+    // ID précalculé : pas de hachage de l'identifiant texte à chaque frame
+    ImGuiID id = ImHashData(&message.idHash, sizeof(message.idHash), seed);
+    if (!ImGui::ItemAdd(bubble, id))
+        return;
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->AddRectFilled(bubble.Min, bubble.Max, ImGui::GetColorU32(bubbleColor), rounding);
+    if (style.ChildBorderSize > 0.0f)
+    {
+        drawList->AddRect(bubble.Min, bubble.Max, ImGui::GetColorU32(ImGuiCol_Border),
+                          rounding, 0, style.ChildBorderSize);
+    }
     
-    ImGui::BeginChild(("msg_" + message.id).c_str(), ImVec2(maxWidth, bubbleHeight), true);
+    // Formatage de l'horodatage (heure locale)
+    char timeBuffer[16] = "[]";
+    if (message.timestamp > 0)
+    {
+        time_t time = static_cast<time_t>(message.timestamp / 1000);
+        struct tm* tm = localtime(&time);
+        if (tm)
+            strftime(timeBuffer, sizeof(timeBuffer), "[%H:%M]", tm);
+    }
     
     // Nom et timestamp
-    ImGui::TextColored(nameColor, "%s", message.senderName.c_str());
-    ImGui::SameLine();
-    ImGui::TextColored(ImVec4(0.5f, 0.5f, 0.6f, 1.0f), "[%s]", message.timestamp.c_str());
+    ImVec2 textPos(bubble.Min.x + padding.x, bubble.Min.y + padding.y);
+    const char* nameBegin = message.senderName.data();
+    const char* nameEnd = nameBegin + message.senderName.size();
+    ImFont* font = ImGui::GetFont();
+    float fontSize = ImGui::GetFontSize();
+    ImVec4 clip(bubble.Min.x, bubble.Min.y, bubble.Max.x - padding.x, bubble.Max.y);   // Comme la fenêtre enfant
+    drawList->AddText(font, fontSize, textPos, ImGui::GetColorU32(nameColor), nameBegin, nameEnd, 0.0f, &clip);
+    float timeX = textPos.x + ImGui::CalcTextSize(nameBegin, nameEnd).x + style.ItemSpacing.x;
+    drawList->AddText(font, fontSize, ImVec2(timeX, textPos.y), ImGui::GetColorU32(ImVec4(0.5f, 0.5f, 0.6f, 1.0f)),
+                      timeBuffer, nullptr, 0.0f, &clip);
     
     // Contenu
-    ImGui::TextWrapped("%s", message.content.c_str());
-    
-    ImGui::EndChild();
-    
-    ImGui::PopStyleVar(2);
-    ImGui::PopStyleColor();
-
-    if (isOwn)
-    {
-        ImGui::Unindent(ImGui::GetContentRegionAvail().x * 0.2f);
-    }
-
-    ImGui::PopID();
+    textPos.y += ImGui::GetTextLineHeight() + style.ItemSpacing.y;
+    drawList->AddText(font, fontSize, textPos, ImGui::GetColorU32(ImGuiCol_Text),
+                      contentBegin, contentEnd, wrapWidth);
 }
 
 /**
@@ -1043,80 +1269,101 @@ void ChatWindow::UpdateCatAnimation()
     m_tailCoverAmount += (targetTailCover - m_tailCoverAmount) * 0.1f;
 }
 
+// Couleurs du chat interactif
+static const ImU32 CAT_FUR = IM_COL32(255, 180, 120, 255);          // Orange clair
+static const ImU32 CAT_FUR_DARK = IM_COL32(220, 140, 80, 255);      // Orange foncé (rayures)
+static const ImU32 CAT_FUR_LIGHT = IM_COL32(255, 230, 200, 255);    // Crème (ventre)
+static const ImU32 CAT_EYE_WHITE = IM_COL32(255, 255, 255, 255);
+static const ImU32 CAT_EYE = IM_COL32(80, 200, 120, 255);           // Vert émeraude
+static const ImU32 CAT_PUPIL = IM_COL32(20, 20, 20, 255);
+static const ImU32 CAT_NOSE = IM_COL32(255, 140, 140, 255);
+static const ImU32 CAT_INNER_EAR = IM_COL32(255, 190, 190, 255);
+static const ImU32 CAT_WHISKER = IM_COL32(80, 80, 80, 200);
+static const ImU32 CAT_LINE = IM_COL32(60, 60, 60, 255);            // Yeux fermés, bouche
+
+// Pas de quantification de la pose : en dessous, la géométrie en cache est réutilisée
+static const float CAT_POSE_STEPS = 256.0f;
+
 /**
- * @brief Dessine le chat interactif avec 3 poses : assis, couché, peek
+ * @struct CatLayout
+ * @brief Dimensions du chat pour une pose, relatives à son centre
  */
-void ChatWindow::RenderInteractiveCat(float centerX, float centerY, float size)
+struct CatLayout
 {
-    ImDrawList* drawList = ImGui::GetWindowDrawList();
-    ImVec2 windowPos = ImGui::GetWindowPos();
-    
-    // Position absolue du chat
-    float catX = windowPos.x + centerX;
-    float catY = windowPos.y + centerY;
-    
-    // Récupérer la position de la souris
-    ImVec2 mousePos = ImGui::GetMousePos();
-    
-    // Calculer la direction vers la souris (seulement si pas couché)
-    float dx = mousePos.x - catX;
-    float dy = mousePos.y - catY;
-    float distance = sqrtf(dx * dx + dy * dy);
-    
-    // Les yeux suivent le curseur seulement si le chat n'est pas couché
-    float eyeTrackingStrength = 1.0f - m_layDownAmount * 0.8f + m_peekAmount * 0.5f;
-    float maxEyeMove = size * 0.08f;
-    if (distance > 0)
-    {
-        m_catEyeTargetX = (dx / distance) * std::min(distance * 0.02f, maxEyeMove) * eyeTrackingStrength;
-        m_catEyeTargetY = (dy / distance) * std::min(distance * 0.02f, maxEyeMove) * eyeTrackingStrength;
-    }
-    
-    // Rotation du corps vers la souris (moins quand couché)
-    float targetRotation = atan2f(dy, dx) * 0.1f * (1.0f - m_layDownAmount * 0.7f);
-    m_catBodyRotation += (targetRotation - m_catBodyRotation) * 0.05f;
-    
-    // Mise à jour de l'animation
-    UpdateCatAnimation();
-    
-    // Raccourcis pour les états
-    float lay = m_layDownAmount;   // 0 = assis, 1 = couché
-    float peek = m_peekAmount;     // 0 = yeux cachés, 1 = peek
-    
-    // === COULEURS ===
-    ImU32 furColor = IM_COL32(255, 180, 120, 255);       // Orange clair
-    ImU32 furDark = IM_COL32(220, 140, 80, 255);         // Orange foncé (rayures)
-    ImU32 furLight = IM_COL32(255, 230, 200, 255);       // Crème (ventre)
-    ImU32 eyeWhite = IM_COL32(255, 255, 255, 255);
-    ImU32 eyeColor = IM_COL32(80, 200, 120, 255);        // Vert émeraude
-    ImU32 pupilColor = IM_COL32(20, 20, 20, 255);
-    ImU32 noseColor = IM_COL32(255, 140, 140, 255);
-    ImU32 innerEarColor = IM_COL32(255, 190, 190, 255);
-    ImU32 whiskerColor = IM_COL32(80, 80, 80, 200);
-    ImU32 closedEyeColor = IM_COL32(60, 60, 60, 255);
-    
-    float s = size;
-    
-    // === CORPS - Change de forme selon la pose ===
-    float bodyOffsetX = m_catBodyRotation * s * 0.2f * (1.0f - lay);
-    
+    float bodyCenterY;
+    float bodyRadiusX;
+    float bodyRadiusY;
+    float headY;
+    float headRadius;
+    float eyeY;
+    float eyeRadius;
+    float eyeSpacing;
+    float eyeOpen;          // 0 = fermés, 1 = grands ouverts
+    float tailTargetY;      // Hauteur des yeux visée par la queue
+};
+
+/**
+ * @brief Calcule les dimensions du chat
+ * @param s Taille du chat
+ * @param lay 0 = assis, 1 = couché
+ * @param peek 0 = yeux cachés, 1 = peek
+ */
+static CatLayout ComputeCatLayout(float s, float lay, float peek)
+{
+    CatLayout layout;
+
     // Assis : corps plus vertical, Couché : corps plus horizontal et bas
-    float bodyCenterY = catY + s * (0.25f + lay * 0.2f);
-    float bodyRadiusX = s * (0.45f + lay * 0.25f);  // Plus large couché
-    float bodyRadiusY = s * (0.35f - lay * 0.1f);   // Plus plat couché
+    layout.bodyCenterY = s * (0.25f + lay * 0.2f);
+    layout.bodyRadiusX = s * (0.45f + lay * 0.25f);  // Plus large couché
+    layout.bodyRadiusY = s * (0.35f - lay * 0.1f);   // Plus plat couché
+
+    // La queue vise les yeux d'une tête un peu plus haute que celle dessinée
+    float tailHeadY = -s * (0.2f - lay * 0.1f);
+    float tailHeadRadius = s * (0.38f - lay * 0.05f);
+    layout.tailTargetY = tailHeadY - tailHeadRadius * (0.05f + lay * 0.1f);
+
+    // Tête plus basse quand couché
+    layout.headY = -s * (0.2f - lay * 0.12f) + lay * s * 0.08f;
+    layout.headRadius = s * (0.38f - lay * 0.03f);
+
+    layout.eyeSpacing = layout.headRadius * 0.4f;
+    layout.eyeY = layout.headY - layout.headRadius * 0.05f;
+    layout.eyeRadius = layout.headRadius * 0.2f;
+
+    // Quand couché sans peek : yeux fermés ; quand peek : yeux mi-ouverts qui regardent
+    layout.eyeOpen = std::min(1.0f, (1.0f - lay) + peek * 0.7f);
+    return layout;
+}
+
+/**
+ * @brief Tessellise les parties fixes du chat pour une pose
+ *
+ * Tout est dessiné autour de l'origine (centre du chat) ; le rendu
+ * translate ensuite chaque morceau. Le corps est séparé pour suivre la
+ * rotation vers le curseur, les iris pour suivre le regard.
+ */
+void ChatWindow::BuildCatMeshes(ImDrawListSharedData* sharedData, float s, float lay, float peek, float tailCover)
+{
+    const CatLayout layout = ComputeCatLayout(s, lay, peek);
+    const float bodyCenterY = layout.bodyCenterY;
+    const float bodyRadiusX = layout.bodyRadiusX;
+    const float bodyRadiusY = layout.bodyRadiusY;
+    const float headY = layout.headY;
+    const float headRadius = layout.headRadius;
+    const float eyeY = layout.eyeY;
+    const float eyeRadius = layout.eyeRadius;
+
+    // === CORPS - Change de forme selon la pose ===
+    ImDrawList* drawList = m_catBodyMesh.Begin(sharedData);
     
     // Corps principal
-    drawList->AddEllipseFilled(
-        ImVec2(catX + bodyOffsetX, bodyCenterY),
-        bodyRadiusX, bodyRadiusY,
-        furColor, 0.0f, 32
-    );
+    drawList->AddEllipseFilled(ImVec2(0.0f, bodyCenterY), bodyRadiusX, bodyRadiusY, CAT_FUR, 0.0f, 32);
     
     // Ventre (visible quand assis)
     float bellyAlpha = 1.0f - lay * 0.5f;
     ImU32 bellyColor = IM_COL32(255, 230, 200, (int)(255 * bellyAlpha));
     drawList->AddEllipseFilled(
-        ImVec2(catX + bodyOffsetX, bodyCenterY + bodyRadiusY * 0.15f),
+        ImVec2(0.0f, bodyCenterY + bodyRadiusY * 0.15f),
         bodyRadiusX * 0.6f, bodyRadiusY * 0.7f,
         bellyColor, 0.0f, 24
     );
@@ -1124,112 +1371,60 @@ void ChatWindow::RenderInteractiveCat(float centerX, float centerY, float size)
     // Rayures sur le corps
     for (int i = 0; i < 3; i++)
     {
-        float stripeX = catX + bodyOffsetX + (i - 1) * bodyRadiusX * 0.4f;
+        float stripeX = (i - 1) * bodyRadiusX * 0.4f;
         float stripeY = bodyCenterY - bodyRadiusY * 0.3f;
         drawList->AddEllipseFilled(
             ImVec2(stripeX, stripeY),
             bodyRadiusX * 0.12f, bodyRadiusY * 0.5f,
-            furDark, 0.0f, 12
+            CAT_FUR_DARK, 0.0f, 12
         );
     }
     
     // === PATTES ===
+    drawList = m_catPawsMesh.Begin(sharedData);
     float pawY = bodyCenterY + bodyRadiusY * 0.7f;
     float pawSpread = s * (0.25f + lay * 0.15f);  // Plus écartées quand couché
     
     // Pattes avant
     for (int side = -1; side <= 1; side += 2)
     {
-        float pawX = catX + side * pawSpread;
+        float pawX = side * pawSpread;
         float pawW = s * 0.1f;
         float pawH = s * (0.12f - lay * 0.04f);
         
-        drawList->AddEllipseFilled(ImVec2(pawX, pawY), pawW, pawH, furColor, 0.0f, 12);
+        drawList->AddEllipseFilled(ImVec2(pawX, pawY), pawW, pawH, CAT_FUR, 0.0f, 12);
         // Coussinets
-        drawList->AddCircleFilled(ImVec2(pawX, pawY + pawH * 0.3f), pawW * 0.6f, furLight, 10);
+        drawList->AddCircleFilled(ImVec2(pawX, pawY + pawH * 0.3f), pawW * 0.6f, CAT_FUR_LIGHT, 10);
     }
     
     // Pattes arrière (visibles quand couché)
     if (lay > 0.3f)
     {
-        float backPawX = catX - bodyRadiusX * 0.8f;
+        float backPawX = -bodyRadiusX * 0.8f;
         float backPawY = bodyCenterY + bodyRadiusY * 0.3f;
-        drawList->AddEllipseFilled(ImVec2(backPawX, backPawY), s * 0.12f, s * 0.08f, furColor, 0.0f, 12);
-    }
-    
-    // === QUEUE - Enroulée autour quand couché ===
-    float tailWave = sinf(m_animTime * 2.5f) * 0.08f * (1.0f - lay * 0.5f);
-    
-    // Base de la queue
-    float tailBaseX = catX + bodyRadiusX * (0.7f - lay * 0.3f);
-    float tailBaseY = bodyCenterY - bodyRadiusY * (0.2f - lay * 0.3f);
-    
-    // La queue s'enroule autour et peut couvrir les yeux
-    float tailCurl = lay * 0.8f + m_tailCoverAmount * 0.5f;
-    
-    // Points de contrôle de la queue
-    ImVec2 tailP1(tailBaseX, tailBaseY);
-    
-    // Quand couché : queue enroulée autour du corps puis monte vers le visage
-    float ctrl1X = tailBaseX + s * (0.15f + tailWave) * (1.0f - tailCurl * 0.5f);
-    float ctrl1Y = tailBaseY - s * 0.2f - tailCurl * s * 0.4f;
-    
-    // La queue monte vers le visage quand elle couvre
-    float headY = catY - s * (0.2f - lay * 0.1f);
-    float headRadius = s * (0.38f - lay * 0.05f);
-    float eyeY = headY - headRadius * (0.05f + lay * 0.1f);
-    
-    float ctrl2X = catX + s * (0.1f - tailCurl * 0.2f);
-    float ctrl2Y = eyeY + s * (0.3f - tailCurl * 0.4f);
-    
-    float endX = catX - tailCurl * s * 0.05f;
-    float endY = eyeY + (1.0f - tailCurl) * s * 0.2f;
-    
-    ImVec2 tailCtrl1(ctrl1X, ctrl1Y);
-    ImVec2 tailCtrl2(ctrl2X, ctrl2Y);
-    ImVec2 tailP2(endX, endY);
-    
-    // Dessiner la queue
-    int tailSegments = 22;
-    for (int i = 0; i < tailSegments; i++)
-    {
-        float t = (float)i / (float)(tailSegments - 1);
-        float u = 1.0f - t;
-        
-        float px = u*u*u*tailP1.x + 3*u*u*t*tailCtrl1.x + 3*u*t*t*tailCtrl2.x + t*t*t*tailP2.x;
-        float py = u*u*u*tailP1.y + 3*u*u*t*tailCtrl1.y + 3*u*t*t*tailCtrl2.y + t*t*t*tailP2.y;
-        
-        float thickness = s * (0.07f - t * 0.03f) * (1.0f + tailCurl * 0.2f);
-        ImU32 segColor = (i % 5 < 3) ? furColor : furDark;
-        
-        drawList->AddCircleFilled(ImVec2(px, py), thickness, segColor, 10);
+        drawList->AddEllipseFilled(ImVec2(backPawX, backPawY), s * 0.12f, s * 0.08f, CAT_FUR, 0.0f, 12);
     }
     
-    // Bout duveteux
-    drawList->AddCircleFilled(tailP2, s * 0.05f, furLight, 12);
-    
     // === TÊTE ===
-    float headOffsetY = lay * s * 0.08f;  // Tête plus basse quand couché
-    headY = catY - s * (0.2f - lay * 0.12f) + headOffsetY;
-    headRadius = s * (0.38f - lay * 0.03f);
+    drawList = m_catHeadMesh.Begin(sharedData);
     
     // Tête principale
-    drawList->AddCircleFilled(ImVec2(catX, headY), headRadius, furColor, 48);
+    drawList->AddCircleFilled(ImVec2(0.0f, headY), headRadius, CAT_FUR, 48);
     
     // Joues
     float cheekY = headY + headRadius * 0.25f;
-    drawList->AddCircleFilled(ImVec2(catX - headRadius * 0.45f, cheekY), headRadius * 0.32f, furLight, 20);
-    drawList->AddCircleFilled(ImVec2(catX + headRadius * 0.45f, cheekY), headRadius * 0.32f, furLight, 20);
+    drawList->AddCircleFilled(ImVec2(-headRadius * 0.45f, cheekY), headRadius * 0.32f, CAT_FUR_LIGHT, 20);
+    drawList->AddCircleFilled(ImVec2(headRadius * 0.45f, cheekY), headRadius * 0.32f, CAT_FUR_LIGHT, 20);
     
     // Rayures sur le front
     for (int i = 0; i < 3; i++)
     {
-        float stripeX = catX + (i - 1) * headRadius * 0.25f;
+        float stripeX = (i - 1) * headRadius * 0.25f;
         float stripeY = headY - headRadius * 0.5f;
         drawList->AddEllipseFilled(
             ImVec2(stripeX, stripeY),
             headRadius * 0.08f, headRadius * 0.2f,
-            furDark, 0.0f, 8
+            CAT_FUR_DARK, 0.0f, 8
         );
     }
     
@@ -1239,136 +1434,120 @@ void ChatWindow::RenderInteractiveCat(float centerX, float centerY, float size)
     
     for (int side = -1; side <= 1; side += 2)
     {
-        float earX = catX + side * headRadius * 0.55f;
+        float earX = side * headRadius * 0.55f;
         
         ImVec2 e1(earX, earY + s * 0.12f);
         ImVec2 e2(earX + side * s * 0.12f, earY - s * (0.18f - earTilt));
         ImVec2 e3(earX - side * s * 0.08f, earY - s * 0.05f);
         
-        drawList->AddTriangleFilled(e1, e2, e3, furColor);
+        drawList->AddTriangleFilled(e1, e2, e3, CAT_FUR);
         
         // Intérieur rose
         ImVec2 ei1(earX, earY + s * 0.08f);
         ImVec2 ei2(earX + side * s * 0.08f, earY - s * (0.1f - earTilt));
         ImVec2 ei3(earX - side * s * 0.04f, earY - s * 0.02f);
-        drawList->AddTriangleFilled(ei1, ei2, ei3, innerEarColor);
+        drawList->AddTriangleFilled(ei1, ei2, ei3, CAT_INNER_EAR);
     }
     
     // === YEUX ===
-    float eyeSpacing = headRadius * 0.4f;
-    eyeY = headY - headRadius * 0.05f;
-    float eyeRadius = headRadius * 0.2f;
-    
-    // Quand couché sans peek : yeux fermés (petites lignes)
-    // Quand peek : yeux mi-ouverts qui regardent
-    float eyeOpenAmount = (1.0f - lay) + peek * 0.7f;
-    eyeOpenAmount = std::min(1.0f, eyeOpenAmount);
-    
-    // Position des yeux avec suivi
-    float eyeOffsetX = m_catEyeCurrentX * eyeOpenAmount;
-    float eyeOffsetY = m_catEyeCurrentY * eyeOpenAmount;
+    // Le blanc des yeux reste avec la tête, les iris sont à part pour suivre le regard
+    ImDrawList* irisList = m_catIrisMesh.Begin(sharedData);
+    const bool eyesOpen = layout.eyeOpen > 0.3f && tailCover < 0.7f;
     
     for (int side = -1; side <= 1; side += 2)
     {
-        float eyeX = catX + side * eyeSpacing;
+        float eyeX = side * layout.eyeSpacing;
         
-        if (eyeOpenAmount > 0.3f && m_tailCoverAmount < 0.7f)
+        if (eyesOpen)
         {
             // Yeux ouverts ou mi-ouverts
-            float openScale = std::min(1.0f, eyeOpenAmount);
+            float openScale = layout.eyeOpen;
             float actualRadius = eyeRadius * openScale;
             
             // Blanc de l'œil (forme d'amande quand mi-ouvert)
             if (openScale > 0.5f)
             {
-                drawList->AddCircleFilled(ImVec2(eyeX, eyeY), actualRadius, eyeWhite, 20);
+                drawList->AddCircleFilled(ImVec2(eyeX, eyeY), actualRadius, CAT_EYE_WHITE, 20);
             }
             else
             {
                 // Œil mi-fermé - forme d'amande
-                drawList->AddEllipseFilled(ImVec2(eyeX, eyeY), actualRadius, actualRadius * 0.5f, eyeWhite, 0.0f, 16);
+                drawList->AddEllipseFilled(ImVec2(eyeX, eyeY), actualRadius, actualRadius * 0.5f, CAT_EYE_WHITE, 0.0f, 16);
             }
             
             // Iris
             float irisRadius = actualRadius * 0.65f;
-            drawList->AddCircleFilled(
-                ImVec2(eyeX + eyeOffsetX, eyeY + eyeOffsetY),
-                irisRadius, eyeColor, 16
-            );
+            irisList->AddCircleFilled(ImVec2(eyeX, eyeY), irisRadius, CAT_EYE, 16);
             
             // Pupille
             float pupilW = irisRadius * 0.35f;
             float pupilH = irisRadius * 0.75f * openScale;
-            drawList->AddEllipseFilled(
-                ImVec2(eyeX + eyeOffsetX, eyeY + eyeOffsetY),
-                pupilW, pupilH,
-                pupilColor, 0.0f, 12
-            );
+            irisList->AddEllipseFilled(ImVec2(eyeX, eyeY), pupilW, pupilH, CAT_PUPIL, 0.0f, 12);
             
             // Reflet
-            drawList->AddCircleFilled(
-                ImVec2(eyeX + eyeOffsetX - pupilW * 0.4f, eyeY + eyeOffsetY - pupilH * 0.3f),
-                eyeRadius * 0.12f, eyeWhite, 6
+            irisList->AddCircleFilled(
+                ImVec2(eyeX - pupilW * 0.4f, eyeY - pupilH * 0.3f),
+                eyeRadius * 0.12f, CAT_EYE_WHITE, 6
             );
         }
         else
         {
             // Yeux fermés - petites courbes
-            float lineY = eyeY;
-            ImVec2 start(eyeX - eyeRadius * 0.8f, lineY);
-            ImVec2 ctrl(eyeX, lineY + eyeRadius * 0.3f);
-            ImVec2 end(eyeX + eyeRadius * 0.8f, lineY);
-            drawList->AddBezierQuadratic(start, ctrl, end, closedEyeColor, 2.5f, 12);
+            ImVec2 start(eyeX - eyeRadius * 0.8f, eyeY);
+            ImVec2 ctrl(eyeX, eyeY + eyeRadius * 0.3f);
+            ImVec2 end(eyeX + eyeRadius * 0.8f, eyeY);
+            drawList->AddBezierQuadratic(start, ctrl, end, CAT_LINE, 2.5f, 12);
         }
     }
     
     // === COUVERTURE PAR LA QUEUE (quand peek, on voit les yeux par-dessus) ===
-    if (m_tailCoverAmount > 0.3f && peek < 0.5f)
+    drawList = m_catFaceMesh.Begin(sharedData);
+    if (tailCover > 0.3f && peek < 0.5f)
     {
         float coverY = eyeY + eyeRadius * 0.3f;
-        float coverWidth = headRadius * 0.8f * m_tailCoverAmount;
-        float coverHeight = eyeRadius * 1.2f * m_tailCoverAmount;
+        float coverWidth = headRadius * 0.8f * tailCover;
+        float coverHeight = eyeRadius * 1.2f * tailCover;
         
         for (int i = 0; i < 5; i++)
         {
             float ox = (i - 2) * coverWidth * 0.22f;
             float sz = coverHeight * (1.0f - fabsf(i - 2) * 0.12f);
-            ImU32 col = (i % 2 == 0) ? furColor : furDark;
-            drawList->AddCircleFilled(ImVec2(catX + ox, coverY), sz, col, 14);
+            ImU32 col = (i % 2 == 0) ? CAT_FUR : CAT_FUR_DARK;
+            drawList->AddCircleFilled(ImVec2(ox, coverY), sz, col, 14);
         }
     }
     
     // === NEZ ===
     float noseY = headY + headRadius * 0.25f;
     float noseSize = s * 0.045f;
-    ImVec2 n1(catX, noseY - noseSize);
-    ImVec2 n2(catX - noseSize, noseY + noseSize * 0.5f);
-    ImVec2 n3(catX + noseSize, noseY + noseSize * 0.5f);
-    drawList->AddTriangleFilled(n1, n2, n3, noseColor);
+    ImVec2 n1(0.0f, noseY - noseSize);
+    ImVec2 n2(-noseSize, noseY + noseSize * 0.5f);
+    ImVec2 n3(noseSize, noseY + noseSize * 0.5f);
+    drawList->AddTriangleFilled(n1, n2, n3, CAT_NOSE);
     
     // === BOUCHE ===
     float mouthY = noseY + s * 0.04f;
     
     // Ligne centrale
     drawList->AddLine(
-        ImVec2(catX, noseY + noseSize * 0.3f),
-        ImVec2(catX, mouthY + s * 0.02f),
-        closedEyeColor, 2.0f
+        ImVec2(0.0f, noseY + noseSize * 0.3f),
+        ImVec2(0.0f, mouthY + s * 0.02f),
+        CAT_LINE, 2.0f
     );
     
     // Sourire (plus petit quand couché/endormi)
     float smileSize = s * (0.1f - lay * 0.03f + peek * 0.02f);
     drawList->AddBezierQuadratic(
-        ImVec2(catX, mouthY),
-        ImVec2(catX - smileSize, mouthY + smileSize * 0.5f),
-        ImVec2(catX - smileSize * 1.2f, mouthY - smileSize * 0.1f),
-        closedEyeColor, 1.8f, 10
+        ImVec2(0.0f, mouthY),
+        ImVec2(-smileSize, mouthY + smileSize * 0.5f),
+        ImVec2(-smileSize * 1.2f, mouthY - smileSize * 0.1f),
+        CAT_LINE, 1.8f, 10
     );
     drawList->AddBezierQuadratic(
-        ImVec2(catX, mouthY),
-        ImVec2(catX + smileSize, mouthY + smileSize * 0.5f),
-        ImVec2(catX + smileSize * 1.2f, mouthY - smileSize * 0.1f),
-        closedEyeColor, 1.8f, 10
+        ImVec2(0.0f, mouthY),
+        ImVec2(smileSize, mouthY + smileSize * 0.5f),
+        ImVec2(smileSize * 1.2f, mouthY - smileSize * 0.1f),
+        CAT_LINE, 1.8f, 10
     );
     
     // === MOUSTACHES ===
@@ -1377,16 +1556,142 @@ void ChatWindow::RenderInteractiveCat(float centerX, float centerY, float size)
     
     for (int side = -1; side <= 1; side += 2)
     {
-        float baseX = catX + side * s * 0.08f;
+        float baseX = side * s * 0.08f;
         for (int i = -1; i <= 1; i++)
         {
-            float angle = i * 0.15f + side * 0.1f;
             float wy = whiskerBaseY + i * s * 0.02f;
             float endX = baseX + side * whiskerLen;
             float endY = wy + i * s * 0.04f;
-            drawList->AddLine(ImVec2(baseX, wy), ImVec2(endX, endY), whiskerColor, 1.3f);
+            drawList->AddLine(ImVec2(baseX, wy), ImVec2(endX, endY), CAT_WHISKER, 1.3f);
         }
     }
+}
+
+/**
+ * @brief Dessine le chat interactif avec 3 poses : assis, couché, peek
+ *
+ * Les parties fixes pour une pose sont tessellées une fois par
+ * BuildCatMeshes ; seuls la queue, le regard, la rotation du corps et les
+ * "Zzz" changent d'une frame à l'autre.
+ */
+void ChatWindow::RenderInteractiveCat(float centerX, float centerY, float size)
+{
+    ProfileScope profile(ProfileSection::InteractiveCat);
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 windowPos = ImGui::GetWindowPos();
+    
+    // Position absolue du chat
+    float catX = windowPos.x + centerX;
+    float catY = windowPos.y + centerY;
+    
+    // Récupérer la position de la souris
+    ImVec2 mousePos = ImGui::GetMousePos();
+    
+    // Calculer la direction vers la souris (seulement si pas couché)
+    float dx = mousePos.x - catX;
+    float dy = mousePos.y - catY;
+    float distance = sqrtf(dx * dx + dy * dy);
+    
+    // Les yeux suivent le curseur seulement si le chat n'est pas couché
+    float eyeTrackingStrength = 1.0f - m_layDownAmount * 0.8f + m_peekAmount * 0.5f;
+    float maxEyeMove = size * 0.08f;
+    if (distance > 0)
+    {
+        m_catEyeTargetX = (dx / distance) * std::min(distance * 0.02f, maxEyeMove) * eyeTrackingStrength;
+        m_catEyeTargetY = (dy / distance) * std::min(distance * 0.02f, maxEyeMove) * eyeTrackingStrength;
+    }
+    
+    // Rotation du corps vers la souris (moins quand couché)
+    float targetRotation = atan2f(dy, dx) * 0.1f * (1.0f - m_layDownAmount * 0.7f);
+    m_catBodyRotation += (targetRotation - m_catBodyRotation) * 0.05f;
+    
+    // Mise à jour de l'animation
+    UpdateCatAnimation();
+    
+    // Pose quantifiée : tant qu'elle ne bouge pas, la géométrie en cache sert telle quelle
+    CatMeshKey key;
+    key.lay = static_cast<int>(lroundf(m_layDownAmount * CAT_POSE_STEPS));
+    key.peek = static_cast<int>(lroundf(m_peekAmount * CAT_POSE_STEPS));
+    key.tailCover = static_cast<int>(lroundf(m_tailCoverAmount * CAT_POSE_STEPS));
+    key.size = size;
+    key.sharedData = drawList->_Data;
+    key.whitePixel = drawList->_Data->TexUvWhitePixel;
+    key.flags = drawList->Flags;
+    
+    // Raccourcis pour les états
+    float lay = key.lay / CAT_POSE_STEPS;         // 0 = assis, 1 = couché
+    float peek = key.peek / CAT_POSE_STEPS;       // 0 = yeux cachés, 1 = peek
+    float tailCover = key.tailCover / CAT_POSE_STEPS;
+    float s = size;
+    
+    if (!(key == m_catMeshKey))
+    {
+        BuildCatMeshes(drawList->_Data, s, lay, peek, tailCover);
+        m_catMeshKey = key;
+        ++m_catMeshBuilds;
+    }
+    
+    const CatLayout layout = ComputeCatLayout(s, lay, peek);
+    
+    // === CORPS (suit la rotation) ET PATTES ===
+    float bodyOffsetX = m_catBodyRotation * s * 0.2f * (1.0f - lay);
+    m_catBodyMesh.Draw(drawList, ImVec2(catX + bodyOffsetX, catY));
+    m_catPawsMesh.Draw(drawList, ImVec2(catX, catY));
+    
+    // === QUEUE - Enroulée autour quand couché ===
+    float tailWave = sinf(m_animTime * 2.5f) * 0.08f * (1.0f - lay * 0.5f);
+    
+    // Base de la queue
+    float tailBaseX = catX + layout.bodyRadiusX * (0.7f - lay * 0.3f);
+    float tailBaseY = catY + layout.bodyCenterY - layout.bodyRadiusY * (0.2f - lay * 0.3f);
+    
+    // La queue s'enroule autour et peut couvrir les yeux
+    float tailCurl = lay * 0.8f + tailCover * 0.5f;
+    
+    // Points de contrôle de la queue
+    ImVec2 tailP1(tailBaseX, tailBaseY);
+    
+    // Quand couché : queue enroulée autour du corps puis monte vers le visage
+    float ctrl1X = tailBaseX + s * (0.15f + tailWave) * (1.0f - tailCurl * 0.5f);
+    float ctrl1Y = tailBaseY - s * 0.2f - tailCurl * s * 0.4f;
+    
+    // La queue monte vers le visage quand elle couvre
+    float eyeY = catY + layout.tailTargetY;
+    float ctrl2X = catX + s * (0.1f - tailCurl * 0.2f);
+    float ctrl2Y = eyeY + s * (0.3f - tailCurl * 0.4f);
+    
+    float endX = catX - tailCurl * s * 0.05f;
+    float endY = eyeY + (1.0f - tailCurl) * s * 0.2f;
+    
+    ImVec2 tailCtrl1(ctrl1X, ctrl1Y);
+    ImVec2 tailCtrl2(ctrl2X, ctrl2Y);
+    ImVec2 tailP2(endX, endY);
+    
+    // Dessiner la queue
+    int tailSegments = 22;
+    for (int i = 0; i < tailSegments; i++)
+    {
+        float t = (float)i / (float)(tailSegments - 1);
+        float u = 1.0f - t;
+        
+        float px = u*u*u*tailP1.x + 3*u*u*t*tailCtrl1.x + 3*u*t*t*tailCtrl2.x + t*t*t*tailP2.x;
+        float py = u*u*u*tailP1.y + 3*u*u*t*tailCtrl1.y + 3*u*t*t*tailCtrl2.y + t*t*t*tailP2.y;
+        
+        float thickness = s * (0.07f - t * 0.03f) * (1.0f + tailCurl * 0.2f);
+        ImU32 segColor = (i % 5 < 3) ? CAT_FUR : CAT_FUR_DARK;
+        
+        drawList->AddCircleFilled(ImVec2(px, py), thickness, segColor, 10);
+    }
+    
+    // Bout duveteux
+    drawList->AddCircleFilled(tailP2, s * 0.05f, CAT_FUR_LIGHT, 12);
+    
+    // === TÊTE, YEUX (les iris suivent le curseur), COUVERTURE, NEZ, BOUCHE, MOUSTACHES ===
+    float eyeOffsetX = m_catEyeCurrentX * layout.eyeOpen;
+    float eyeOffsetY = m_catEyeCurrentY * layout.eyeOpen;
+    m_catHeadMesh.Draw(drawList, ImVec2(catX, catY));
+    m_catIrisMesh.Draw(drawList, ImVec2(catX + eyeOffsetX, catY + eyeOffsetY));
+    m_catFaceMesh.Draw(drawList, ImVec2(catX, catY));
     
     // === "Zzz" quand le chat dort (couché sans peek) ===
     if (lay > 0.5f && peek < 0.3f)
@@ -1394,10 +1699,8 @@ void ChatWindow::RenderInteractiveCat(float centerX, float centerY, float size)
         float zzzAlpha = (lay - 0.5f) * 2.0f * (1.0f - peek);
         float zzzOffset = sinf(m_animTime * 1.5f) * s * 0.03f;
         
-        ImU32 zzzColor = IM_COL32(200, 200, 255, (int)(180 * zzzAlpha));
-        
-        float zX = catX + headRadius * 0.8f;
-        float zY = headY - headRadius * 0.8f + zzzOffset;
+        float zX = catX + layout.headRadius * 0.8f;
+        float zY = catY + layout.headY - layout.headRadius * 0.8f + zzzOffset;
         
         // Petits "z" qui montent
         for (int i = 0; i < 3; i++)
@@ -1417,3 +1720,117 @@ void ChatWindow::RenderInteractiveCat(float centerX, float centerY, float size)
         }
     }
 }
+
+/**
+ * @brief Fenêtre du profileur (F3)
+ *
+ * Les statistiques portent sur les ~4 dernières secondes de chaque section.
+ */
+void ChatWindow::RenderProfilerOverlay()
+{
+    const FrameProfiler& profiler = FrameProfiler::Get();
+    ImGuiViewport* viewport = ImGui::GetMainViewport();
+
+    ImGui::SetNextWindowPos(ImVec2(viewport->Pos.x + viewport->Size.x - 30, viewport->Pos.y + 80),
+                            ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.9f);
+
+    ImGuiWindowFlags flags =
+        ImGuiWindowFlags_AlwaysAutoResize |
+        ImGuiWindowFlags_NoSavedSettings |
+        ImGuiWindowFlags_NoFocusOnAppearing |
+        ImGuiWindowFlags_NoNav;
+
+    if (ImGui::Begin("Profileur (F3)", &m_showProfiler, flags))
+    {
+        // Régularité des frames
+        FrameProfiler::Stats pacing = profiler.GetFrameIntervalStats();
+        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.5f, 1.0f), "Intervalle entre frames");
+        ImGui::Text("p50 %.2f ms (%.0f FPS)   p99 %.2f ms   max %.2f ms",
+                    pacing.p50, pacing.p50 > 0.0 ? 1000.0 / pacing.p50 : 0.0, pacing.p99, pacing.max);
+        ImGui::Spacing();
+
+        if (ImGui::BeginTable("ProfilerSections", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+        {
+            ImGui::TableSetupColumn("Section");
+            ImGui::TableSetupColumn("p50 (ms)");
+            ImGui::TableSetupColumn("p99 (ms)");
+            ImGui::TableSetupColumn("max (ms)");
+            ImGui::TableSetupColumn("mesures");
+            ImGui::TableHeadersRow();
+
+            for (size_t i = 0; i < static_cast<size_t>(ProfileSection::Count); ++i)
+            {
+                ProfileSection section = static_cast<ProfileSection>(i);
+                FrameProfiler::Stats stats = profiler.GetStats(section);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(FrameProfiler::SectionName(section));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stats.p50);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stats.p99);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", stats.max);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", stats.samples);
+            }
+            ImGui::EndTable();
+        }
+
+        if (profiler.GetDroppedSamples() > 0)
+        {
+            ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.5f, 1.0f), "Mesures perdues : %llu",
+                               static_cast<unsigned long long>(profiler.GetDroppedSamples()));
+        }
+
+        ImGui::Spacing();
+        int particleTarget = static_cast<int>(m_particles.GetTargetCount());
+        if (ImGui::SliderInt("Étoiles", &particleTarget, 0, 20000))
+        {
+            m_particles.SetTargetCount(static_cast<size_t>(particleTarget));
+        }
+        ImGui::Text("Affichées : %zu (%.3f ms)", m_particles.GetActiveCount(), m_particles.GetLastCostMs());
+        ImGui::Text("Chat : %llu tessellations", static_cast<unsigned long long>(m_catMeshBuilds));
+        if (m_texManager)
+        {
+            TextureAtlas::Stats atlas = m_texManager->GetAtlasStats();
+            ImGui::Text("Textures : %zu pages pour %zu images (%.0f %% occupé)", atlas.textures, atlas.regions,
+                        atlas.totalPixels ? 100.0 * atlas.usedPixels / atlas.totalPixels : 0.0);
+            TextureManager::GifStats gifStats = m_texManager->GetGifStats();
+            ImGui::Text("GIFs : %.1f Mo indexés (%.1f Mo en RGBA)", gifStats.indexedBytes / 1048576.0,
+                        gifStats.rgbaBytes / 1048576.0);
+            ImGui::Text("Envoyé : %.1f Mo (%.1f Mo en frames entières)", gifStats.uploadedBytes / 1048576.0,
+                        gifStats.fullFrameBytes / 1048576.0);
+            ImGui::Text("Animations actives : %zu sur %zu GIFs", gifStats.animating, gifStats.gifs);
+            TextureManager::CacheStats cache = m_texManager->GetCacheStats();
+            ImGui::Text("Cache : CPU %.0f/%.0f Mo, GPU %.0f/%.0f Mo", cache.cpuBytes / 1048576.0,
+                        cache.cpuBudget / 1048576.0, cache.gpuBytes / 1048576.0, cache.gpuBudget / 1048576.0);
+            ImGui::Text("%llu succès, %llu échecs, %llu évictions GPU, %llu CPU, %llu redécodages",
+                        static_cast<unsigned long long>(cache.hits), static_cast<unsigned long long>(cache.misses),
+                        static_cast<unsigned long long>(cache.gpuEvictions),
+                        static_cast<unsigned long long>(cache.cpuEvictions),
+                        static_cast<unsigned long long>(cache.redecodes));
+            TextureManager::UploadStats upload = m_texManager->GetUploadStats();
+            ImGui::Text("File d'envoi : %zu images (%.1f Mo), max %.1f Mo / %.2f ms par frame",
+                        upload.queued, upload.queuedBytes / 1048576.0, upload.maxFrameBytes / 1048576.0,
+                        upload.maxFrameMs);
+        }
+
+        ImGui::Spacing();
+        if (ImGui::Button("Exporter la trace (Chrome)"))
+        {
+            const char* path = "kitty_trace.json";
+            m_profilerStatus = profiler.ExportChromeTrace(path)
+                ? std::string("Trace écrite dans ") + path
+                : std::string("Impossible d'écrire ") + path;
+        }
+        if (!m_profilerStatus.empty())
+        {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(m_profilerStatus.c_str());
+        }
+    }
+    ImGui::End();
+}
@@ -13,7 +13,12 @@
 
 #include "matrix_client.h"
 #include "texture_manager.h"
+#include "frame_arena.h"
+#include "room_filter.h"
+#include "particle_field.h"
+#include "cached_mesh.h"
 #include <string>
+#include <vector>
 #include <chrono>
 
 /**
@@ -39,7 +44,7 @@ public:
     /**
      * @brief Destructeur
      */
-    ~ChatWindow() = default;
+    ~ChatWindow();
     
     /**
      * @brief Rendu de l'interface complète
@@ -48,9 +53,36 @@ public:
      */
     void Render();
 
+    /**
+     * @brief Applique le thème visuel de Kitty Chat au contexte ImGui courant
+     * 
+     * À appeler une fois après ImGui::CreateContext().
+     */
+    static void ApplyStyle();
+
+    /**
+     * @brief Libère les textes temporaires de la frame précédente
+     * 
+     * À appeler juste avant ImGui::NewFrame().
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Nombre d'étoiles souhaité pour le fond animé
+     * 
+     * Le champ en affiche moins si son budget par frame est dépassé.
+     */
+    void SetBackgroundParticles(size_t count) { m_particles.SetTargetCount(count); }
+
+    /**
+     * @brief Champ d'étoiles du fond (statistiques)
+     */
+    const ParticleField& GetBackgroundParticles() const { return m_particles; }
+
 private:
     MatrixClient* m_client;           // Référence vers le client Matrix
     TextureManager* m_texManager;     // Gestionnaire de textures pour les GIFs
+    FrameArena m_frameArena;          // Textes temporaires de la frame en cours
     
     // État de l'écran de connexion
     char m_username[256];             // Buffer pour le nom d'utilisateur
@@ -60,6 +92,7 @@ private:
     bool m_isRegistering;             // Mode inscription (true) ou connexion (false)
     std::string m_errorMessage;       // Message d'erreur à afficher
     std::string m_successMessage;     // Message de succès
+    AuthTask m_authTask;              // Connexion/inscription en cours (future invalide sinon)
     
     // État de la zone de chat
     char m_messageInput[4096];        // Buffer pour le message à envoyer
@@ -70,11 +103,29 @@ private:
     char m_joinRoomId[256];           // ID du salon à rejoindre
     bool m_showCreateRoom;            // Afficher le popup de création
     bool m_showJoinRoom;              // Afficher le popup de join
+
+    // Liste des salons : seules les lignes visibles sont dessinées et les
+    // libellés ne sont reconstruits que quand le salon change
+    char m_roomFilterText[128];       // Saisie du filtre de salons
+    RoomFilter m_roomFilter;          // Index de recherche sur noms et alias
+    std::vector<std::string> m_roomLabels;      // Libellé en cache (par index de salon)
+    std::vector<uint32_t> m_roomLabelRevisions; // Room::revision au moment du libellé
+    std::vector<uint32_t> m_visibleRooms;       // Salons affichés (ordre + filtre)
+    uint64_t m_visibleRoomsRevision;  // GetRoomsRevision() à la dernière construction
+    bool m_roomListDirty;             // Filtre modifié depuis la dernière construction
+
+    // Profileur
+    bool m_showProfiler;              // Fenêtre du profileur affichée (F3)
+    std::string m_profilerStatus;     // Résultat du dernier export de trace
     
     // Animation et effets visuels
     std::chrono::steady_clock::time_point m_startTime;
     float m_animTime;                 // Temps d'animation
+    ParticleField m_particles;        // Étoiles du fond
     bool m_gifsLoaded;                // GIFs chargés
+    ImageHandle m_catLooking;         // GIFs des états du chat
+    ImageHandle m_catSleeping;
+    ImageHandle m_catPeeking;
     
     // Chat interactif qui suit le curseur
     float m_catEyeTargetX;            // Position cible des yeux X
@@ -86,6 +137,38 @@ private:
     float m_peekAmount;               // 0 = caché, 1 = il peek par-dessus
     bool m_passwordFieldFocused;      // Le champ password a le focus
     float m_catBodyRotation;          // Rotation du corps vers le curseur
+
+    /**
+     * @struct CatMeshKey
+     * @brief Pose (quantifiée) et contexte de la géométrie en cache du chat
+     */
+    struct CatMeshKey
+    {
+        int lay = -1;
+        int peek = -1;
+        int tailCover = -1;
+        float size = 0.0f;
+        const ImDrawListSharedData* sharedData = nullptr;
+        ImVec2 whitePixel;            // UV du pixel blanc de l'atlas
+        int flags = 0;                // Antialiasing de la draw list
+
+        bool operator==(const CatMeshKey& other) const
+        {
+            return lay == other.lay && peek == other.peek && tailCover == other.tailCover &&
+                   size == other.size && sharedData == other.sharedData &&
+                   whitePixel.x == other.whitePixel.x && whitePixel.y == other.whitePixel.y &&
+                   flags == other.flags;
+        }
+    };
+
+    // Géométrie en cache du chat (dans l'ordre de dessin, la queue entre pattes et tête)
+    CachedMesh m_catBodyMesh;         // Corps, ventre, rayures (suit la rotation)
+    CachedMesh m_catPawsMesh;         // Pattes
+    CachedMesh m_catHeadMesh;         // Tête, oreilles, blanc des yeux ou yeux fermés
+    CachedMesh m_catIrisMesh;         // Iris, pupilles, reflets (suivent le regard)
+    CachedMesh m_catFaceMesh;         // Couverture par la queue, nez, bouche, moustaches
+    CatMeshKey m_catMeshKey;          // Pose des meshes enregistrés
+    uint64_t m_catMeshBuilds;         // Nombre de tessellations (statistique)
     
     // Méthodes de rendu privées
     
@@ -93,6 +176,11 @@ private:
      * @brief Affiche l'écran de connexion
      */
     void RenderLoginScreen();
+
+    /**
+     * @brief Récupère le résultat de la connexion/inscription quand il est prêt
+     */
+    void PollAuthTask();
     
     /**
      * @brief Affiche l'interface principale de chat
@@ -103,6 +191,13 @@ private:
      * @brief Affiche la barre latérale avec la liste des salons
      */
     void RenderSidebar();
+
+    /**
+     * @brief Met à jour les libellés et la liste des salons affichés
+     * 
+     * Ne fait rien tant qu'aucun salon n'a changé et que le filtre est inchangé.
+     */
+    void UpdateRoomList();
     
     /**
      * @brief Affiche la zone de messages du salon actif
@@ -112,8 +207,9 @@ private:
     /**
      * @brief Affiche un message individuel
      * @param message Message à afficher
+     * @param seed Graine d'ID de la zone de messages (combinée à message.idHash)
      */
-    void RenderMessage(const Message& message);
+    void RenderMessage(const MessageView& message, uint32_t seed);
     
     /**
      * @brief Affiche la zone de saisie de message
@@ -127,11 +223,11 @@ private:
     
     /**
      * @brief Affiche un GIF animé
-     * @param name Nom du GIF
+     * @param gif Handle du GIF
      * @param maxWidth Largeur max
      * @param maxHeight Hauteur max
      */
-    void RenderGif(const std::string& name, float maxWidth, float maxHeight);
+    void RenderGif(ImageHandle gif, float maxWidth, float maxHeight);
     
     /**
      * @brief Dessine un fond animé avec des étoiles/particules
@@ -155,6 +251,17 @@ private:
      * @brief Met à jour l'animation du chat
      */
     void UpdateCatAnimation();
+
+    /**
+     * @brief Tessellise les parties fixes du chat pour une pose donnée
+     */
+    void BuildCatMeshes(ImDrawListSharedData* sharedData, float s, float lay, float peek, float tailCover);
+
+    /**
+     * @brief Affiche les temps par section, la régularité des frames et
+     *        les attentes de verrous (voir FrameProfiler)
+     */
+    void RenderProfilerOverlay();
 };
 
 #endif // CHAT_WINDOW_H
@@ -0,0 +1,118 @@
+/**
+ * @file event_registry.h
+ * @brief Table des types d'événements Matrix et de leurs traitements
+ *
+ * Chaque type d'événement connu ("m.room.message", "m.receipt"...) reçoit un
+ * identifiant numérique. Le type est haché une seule fois, au parsing de la
+ * réponse de sync ; le traitement se résume ensuite à un accès dans un
+ * tableau indexé par (identifiant, section).
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef EVENT_REGISTRY_H
+#define EVENT_REGISTRY_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @enum SyncSection
+ * @brief Partie d'un salon de la réponse de sync d'où provient un événement
+ */
+enum class SyncSection : uint8_t
+{
+    State,          // rooms.join.*.state
+    Timeline,       // rooms.join.*.timeline
+    Ephemeral,      // rooms.join.*.ephemeral (accusés de lecture...)
+    AccountData,    // rooms.join.*.account_data (tags, marqueur de lecture...)
+    Count
+};
+
+/**
+ * @class EventTypeRegistry
+ * @brief Associe les types d'événements à un traitement par section
+ *
+ * Le registre est rempli une fois au démarrage puis seulement lu : il peut
+ * être consulté depuis n'importe quel thread sans verrou.
+ */
+template <typename Handler>
+class EventTypeRegistry
+{
+public:
+    // Identifiant des types non enregistrés
+    static constexpr uint16_t UNKNOWN_TYPE = 0;
+
+    EventTypeRegistry()
+    {
+        m_names.emplace_back();
+        m_handlers.push_back({});
+    }
+
+    /**
+     * @brief Enregistre le traitement d'un type d'événement dans une section
+     * @param section Partie de la réponse de sync concernée
+     * @param type Type Matrix (ex: "m.room.message")
+     * @param handler Traitement à appeler
+     */
+    void On(SyncSection section, std::string_view type, Handler handler)
+    {
+        m_handlers[Intern(type)][static_cast<size_t>(section)] = handler;
+    }
+
+    /**
+     * @brief Retourne l'identifiant d'un type (une recherche dans la table de hachage)
+     * @return UNKNOWN_TYPE si aucun traitement n'est enregistré pour ce type
+     */
+    uint16_t Lookup(std::string_view type) const
+    {
+        auto it = m_ids.find(type);
+        return it != m_ids.end() ? it->second : UNKNOWN_TYPE;
+    }
+
+    /**
+     * @brief Retourne le traitement d'un type dans une section (nullptr si aucun)
+     */
+    Handler Find(SyncSection section, uint16_t id) const
+    {
+        if (id >= m_handlers.size())
+            return Handler();
+        return m_handlers[id][static_cast<size_t>(section)];
+    }
+
+    /**
+     * @brief Retourne le nom d'un type enregistré
+     */
+    std::string_view Name(uint16_t id) const
+    {
+        return id < m_names.size() ? std::string_view(m_names[id]) : std::string_view();
+    }
+
+private:
+    std::deque<std::string> m_names;    // Noms des types (adresses stables pour m_ids)
+    std::vector<std::array<Handler, static_cast<size_t>(SyncSection::Count)>> m_handlers;
+    std::unordered_map<std::string_view, uint16_t> m_ids;
+
+    /**
+     * @brief Retourne l'identifiant d'un type, en l'ajoutant si nécessaire
+     */
+    uint16_t Intern(std::string_view type)
+    {
+        auto it = m_ids.find(type);
+        if (it != m_ids.end())
+            return it->second;
+
+        uint16_t id = static_cast<uint16_t>(m_names.size());
+        m_names.emplace_back(type);
+        m_handlers.push_back({});
+        m_ids.emplace(m_names.back(), id);
+        return id;
+    }
+};
+
+#endif // EVENT_REGISTRY_H
@@ -0,0 +1,64 @@
+/**
+ * @file frame_arena.cpp
+ * @brief Implémentation de la mémoire temporaire des frames
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "frame_arena.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief Constructeur - réserve la capacité initiale
+ */
+FrameArena::FrameArena(size_t capacity)
+    : m_arena(capacity)
+{
+}
+
+/**
+ * @brief Libère toutes les chaînes de la frame précédente
+ */
+void FrameArena::Reset()
+{
+    m_arena.Reset();
+}
+
+/**
+ * @brief Formate une chaîne valable jusqu'au prochain Reset()
+ *
+ * Deux passes : la première mesure, la seconde écrit directement dans l'arène.
+ */
+const char* FrameArena::Format(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list measure;
+    va_copy(measure, args);
+    int length = vsnprintf(nullptr, 0, format, measure);
+    va_end(measure);
+
+    if (length < 0)
+    {
+        va_end(args);
+        return "";
+    }
+
+    char* text = static_cast<char*>(m_arena.Allocate(static_cast<size_t>(length) + 1, 1));
+    vsnprintf(text, static_cast<size_t>(length) + 1, format, args);
+    va_end(args);
+    return text;
+}
+
+/**
+ * @brief Copie un texte en le terminant par un zéro
+ */
+const char* FrameArena::Copy(std::string_view text)
+{
+    char* copy = static_cast<char*>(m_arena.Allocate(text.size() + 1, 1));
+    memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    return copy;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file frame_arena.h
+ * @brief Mémoire temporaire d'une frame pour les textes affichés
+ *
+ * Les chaînes construites pendant le rendu (libellés, statuts...) ne vivent
+ * que le temps de la frame : ImGui les recopie dans ses listes de dessin.
+ * Elles sont écrites ici au lieu de std::string temporaires, et toute la
+ * mémoire est rendue d'un coup par Reset() avant ImGui::NewFrame().
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "batch_arena.h"
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @class FrameArena
+ * @brief Arène de chaînes remise à zéro à chaque frame
+ *
+ * Après les premières frames, le bloc de l'arène a atteint sa taille de
+ * croisière : le rendu ne fait plus aucune allocation sur le tas.
+ */
+class FrameArena
+{
+public:
+    /**
+     * @brief Constructeur
+     * @param capacity Taille initiale (en octets)
+     */
+    explicit FrameArena(size_t capacity = 16 * 1024);
+
+    /**
+     * @brief Libère toutes les chaînes de la frame précédente
+     */
+    void Reset();
+
+    /**
+     * @brief Formate une chaîne (syntaxe printf) valable jusqu'au prochain Reset()
+     */
+    const char* Format(const char* format, ...);
+
+    /**
+     * @brief Copie un texte en le terminant par un zéro
+     */
+    const char* Copy(std::string_view text);
+
+    /**
+     * @brief Octets utilisés pendant la frame en cours
+     */
+    size_t BytesUsed() const { return m_arena.BytesUsed(); }
+
+    /**
+     * @brief Chaînes créées pendant la frame en cours
+     */
+    size_t StringCount() const { return m_arena.AllocationCount(); }
+
+    /**
+     * @brief Nombre de blocs (plus d'un = la frame a dépassé la capacité)
+     */
+    size_t BlockCount() const { return m_arena.BlockCount(); }
+
+private:
+    BatchArena m_arena;
+};
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,236 @@
+/**
+ * @file frame_profiler.cpp
+ * @brief Implémentation du profileur de frames
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "frame_profiler.h"
+#include <algorithm>
+#include <cstdio>
+
+static const char* SECTION_NAMES[] = {
+    "Frame",
+    "PumpEvents",
+    "Fond anime",
+    "Animations GIF",
+    "Liste des salons",
+    "Messages",
+    "Chat interactif",
+    "Attente verrou accuses",
+    "Attente verrou HTTP"
+};
+
+static_assert(sizeof(SECTION_NAMES) / sizeof(SECTION_NAMES[0]) == static_cast<size_t>(ProfileSection::Count),
+              "Un nom par section");
+static_assert((FrameProfiler::RING_CAPACITY & (FrameProfiler::RING_CAPACITY - 1)) == 0,
+              "La capacité de l'anneau doit être une puissance de 2");
+
+/**
+ * @brief Petit numéro stable du thread courant (tid de la trace)
+ */
+static uint16_t CurrentThreadIndex()
+{
+    static std::atomic<uint16_t> nextIndex{ 0 };
+    thread_local uint16_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+/**
+ * @brief Profileur de l'application (créé au premier appel)
+ */
+FrameProfiler& FrameProfiler::Get()
+{
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+/**
+ * @brief Constructeur
+ */
+FrameProfiler::FrameProfiler()
+    : m_origin(std::chrono::steady_clock::now())
+    , m_ring(new Slot[RING_CAPACITY])
+{
+    m_trace.reserve(TRACE_CAPACITY);
+}
+
+/**
+ * @brief Nom affichable d'une section
+ */
+const char* FrameProfiler::SectionName(ProfileSection section)
+{
+    size_t index = static_cast<size_t>(section);
+    return index < static_cast<size_t>(ProfileSection::Count) ? SECTION_NAMES[index] : "?";
+}
+
+/**
+ * @brief Instant courant (ns depuis la création du profileur)
+ */
+uint64_t FrameProfiler::Now() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_origin).count());
+}
+
+/**
+ * @brief Enregistre une mesure
+ *
+ * Chaque écrivain réserve sa case par un fetch_add, puis la publie via son
+ * numéro de séquence : aucun verrou, aucune allocation.
+ */
+void FrameProfiler::Record(ProfileSection section, uint64_t startNs, uint64_t durationNs)
+{
+    const uint64_t index = m_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_ring[index & (RING_CAPACITY - 1)];
+
+    const uint32_t duration = static_cast<uint32_t>(std::min<uint64_t>(durationNs, UINT32_MAX));
+    const uint64_t packed = (static_cast<uint64_t>(duration) << 32) |
+                            (static_cast<uint64_t>(section) << 16) |
+                            CurrentThreadIndex();
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.start.store(startNs, std::memory_order_relaxed);
+    slot.packed.store(packed, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Début d'une frame : mesure l'intervalle et vide l'anneau
+ */
+void FrameProfiler::NextFrame()
+{
+    const uint64_t now = Now();
+    if (m_lastFrameStart != 0)
+    {
+        m_frameIntervals.Push(static_cast<float>((now - m_lastFrameStart) / 1e6));
+    }
+    m_lastFrameStart = now;
+
+    // Les écrivains ont fait plus d'un tour d'anneau : les plus vieilles mesures sont perdues
+    const uint64_t head = m_head.load(std::memory_order_acquire);
+    if (head - m_tail > RING_CAPACITY)
+    {
+        m_dropped += head - RING_CAPACITY - m_tail;
+        m_tail = head - RING_CAPACITY;
+    }
+
+    for (; m_tail < head; ++m_tail)
+    {
+        const Slot& slot = m_ring[m_tail & (RING_CAPACITY - 1)];
+        const uint64_t published = 2 * m_tail + 2;
+
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence < published)
+            break;              // Encore en cours d'écriture : reprise à la prochaine frame
+
+        uint64_t start = slot.start.load(std::memory_order_relaxed);
+        uint64_t packed = slot.packed.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence != published || slot.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            ++m_dropped;        // Case réécrite par un tour suivant
+            continue;
+        }
+
+        TraceEvent event;
+        event.start = start;
+        event.duration = static_cast<uint32_t>(packed >> 32);
+        event.section = static_cast<uint16_t>(packed >> 16);
+        event.thread = static_cast<uint16_t>(packed);
+
+        if (event.section < m_windows.size())
+        {
+            m_windows[event.section].Push(static_cast<float>(event.duration / 1e6));
+        }
+
+        if (m_trace.size() < TRACE_CAPACITY)
+        {
+            m_trace.push_back(event);
+        }
+        else
+        {
+            m_trace[m_traceNext] = event;
+            m_traceNext = (m_traceNext + 1) % TRACE_CAPACITY;
+        }
+    }
+}
+
+/**
+ * @brief Ajoute une durée à la fenêtre glissante
+ */
+void FrameProfiler::Window::Push(float value)
+{
+    values[next] = value;
+    next = (next + 1) % WINDOW_SIZE;
+    count = std::min(count + 1, WINDOW_SIZE);
+}
+
+/**
+ * @brief Calcule p50, p99 et max sur la fenêtre
+ */
+FrameProfiler::Stats FrameProfiler::Window::Compute() const
+{
+    Stats stats;
+    stats.samples = count;
+    if (count == 0)
+        return stats;
+
+    std::array<float, WINDOW_SIZE> sorted;
+    std::copy(values.begin(), values.begin() + count, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + count);
+
+    stats.p50 = sorted[(count - 1) / 2];
+    stats.p99 = sorted[std::min(count - 1, (count * 99) / 100)];
+    stats.max = sorted[count - 1];
+    return stats;
+}
+
+/**
+ * @brief Statistiques glissantes d'une section
+ */
+FrameProfiler::Stats FrameProfiler::GetStats(ProfileSection section) const
+{
+    size_t index = static_cast<size_t>(section);
+    return index < m_windows.size() ? m_windows[index].Compute() : Stats();
+}
+
+/**
+ * @brief Statistiques de l'intervalle entre deux frames
+ */
+FrameProfiler::Stats FrameProfiler::GetFrameIntervalStats() const
+{
+    return m_frameIntervals.Compute();
+}
+
+/**
+ * @brief Écrit l'historique au format Chrome trace
+ *
+ * Événements complets ("ph":"X"), horodatages en microsecondes.
+ */
+bool FrameProfiler::ExportChromeTrace(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    // Du plus ancien au plus récent
+    const size_t count = m_trace.size();
+    const size_t first = (count < TRACE_CAPACITY) ? 0 : m_traceNext;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const TraceEvent& event = m_trace[(first + i) % count];
+        fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"kitty\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                i == 0 ? "" : ",",
+                SectionName(static_cast<ProfileSection>(event.section)),
+                static_cast<unsigned>(event.thread),
+                event.start / 1000.0,
+                event.duration / 1000.0);
+    }
+
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
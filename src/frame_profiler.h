@@ -0,0 +1,230 @@
+/**
+ * @file frame_profiler.h
+ * @brief Profileur de frames : chronomètres de portée et trace Chrome
+ *
+ * Les sections coûteuses du rendu (fond animé, chat interactif, liste des
+ * salons, messages, animations des GIFs...) et les attentes de verrous sont
+ * chronométrées par des objets ProfileScope. Chaque mesure est écrite sans
+ * verrou dans un anneau partagé par tous les threads ; le thread de rendu
+ * le vide une fois par frame pour tenir des fenêtres glissantes (p50/p99)
+ * et un historique exportable au format Chrome trace (chrome://tracing,
+ * Perfetto).
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @enum ProfileSection
+ * @brief Sections chronométrées
+ */
+enum class ProfileSection : uint16_t
+{
+    Frame,              // ChatWindow::Render complet
+    PumpEvents,         // Application des mises à jour de la synchronisation
+    Background,         // RenderAnimatedBackground
+    TextureUpdate,      // TextureManager::Update
+    Sidebar,            // RenderSidebar
+    MessageArea,        // RenderMessageArea
+    InteractiveCat,     // RenderInteractiveCat
+    ReceiptLockWait,    // Attente du verrou des accusés de lecture
+    HttpLockWait,       // Attente du verrou de la connexion HTTP
+    Count
+};
+
+/**
+ * @class FrameProfiler
+ * @brief Collecte des mesures et statistiques glissantes
+ *
+ * Record() peut être appelé depuis n'importe quel thread ; NextFrame(),
+ * GetStats() et ExportChromeTrace() uniquement depuis le thread de rendu.
+ */
+class FrameProfiler
+{
+public:
+    static constexpr size_t RING_CAPACITY = 16384;    // Mesures en transit (puissance de 2)
+    static constexpr size_t WINDOW_SIZE = 240;        // Mesures par section pour p50/p99 (~4 s)
+    static constexpr size_t TRACE_CAPACITY = 65536;   // Mesures gardées pour l'export
+
+    /**
+     * @struct Stats
+     * @brief Statistiques d'une section sur la fenêtre glissante (en ms)
+     */
+    struct Stats
+    {
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+        size_t samples = 0;
+    };
+
+    /**
+     * @brief Profileur de l'application
+     */
+    static FrameProfiler& Get();
+
+    /**
+     * @brief Nom affichable d'une section
+     */
+    static const char* SectionName(ProfileSection section);
+
+    /**
+     * @brief Instant courant (ns depuis la création du profileur)
+     */
+    uint64_t Now() const;
+
+    /**
+     * @brief Enregistre une mesure (sans verrou, depuis n'importe quel thread)
+     */
+    void Record(ProfileSection section, uint64_t startNs, uint64_t durationNs);
+
+    /**
+     * @brief Début d'une frame : mesure l'intervalle et vide l'anneau
+     *
+     * À appeler une fois par frame depuis le thread de rendu.
+     */
+    void NextFrame();
+
+    /**
+     * @brief Statistiques glissantes d'une section
+     */
+    Stats GetStats(ProfileSection section) const;
+
+    /**
+     * @brief Statistiques de l'intervalle entre deux frames (régularité)
+     */
+    Stats GetFrameIntervalStats() const;
+
+    /**
+     * @brief Mesures perdues (anneau plein avant d'être vidé)
+     */
+    uint64_t GetDroppedSamples() const { return m_dropped; }
+
+    /**
+     * @brief Écrit l'historique au format Chrome trace (JSON)
+     * @return true si le fichier a été écrit
+     */
+    bool ExportChromeTrace(const std::string& path) const;
+
+private:
+    FrameProfiler();
+
+    /**
+     * @struct Slot
+     * @brief Case de l'anneau, protégée par un numéro de séquence
+     *
+     * sequence vaut 2*index+1 pendant l'écriture de la mesure numéro index,
+     * puis 2*index+2 une fois publiée.
+     */
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{ 0 };
+        std::atomic<uint64_t> start{ 0 };
+        std::atomic<uint64_t> packed{ 0 };    // durée (32 bits) | section (16) | thread (16)
+    };
+
+    /**
+     * @struct Window
+     * @brief Dernières durées d'une section (tampon circulaire)
+     */
+    struct Window
+    {
+        std::array<float, WINDOW_SIZE> values{};
+        size_t count = 0;
+        size_t next = 0;
+
+        void Push(float value);
+        Stats Compute() const;
+    };
+
+    /**
+     * @struct TraceEvent
+     * @brief Mesure conservée pour l'export
+     */
+    struct TraceEvent
+    {
+        uint64_t start;
+        uint32_t duration;
+        uint16_t section;
+        uint16_t thread;
+    };
+
+    std::chrono::steady_clock::time_point m_origin;
+
+    // Anneau multi-producteurs, consommé par le thread de rendu
+    std::unique_ptr<Slot[]> m_ring;
+    std::atomic<uint64_t> m_head{ 0 };
+    uint64_t m_tail = 0;
+    uint64_t m_dropped = 0;
+
+    // Agrégats (thread de rendu)
+    std::array<Window, static_cast<size_t>(ProfileSection::Count)> m_windows;
+    Window m_frameIntervals;
+    uint64_t m_lastFrameStart = 0;
+    std::vector<TraceEvent> m_trace;    // Circulaire, TRACE_CAPACITY au plus
+    size_t m_traceNext = 0;
+};
+
+/**
+ * @class ProfileScope
+ * @brief Chronomètre la portée courante
+ *
+ * @code
+ * void ChatWindow::RenderSidebar()
+ * {
+ *     ProfileScope profile(ProfileSection::Sidebar);
+ *     ...
+ * }
+ * @endcode
+ */
+class ProfileScope
+{
+public:
+    explicit ProfileScope(ProfileSection section)
+        : m_section(section)
+        , m_start(FrameProfiler::Get().Now())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        FrameProfiler& profiler = FrameProfiler::Get();
+        profiler.Record(m_section, m_start, profiler.Now() - m_start);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileSection m_section;
+    uint64_t m_start;
+};
+
+/**
+ * @brief Prend un verrou en chronométrant l'attente s'il est déjà pris
+ *
+ * Un verrou libre ne coûte qu'un try_lock et n'est pas enregistré.
+ */
+template<typename Mutex>
+std::unique_lock<Mutex> ProfiledLock(Mutex& mutex, ProfileSection waitSection)
+{
+    if (mutex.try_lock())
+        return std::unique_lock<Mutex>(mutex, std::adopt_lock);
+
+    ProfileScope wait(waitSection);
+    return std::unique_lock<Mutex>(mutex);
+}
+
+#endif // FRAME_PROFILER_H
@@ -0,0 +1,553 @@
+/**
+ * @file gif_decoder.cpp
+ * @brief Implémentation du décodage des GIFs en frames indexées et de leur composition
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "gif_decoder.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GIF_DECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Limite de taille des GIFs acceptés (pixels par frame)
+static const size_t MAX_GIF_PIXELS = 4096 * 4096;
+
+// Codes LZW sur 12 bits au plus
+static const int LZW_MAX_CODES = 4096;
+
+/**
+ * @class GifReader
+ * @brief Lecture séquentielle bornée du fichier
+ */
+class GifReader
+{
+public:
+    GifReader(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+        , m_pos(0)
+    {
+    }
+
+    bool Ok(size_t count) const { return m_pos + count <= m_size; }
+    uint8_t U8() { return m_pos < m_size ? m_data[m_pos++] : 0; }
+    int U16() { int low = U8(); return low | (U8() << 8); }
+    void Skip(size_t count) { m_pos = std::min(m_size, m_pos + count); }
+    bool AtEnd() const { return m_pos >= m_size; }
+
+    /**
+     * @brief Lit une suite de sous-blocs (taille + données) jusqu'au bloc vide
+     */
+    bool ReadSubBlocks(std::vector<uint8_t>& out)
+    {
+        out.clear();
+        for (;;)
+        {
+            if (!Ok(1))
+                return false;
+            uint8_t length = U8();
+            if (length == 0)
+                return true;
+            if (!Ok(length))
+            {
+                // Fichier tronqué : on garde ce qui est là
+                out.insert(out.end(), m_data + m_pos, m_data + m_size);
+                m_pos = m_size;
+                return false;
+            }
+            out.insert(out.end(), m_data + m_pos, m_data + m_pos + length);
+            m_pos += length;
+        }
+    }
+
+    /**
+     * @brief Saute une suite de sous-blocs
+     */
+    void SkipSubBlocks()
+    {
+        for (;;)
+        {
+            uint8_t length = U8();
+            if (length == 0 || AtEnd())
+                return;
+            Skip(length);
+        }
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos;
+};
+
+/**
+ * @brief Lit une table de couleurs GIF (RGB) en RGBA empaqueté opaque
+ */
+static void ReadColorTable(GifReader& reader, int entries, uint32_t* table)
+{
+    for (int i = 0; i < entries; ++i)
+    {
+        uint32_t r = reader.U8();
+        uint32_t g = reader.U8();
+        uint32_t b = reader.U8();
+        table[i] = r | (g << 8) | (b << 16) | 0xFF000000u;
+    }
+}
+
+/**
+ * @brief Décompresse les index LZW d'une frame
+ * @return Nombre de pixels décodés (moins que pixelCount si le flux est tronqué ou invalide)
+ */
+static size_t DecodeLzw(const std::vector<uint8_t>& stream, int minCodeSize, std::vector<uint8_t>& pixels, size_t pixelCount)
+{
+    pixels.assign(pixelCount, 0);
+    if (minCodeSize < 1 || minCodeSize > 11)
+        return 0;
+
+    uint16_t prefix[LZW_MAX_CODES];
+    uint8_t suffix[LZW_MAX_CODES];
+    uint8_t stack[LZW_MAX_CODES + 1];
+
+    const int clearCode = 1 << minCodeSize;
+    const int endCode = clearCode + 1;
+    for (int i = 0; i < clearCode; ++i)
+    {
+        prefix[i] = 0;
+        suffix[i] = static_cast<uint8_t>(i);
+    }
+
+    int codeSize = minCodeSize + 1;
+    int nextCode = clearCode + 2;
+    int oldCode = -1;
+    uint8_t firstChar = 0;
+
+    uint32_t bits = 0;
+    int bitCount = 0;
+    size_t bytePos = 0;
+    size_t out = 0;
+
+    while (out < pixelCount)
+    {
+        while (bitCount < codeSize)
+        {
+            if (bytePos >= stream.size())
+                return out;
+            bits |= static_cast<uint32_t>(stream[bytePos++]) << bitCount;
+            bitCount += 8;
+        }
+
+        int code = static_cast<int>(bits & ((1u << codeSize) - 1));
+        bits >>= codeSize;
+        bitCount -= codeSize;
+
+        if (code == clearCode)
+        {
+            codeSize = minCodeSize + 1;
+            nextCode = clearCode + 2;
+            oldCode = -1;
+            continue;
+        }
+        if (code == endCode)
+            break;
+
+        if (oldCode < 0)
+        {
+            if (code >= clearCode)
+                return out;
+            firstChar = static_cast<uint8_t>(code);
+            pixels[out++] = firstChar;
+            oldCode = code;
+            continue;
+        }
+
+        const int inCode = code;
+        int top = 0;
+        if (code >= nextCode)
+        {
+            if (code > nextCode)
+                return out;
+            stack[top++] = firstChar;
+            code = oldCode;
+        }
+        while (code >= clearCode)
+        {
+            stack[top++] = suffix[code];
+            code = prefix[code];
+        }
+        firstChar = static_cast<uint8_t>(code);
+        stack[top++] = firstChar;
+
+        while (top > 0 && out < pixelCount)
+        {
+            pixels[out++] = stack[--top];
+        }
+
+        if (nextCode < LZW_MAX_CODES)
+        {
+            prefix[nextCode] = static_cast<uint16_t>(oldCode);
+            suffix[nextCode] = firstChar;
+            ++nextCode;
+            if (nextCode == (1 << codeSize) && codeSize < 12)
+                ++codeSize;
+        }
+        oldCode = inCode;
+    }
+    return out;
+}
+
+/**
+ * @brief Ligne de destination de la ligne décodée row (GIF entrelacé)
+ */
+static int InterlacedRow(int row, int height)
+{
+    // Passes : lignes 0, 8, 16... puis 4, 12... puis 2, 6... puis 1, 3...
+    const int pass1 = (height + 7) / 8;
+    const int pass2 = (height + 3) / 8;
+    const int pass3 = (height + 1) / 4;
+    if (row < pass1)
+        return row * 8;
+    row -= pass1;
+    if (row < pass2)
+        return 4 + row * 8;
+    row -= pass2;
+    if (row < pass3)
+        return 2 + row * 4;
+    row -= pass3;
+    return 1 + row * 2;
+}
+
+
+/**
+ * @brief Plus petit rectangle contenant les deux
+ */
+GifRect GifRect::Union(const GifRect& other) const
+{
+    if (Empty())
+        return other;
+    if (other.Empty())
+        return *this;
+
+    GifRect result;
+    result.x = std::min(x, other.x);
+    result.y = std::min(y, other.y);
+    result.width = std::max(x + width, other.x + other.width) - result.x;
+    result.height = std::max(y + height, other.y + other.height) - result.y;
+    return result;
+}
+
+/**
+ * @brief Décode un GIF (GIF87a / GIF89a)
+ *
+ * Aucune composition ici : chaque frame garde son rectangle (borné à la
+ * toile) et ses index, désentrelacés.
+ */
+bool DecodeIndexedGif(const uint8_t* data, size_t size, IndexedGif& gif)
+{
+    gif = IndexedGif();
+    if (!data || size < 13)
+        return false;
+
+    GifReader reader(data, size);
+    if (memcmp(data, "GIF87a", 6) != 0 && memcmp(data, "GIF89a", 6) != 0)
+        return false;
+    reader.Skip(6);
+
+    const int width = reader.U16();
+    const int height = reader.U16();
+    const uint8_t flags = reader.U8();
+    reader.Skip(2);     // Couleur de fond, rapport d'aspect
+    if (width <= 0 || height <= 0 || static_cast<size_t>(width) * height > MAX_GIF_PIXELS)
+        return false;
+
+    gif.width = width;
+    gif.height = height;
+
+    // Palette globale : toujours la première
+    int globalPalette = -1;
+    if (flags & 0x80)
+    {
+        gif.palettes.emplace_back(256, 0u);
+        ReadColorTable(reader, 2 << (flags & 7), gif.palettes.back().data());
+        globalPalette = 0;
+    }
+
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> pixels;
+
+    // Contrôle graphique de la prochaine frame
+    int delay = 100;
+    int disposal = 0;
+    int transparent = -1;
+
+    while (!reader.AtEnd())
+    {
+        const uint8_t tag = reader.U8();
+        if (tag == 0x3B)        // Fin du fichier
+            break;
+
+        if (tag == 0x21)        // Extension
+        {
+            const uint8_t label = reader.U8();
+            if (label == 0xF9 && reader.Ok(6))
+            {
+                reader.U8();    // Taille du bloc (4)
+                const uint8_t packed = reader.U8();
+                delay = reader.U16() * 10;
+                const int index = reader.U8();
+                disposal = (packed >> 2) & 7;
+                transparent = (packed & 1) ? index : -1;
+            }
+            reader.SkipSubBlocks();
+            continue;
+        }
+
+        if (tag != 0x2C)        // Bloc inconnu : fichier corrompu
+            break;
+
+        // Descripteur d'image
+        if (!reader.Ok(9))
+            break;
+        const int frameX = reader.U16();
+        const int frameY = reader.U16();
+        const int frameW = reader.U16();
+        const int frameH = reader.U16();
+        const uint8_t imageFlags = reader.U8();
+
+        int palette = globalPalette;
+        if (imageFlags & 0x80)
+        {
+            gif.palettes.emplace_back(256, 0u);
+            ReadColorTable(reader, 2 << (imageFlags & 7), gif.palettes.back().data());
+            palette = static_cast<int>(gif.palettes.size() - 1);
+        }
+
+        const int minCodeSize = reader.U8();
+        reader.ReadSubBlocks(stream);   // Tronqué : la frame est décodée en partie
+        if (palette < 0)
+            break;
+
+        const size_t framePixels = static_cast<size_t>(frameW) * frameH;
+        if (framePixels > MAX_GIF_PIXELS)
+            break;
+        const size_t decoded = DecodeLzw(stream, minCodeSize, pixels, framePixels);
+        const bool complete = decoded == framePixels;
+        const bool interlaced = (imageFlags & 0x40) != 0;
+
+        // Une frame entrelacée incomplète a des trous sur toute sa hauteur
+        if (!complete && interlaced)
+            break;
+
+        IndexedFrame frame;
+        frame.palette = static_cast<uint32_t>(palette);
+        frame.transparent = transparent;
+        frame.disposal = disposal == 2 ? GifDisposal::Background
+                       : disposal == 3 ? GifDisposal::Previous
+                       : GifDisposal::Keep;
+        frame.delay = delay;
+
+        // Rectangle borné à la toile (et aux lignes décodées)
+        const int decodedRows = frameW > 0 ? static_cast<int>(decoded / frameW) : 0;
+        frame.rect.x = std::min(frameX, width);
+        frame.rect.y = std::min(frameY, height);
+        frame.rect.width = std::min(frameW, width - frame.rect.x);
+        frame.rect.height = std::min(decodedRows, height - frame.rect.y);
+        if (frame.rect.Empty())
+            frame.rect = GifRect();
+
+        frame.indices.resize(static_cast<size_t>(frame.rect.width) * frame.rect.height);
+        for (int row = 0; row < decodedRows; ++row)
+        {
+            const int y = interlaced ? InterlacedRow(row, frameH) : row;
+            if (y >= frame.rect.height)
+                continue;
+            memcpy(&frame.indices[static_cast<size_t>(y) * frame.rect.width],
+                   &pixels[static_cast<size_t>(row) * frameW], frame.rect.width);
+        }
+        gif.frames.push_back(std::move(frame));
+
+        delay = 100;
+        disposal = 0;
+        transparent = -1;
+
+        if (!complete)
+            break;
+    }
+
+    return !gif.frames.empty();
+}
+
+/**
+ * @brief Mémoire occupée par les index et les palettes
+ */
+size_t IndexedGif::BytesUsed() const
+{
+    size_t bytes = 0;
+    for (const std::vector<uint32_t>& palette : palettes)
+    {
+        bytes += palette.capacity() * sizeof(uint32_t);
+    }
+    for (const IndexedFrame& frame : frames)
+    {
+        bytes += frame.indices.capacity();
+    }
+    return bytes;
+}
+
+/**
+ * @brief Convertit des index en pixels RGBA via une palette
+ *
+ * Une simple table de correspondance : huit pixels par tour avec le gather
+ * d'AVX2 quand le compilateur le cible, quatre en SSE2 (lectures de table
+ * scalaires, masque sans branche pour la transparence), sinon une boucle
+ * scalaire. Les pixels transparents reprennent la valeur de la destination.
+ */
+void ExpandPalette(const uint8_t* indices, size_t count, const uint32_t* palette, int transparent, uint8_t* rgba)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i keep = _mm256_set1_epi32(transparent);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + i));
+        __m256i offsets = _mm256_cvtepu8_epi32(bytes);
+        __m256i colors = _mm256_i32gather_epi32(reinterpret_cast<const int*>(palette), offsets, 4);
+        __m256i* destination = reinterpret_cast<__m256i*>(rgba + i * 4);
+        if (transparent >= 0)
+        {
+            __m256i mask = _mm256_cmpeq_epi32(offsets, keep);
+            colors = _mm256_blendv_epi8(colors, _mm256_loadu_si256(destination), mask);
+        }
+        _mm256_storeu_si256(destination, colors);
+    }
+#elif defined(GIF_DECODER_SSE2)
+    // Pas de gather en SSE2 : les lectures de table restent scalaires, le
+    // mélange avec la destination se fait par masque (and / andnot / or)
+    const __m128i keep = _mm_set1_epi32(transparent);
+    for (; i + 4 <= count; i += 4)
+    {
+        const uint8_t* source = indices + i;
+        __m128i colors = _mm_set_epi32(static_cast<int>(palette[source[3]]), static_cast<int>(palette[source[2]]),
+                                       static_cast<int>(palette[source[1]]), static_cast<int>(palette[source[0]]));
+        __m128i* destination = reinterpret_cast<__m128i*>(rgba + i * 4);
+        if (transparent >= 0)
+        {
+            __m128i offsets = _mm_set_epi32(source[3], source[2], source[1], source[0]);
+            __m128i mask = _mm_cmpeq_epi32(offsets, keep);
+            colors = _mm_or_si128(_mm_and_si128(mask, _mm_loadu_si128(destination)), _mm_andnot_si128(mask, colors));
+        }
+        _mm_storeu_si128(destination, colors);
+    }
+#else
+    if (transparent < 0)
+    {
+        for (; i + 8 <= count; i += 8)
+        {
+            uint32_t colors[8];
+            for (int k = 0; k < 8; ++k)
+            {
+                colors[k] = palette[indices[i + k]];
+            }
+            memcpy(rgba + i * 4, colors, sizeof(colors));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        if (indices[i] != transparent)
+            memcpy(rgba + i * 4, &palette[indices[i]], 4);
+    }
+}
+
+/**
+ * @brief Redimensionne la toile et l'efface
+ */
+void GifCanvas::Reset(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+    m_disposeRect = GifRect();
+    m_dispose = GifDisposal::Keep;
+    m_blank = true;
+}
+
+/**
+ * @brief Efface une zone (pixels transparents)
+ */
+void GifCanvas::Clear(const GifRect& rect)
+{
+    for (int y = rect.y; y < rect.y + rect.height; ++y)
+    {
+        memset(&m_pixels[(static_cast<size_t>(y) * m_width + rect.x) * 4], 0, static_cast<size_t>(rect.width) * 4);
+    }
+}
+
+/**
+ * @brief Passe à la frame donnée
+ *
+ * Applique d'abord la disposition de la frame précédente, puis dessine la
+ * frame dans son rectangle. Recommencer à la frame 0 efface la toile.
+ */
+GifRect GifCanvas::Apply(const IndexedGif& gif, size_t frame)
+{
+    GifRect dirty;
+    if (frame >= gif.frames.size() || gif.width != m_width || gif.height != m_height)
+        return dirty;
+
+    if (frame == 0)
+    {
+        if (!m_blank)
+        {
+            Clear({ 0, 0, m_width, m_height });
+            dirty = { 0, 0, m_width, m_height };
+        }
+    }
+    else if (m_dispose == GifDisposal::Background)
+    {
+        Clear(m_disposeRect);
+        dirty = m_disposeRect;
+    }
+    else if (m_dispose == GifDisposal::Previous)
+    {
+        const GifRect& rect = m_disposeRect;
+        for (int y = 0; y < rect.height; ++y)
+        {
+            memcpy(&m_pixels[(static_cast<size_t>(rect.y + y) * m_width + rect.x) * 4],
+                   &m_saved[static_cast<size_t>(y) * rect.width * 4], static_cast<size_t>(rect.width) * 4);
+        }
+        dirty = rect;
+    }
+
+    const IndexedFrame& source = gif.frames[frame];
+    const GifRect& rect = source.rect;
+    if (source.disposal == GifDisposal::Previous)
+    {
+        m_saved.resize(static_cast<size_t>(rect.width) * rect.height * 4);
+        for (int y = 0; y < rect.height; ++y)
+        {
+            memcpy(&m_saved[static_cast<size_t>(y) * rect.width * 4],
+                   &m_pixels[(static_cast<size_t>(rect.y + y) * m_width + rect.x) * 4], static_cast<size_t>(rect.width) * 4);
+        }
+    }
+
+    const uint32_t* palette = gif.palettes[source.palette].data();
+    for (int y = 0; y < rect.height; ++y)
+    {
+        ExpandPalette(&source.indices[static_cast<size_t>(y) * rect.width], rect.width, palette, source.transparent,
+                      &m_pixels[(static_cast<size_t>(rect.y + y) * m_width + rect.x) * 4]);
+    }
+
+    m_disposeRect = rect;
+    m_dispose = source.disposal;
+    m_blank = m_blank && rect.Empty();
+    return dirty.Union(rect);
+}
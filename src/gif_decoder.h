@@ -0,0 +1,158 @@
+/**
+ * @file gif_decoder.h
+ * @brief Décodage des GIFs animés en frames indexées (palette + index)
+ *
+ * Un GIF est une image à palette : chaque pixel est un index sur 8 bits,
+ * et la plupart des frames ne redessinent qu'un petit rectangle de la
+ * toile. Les frames sont gardées telles que le fichier les décrit :
+ * rectangle, index, palette, couleur transparente et disposition.
+ *
+ * L'animation est rejouée sur une toile RGBA (GifCanvas) : appliquer une
+ * frame renvoie le rectangle modifié, seul à envoyer au GPU. L'expansion
+ * des index en RGBA (ExpandPalette) se fait à ce moment-là.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef GIF_DECODER_H
+#define GIF_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum GifDisposal
+ * @brief Sort de la zone d'une frame avant la frame suivante
+ */
+enum class GifDisposal : uint8_t
+{
+    Keep,           // La frame reste sur la toile
+    Background,     // Zone effacée (transparente)
+    Previous        // Zone remise dans son état d'avant la frame
+};
+
+/**
+ * @struct GifRect
+ * @brief Rectangle de la toile (pixels)
+ */
+struct GifRect
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool Empty() const { return width <= 0 || height <= 0; }
+
+    /**
+     * @brief Plus petit rectangle contenant les deux
+     */
+    GifRect Union(const GifRect& other) const;
+};
+
+/**
+ * @struct IndexedFrame
+ * @brief Une frame du GIF, avant composition
+ */
+struct IndexedFrame
+{
+    GifRect rect;                   // Zone de la toile redessinée (bornée à la toile)
+    std::vector<uint8_t> indices;   // rect.width * rect.height index, ligne par ligne
+    uint32_t palette = 0;           // Index dans IndexedGif::palettes
+    int transparent = -1;           // Index qui laisse la toile intacte (-1 : aucun)
+    GifDisposal disposal = GifDisposal::Keep;
+    int delay = 100;                // Délai en ms
+};
+
+/**
+ * @struct IndexedGif
+ * @brief Frames indexées d'un GIF
+ *
+ * Palettes de 256 entrées au format RGBA empaqueté (octets R, G, B, A en
+ * mémoire, comme IM_COL32) ; les entrées absentes du fichier valent 0.
+ */
+struct IndexedGif
+{
+    int width = 0;
+    int height = 0;
+    std::vector<std::vector<uint32_t>> palettes;
+    std::vector<IndexedFrame> frames;
+
+    /**
+     * @brief Mémoire occupée par les index et les palettes
+     */
+    size_t BytesUsed() const;
+
+    /**
+     * @brief Mémoire qu'occuperaient les mêmes frames composées en RGBA
+     */
+    size_t RgbaBytes() const { return static_cast<size_t>(width) * height * 4 * frames.size(); }
+};
+
+/**
+ * @brief Décode un GIF (GIF87a / GIF89a)
+ * @param data Contenu du fichier
+ * @param size Taille des données
+ * @param gif Frames décodées (sortie)
+ * @return true si au moins une frame a été décodée
+ *
+ * Un fichier tronqué garde les frames qui précèdent la coupure, et les
+ * lignes déjà décodées de la dernière.
+ */
+bool DecodeIndexedGif(const uint8_t* data, size_t size, IndexedGif& gif);
+
+/**
+ * @brief Convertit des index en pixels RGBA via une palette
+ * @param indices Index des pixels
+ * @param count Nombre de pixels
+ * @param palette 256 couleurs RGBA empaquetées
+ * @param transparent Index qui laisse la destination intacte (-1 : aucun)
+ * @param rgba Destination (count * 4 octets)
+ */
+void ExpandPalette(const uint8_t* indices, size_t count, const uint32_t* palette, int transparent, uint8_t* rgba);
+
+/**
+ * @class GifCanvas
+ * @brief Toile RGBA sur laquelle les frames d'un GIF sont rejouées
+ */
+class GifCanvas
+{
+public:
+    /**
+     * @brief Redimensionne la toile et l'efface
+     */
+    void Reset(int width, int height);
+
+    /**
+     * @brief Passe à la frame donnée
+     * @param gif Frames du GIF (même taille que la toile)
+     * @param frame Frame suivant la dernière appliquée, ou 0 pour recommencer
+     * @return Zone de la toile modifiée (disposition de la frame précédente comprise)
+     */
+    GifRect Apply(const IndexedGif& gif, size_t frame);
+
+    const uint8_t* GetPixels() const { return m_pixels.data(); }
+    int GetPitch() const { return m_width * 4; }
+
+    /**
+     * @brief Mémoire de la toile et de la zone sauvegardée
+     */
+    size_t BytesUsed() const { return m_pixels.capacity() + m_saved.capacity(); }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<uint8_t> m_pixels;
+    std::vector<uint8_t> m_saved;       // Zone sous une frame à disposition Previous
+    GifRect m_disposeRect;              // Zone de la dernière frame appliquée
+    GifDisposal m_dispose = GifDisposal::Keep;
+    bool m_blank = true;                // Rien n'a été dessiné depuis Reset
+
+    /**
+     * @brief Efface une zone (pixels transparents)
+     */
+    void Clear(const GifRect& rect);
+};
+
+#endif // GIF_DECODER_H
@@ -0,0 +1,1772 @@
+/**
+ * @file headless_main.cpp
+ * @brief Pilote headless de Kitty Chat pour mesurer le coût du rendu
+ *
+ * Exécute des frames de ChatWindow sans fenêtre ni GPU, sur n'importe quelle
+ * plateforme :
+ * - le client Matrix est alimenté par des réponses /sync générées, qui
+ *   passent par le vrai chemin de synchronisation (StartOfflineSession) ;
+ * - la souris est scriptée (balayage de la fenêtre, molette, changement de
+ *   salon à intervalle fixe) ;
+ * - les listes de dessin ne sont pas rastérisées, seulement parcourues et
+ *   comptées comme le ferait un backend.
+ *
+ * Pour chaque frame : temps CPU (BeginFrame → ImGui::Render), sommets,
+ * indices, commandes de dessin et allocations du thread de rendu.
+ *
+ * Les sections du FrameProfiler sont aussi résumées, et leur historique
+ * peut être exporté au format Chrome trace.
+ *
+ * --particles N fixe le nombre d'étoiles du fond animé (50 par défaut),
+ * pour mesurer le champ de particules sous charge. --login reste sur
+ * l'écran de connexion (chat interactif) au lieu d'ouvrir la session.
+ * --gifs N ajoute N GIFs générés pour mesurer l'atlas de textures (pages
+ * créées pour combien de frames). --gif-dir décode tous les .gif d'un
+ * dossier ; la mémoire des frames indexées (et son équivalent RGBA), le
+ * volume envoyé aux textures pendant l'animation et le pic de mémoire
+ * résidente du processus sont affichés à la fin. Ces GIFs sont « dessinés »
+ * quatre par quatre, comme des médias qui défilent dans un salon ;
+ * --cpu-budget et --gpu-budget (Mo) bornent le cache de textures, dont les
+ * succès, échecs et évictions sont affichés. --upload-budget (Ko par
+ * frame, 0 : sans limite) borne l'envoi des images arrivées vers l'atlas ;
+ * le plus gros envoi en une frame est affiché.
+ *
+ * --image-bench dossier mesure le décodage des PNG et JPEG d'un dossier
+ * (et de ses sous-dossiers) : débit par format sur un thread, puis temps
+ * de chargement de tout le dossier par les threads du TextureManager.
+ *
+ * --media-bench charge les avatars et images d'une timeline simulée par
+ * MediaFetcher, auprès d'un serveur de médias simulé : miniatures à la
+ * taille des widgets contre fichiers d'origine (requêtes, octets reçus,
+ * pixels décodés, temps).
+ *
+ * --queue-bench compare la file lock-free des mises à jour de sync
+ * (SpscQueue) à une file protégée par un mutex : débit et temps par frame
+ * du thread de rendu.
+ *
+ * --timeline-bench compare le stockage en colonnes des messages
+ * (TimelineStore) à l'ancien std::vector<Message> : octets par message et
+ * débit d'une recherche dans les corps.
+ *
+ * --arena-bench parse les réponses /sync générées (taille fixée par
+ * --rooms et --messages) avec et sans BatchArena : appels à operator new
+ * par événement et mémoire gardée par l'arène d'un lot à l'autre.
+ *
+ * --room-order-bench mesure le coût d'un changement de salon dans la
+ * RoomList (--rooms salons) contre un tri complet de la liste.
+ * --filter-bench mesure la latence par frappe du filtre des salons
+ * (RoomFilter) contre un filtre sans index.
+ *
+ * Usage : KittyChatBench [--frames N] [--warmup N] [--rooms N]
+ *                        [--messages N] [--particles N] [--login]
+ *                        [--gifs N] [--gif-dir dossier]
+ *                        [--cpu-budget Mo] [--gpu-budget Mo]
+ *                        [--upload-budget Ko]
+ *                        [--image-bench dossier] [--media-bench]
+ *                        [--queue-bench] [--timeline-bench] [--arena-bench]
+ *                        [--room-order-bench] [--filter-bench]
+ *                        [--csv fichier] [--trace fichier]
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <nlohmann/json.hpp>
+
+#include "imgui.h"
+
+#include "batch_arena.h"
+#include "chat_window.h"
+#include "frame_profiler.h"
+#include "image_resampler.h"
+#include "jpeg_decoder.h"
+#include "matrix_client.h"
+#include "media_fetcher.h"
+#include "png_decoder.h"
+#include "room_filter.h"
+#include "room_list.h"
+#include "spsc_queue.h"
+#include "texture_manager.h"
+#include "timeline_store.h"
+
+// Allocations du thread courant : le thread de sync alloue en parallèle,
+// seules celles du thread de rendu sont attribuées aux frames
+static thread_local size_t t_allocations = 0;
+static thread_local size_t t_allocatedBytes = 0;
+
+void* operator new(size_t size)
+{
+    ++t_allocations;
+    t_allocatedBytes += size;
+    if (void* block = std::malloc(size ? size : 1))
+        return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    std::free(block);
+}
+
+/**
+ * @brief Allocateur d'ImGui (ImVector, draw lists...) compté comme operator new
+ */
+static void* CountingAlloc(size_t size, void*)
+{
+    ++t_allocations;
+    t_allocatedBytes += size;
+    return std::malloc(size);
+}
+
+static void CountingFree(void* block, void*)
+{
+    std::free(block);
+}
+
+// Paramètres par défaut de la simulation
+static const float DISPLAY_WIDTH = 1280.0f;
+static const float DISPLAY_HEIGHT = 800.0f;
+static const int ROOM_SWITCH_FRAMES = 120;    // Changement de salon toutes les 2 s (à 60 FPS)
+static const int INCREMENTAL_SYNCS = 20;      // Réponses /sync après la synchronisation initiale
+static const char* BENCH_USER = "@bench:localhost";
+
+/**
+ * @struct FrameStats
+ * @brief Mesures d'une frame
+ */
+struct FrameStats
+{
+    double cpuMs = 0.0;
+    size_t vertices = 0;
+    size_t indices = 0;
+    size_t commands = 0;
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+    size_t particles = 0;       // Étoiles affichées après adaptation
+};
+
+/**
+ * @brief Génère un corps de message de longueur variable (parfois sur plusieurs lignes)
+ */
+static std::string MakeBody(std::mt19937& rng)
+{
+    static const char* WORDS[] = {
+        "miaou", "ronron", "croquettes", "sieste", "soleil", "pelote", "laine",
+        "souris", "griffoir", "coussin", "moustache", "ronronnement", "caresse",
+        "fenetre", "oiseau", "carton", "patte", "queue", "gamelle", "calin"
+    };
+    const size_t wordCount = sizeof(WORDS) / sizeof(WORDS[0]);
+
+    std::uniform_int_distribution<int> lengthDist(1, 60);
+    std::uniform_int_distribution<size_t> wordDist(0, wordCount - 1);
+    std::uniform_int_distribution<int> breakDist(0, 24);
+
+    int words = lengthDist(rng);
+    std::string body;
+    for (int i = 0; i < words; ++i)
+    {
+        if (i > 0)
+            body += (breakDist(rng) == 0) ? '\n' : ' ';
+        body += WORDS[wordDist(rng)];
+    }
+    return body;
+}
+
+/**
+ * @brief Construit un événement m.room.message
+ */
+static nlohmann::json MakeMessage(std::mt19937& rng, int roomIndex, int messageIndex, long long timestamp)
+{
+    std::uniform_int_distribution<int> senderDist(0, 7);
+    int sender = senderDist(rng);
+
+    nlohmann::json event;
+    event["type"] = "m.room.message";
+    event["event_id"] = "$r" + std::to_string(roomIndex) + "m" + std::to_string(messageIndex);
+    event["sender"] = (sender == 0) ? std::string(BENCH_USER)
+                                    : "@chat" + std::to_string(sender) + ":localhost";
+    event["origin_server_ts"] = timestamp;
+    event["content"] = { { "msgtype", "m.text" }, { "body", MakeBody(rng) } };
+    return event;
+}
+
+/**
+ * @brief Génère la synchronisation initiale puis des réponses incrémentales
+ *
+ * Contenu déterministe (graine fixe) pour que deux exécutions soient comparables.
+ */
+static std::vector<std::string> BuildSyncResponses(int roomCount, int messagesPerRoom)
+{
+    std::mt19937 rng(1234);
+    std::vector<std::string> responses;
+    const long long baseTimestamp = 1767225600000LL;    // 01/01/2026
+    std::vector<int> messageCounts(roomCount, messagesPerRoom);
+
+    // Synchronisation initiale : tous les salons avec leur historique
+    nlohmann::json initial;
+    initial["next_batch"] = "s0";
+    for (int r = 0; r < roomCount; ++r)
+    {
+        const std::string roomId = "!room" + std::to_string(r) + ":localhost";
+        nlohmann::json& room = initial["rooms"]["join"][roomId];
+
+        room["state"]["events"] = nlohmann::json::array({
+            { { "type", "m.room.name" }, { "state_key", "" },
+              { "content", { { "name", "Salon des chats " + std::to_string(r) } } } },
+            { { "type", "m.room.canonical_alias" }, { "state_key", "" },
+              { "content", { { "alias", "#chats" + std::to_string(r) + ":localhost" } } } }
+        });
+
+        nlohmann::json& timeline = room["timeline"]["events"];
+        timeline = nlohmann::json::array();
+        for (int m = 0; m < messagesPerRoom; ++m)
+        {
+            long long timestamp = baseTimestamp + (static_cast<long long>(r) * messagesPerRoom + m) * 1000;
+            timeline.push_back(MakeMessage(rng, r, m, timestamp));
+        }
+
+        room["unread_notifications"] = { { "notification_count", r % 7 }, { "highlight_count", r % 13 == 0 ? 1 : 0 } };
+
+        if (r % 10 == 0)
+        {
+            room["account_data"]["events"] = nlohmann::json::array({
+                { { "type", "m.tag" }, { "content", { { "tags", { { "m.favourite", nlohmann::json::object() } } } } } }
+            });
+        }
+    }
+    responses.push_back(initial.dump());
+
+    // Synchronisations incrémentales : quelques messages dans des salons au hasard
+    std::uniform_int_distribution<int> roomDist(0, roomCount - 1);
+    long long timestamp = baseTimestamp + static_cast<long long>(roomCount) * messagesPerRoom * 1000;
+    for (int s = 1; s <= INCREMENTAL_SYNCS; ++s)
+    {
+        nlohmann::json sync;
+        sync["next_batch"] = "s" + std::to_string(s);
+        for (int i = 0; i < 5; ++i)
+        {
+            int r = roomDist(rng);
+            const std::string roomId = "!room" + std::to_string(r) + ":localhost";
+            nlohmann::json& timeline = sync["rooms"]["join"][roomId]["timeline"]["events"];
+            if (!timeline.is_array())
+                timeline = nlohmann::json::array();
+            timeline.push_back(MakeMessage(rng, r, messageCounts[r]++, timestamp += 1000));
+        }
+        responses.push_back(sync.dump());
+    }
+
+    return responses;
+}
+
+/**
+ * @brief Ajoute des GIFs générés (frames déjà décodées) au gestionnaire de textures
+ *
+ * Tailles variées (96 à 256 px) et 24 à 72 frames, comme des GIFs de chats
+ * typiques : une première frame pleine, puis des frames qui ne redessinent
+ * qu'un rectangle (un quart de côté) qui se déplace. Une palette de 256
+ * couleurs par GIF, partagée par toutes ses frames.
+ */
+static void LoadSyntheticGifs(TextureManager& textures, int gifCount, std::vector<ImageHandle>& gifs)
+{
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> sizeDist(96, 256);
+    std::uniform_int_distribution<int> frameDist(24, 72);
+
+    for (int g = 0; g < gifCount; ++g)
+    {
+        IndexedGif gif;
+        gif.width = sizeDist(rng);
+        gif.height = sizeDist(rng);
+        const int frameCount = frameDist(rng);
+
+        std::vector<uint32_t> palette(256);
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            palette[i] = i | ((i + g * 16) & 0xFF) << 8 | (255 - i) << 16 | 0xFF000000u;
+        }
+        gif.palettes.push_back(std::move(palette));
+
+        gif.frames.resize(frameCount);
+        for (int f = 0; f < frameCount; ++f)
+        {
+            IndexedFrame& frame = gif.frames[f];
+            frame.delay = 40;
+            if (f == 0)
+            {
+                frame.rect = { 0, 0, gif.width, gif.height };
+            }
+            else
+            {
+                frame.rect.width = gif.width / 4;
+                frame.rect.height = gif.height / 4;
+                frame.rect.x = (f * 7) % (gif.width - frame.rect.width);
+                frame.rect.y = (f * 5) % (gif.height - frame.rect.height);
+            }
+
+            frame.indices.resize(static_cast<size_t>(frame.rect.width) * frame.rect.height);
+            size_t offset = 0;
+            for (int y = 0; y < frame.rect.height; ++y)
+            {
+                for (int x = 0; x < frame.rect.width; ++x)
+                {
+                    frame.indices[offset++] = static_cast<uint8_t>((x + f * 4) ^ (y + g * 16));
+                }
+            }
+        }
+        gifs.push_back(textures.LoadDecodedGif("bench_gif_" + std::to_string(g), std::move(gif)));
+    }
+}
+
+/**
+ * @brief Décode les .gif d'un dossier (corpus de GIFs réels)
+ * @return Nombre de GIFs décodés
+ */
+static int LoadGifDirectory(TextureManager& textures, const char* directory, std::vector<ImageHandle>& gifs)
+{
+    std::error_code error;
+    int loaded = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".gif")
+            continue;
+
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        ImageHandle gif = textures.LoadGifFromMemory(data.data(), data.size(), entry.path().filename().string());
+        if (gif.IsValid())
+        {
+            gifs.push_back(gif);
+            ++loaded;
+        }
+        else
+            fprintf(stderr, "GIF illisible : %s\n", entry.path().string().c_str());
+    }
+    if (error)
+        fprintf(stderr, "Impossible de lire %s\n", directory);
+    return loaded;
+}
+
+/**
+ * @brief Entrées scriptées d'une frame
+ *
+ * La souris décrit une courbe de Lissajous sur toute la fenêtre (survols,
+ * yeux du chat...), la molette défile par à-coups et le salon actif change
+ * à intervalle fixe, dans l'ordre d'affichage.
+ */
+static void ScriptInput(int frame, MatrixClient& client)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    float t = static_cast<float>(frame);
+    io.AddMousePosEvent(DISPLAY_WIDTH * (0.5f + 0.45f * std::sin(t * 0.031f)),
+                        DISPLAY_HEIGHT * (0.5f + 0.45f * std::sin(t * 0.047f)));
+
+    int phase = frame % ROOM_SWITCH_FRAMES;
+    if (phase >= ROOM_SWITCH_FRAMES / 2 && phase % 4 == 0)
+    {
+        io.AddMouseWheelEvent(0.0f, (phase < ROOM_SWITCH_FRAMES * 3 / 4) ? 1.0f : -1.0f);
+    }
+
+    if (phase == 0)
+    {
+        const RoomList& order = client.GetRoomOrder();
+        if (order.Size() > 0)
+        {
+            size_t target = static_cast<size_t>(frame / ROOM_SWITCH_FRAMES) % order.Size();
+            auto it = order.begin();
+            for (size_t i = 0; i < target; ++i)
+                ++it;
+            client.SelectRoom(client.GetRooms()[*it].id);
+        }
+    }
+}
+
+/**
+ * @brief Valeur au centile p (0-1) d'une série
+ */
+template<typename T>
+static T Percentile(std::vector<T> values, double p)
+{
+    if (values.empty())
+        return T();
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+/**
+ * @brief Affiche une ligne du résumé (p50, p99, max)
+ */
+template<typename T, typename Field>
+static void PrintRow(const char* label, const std::vector<FrameStats>& frames, Field field, const char* format)
+{
+    std::vector<T> values;
+    values.reserve(frames.size());
+    for (const FrameStats& frame : frames)
+        values.push_back(field(frame));
+
+    char p50[32], p99[32], max[32];
+    snprintf(p50, sizeof(p50), format, Percentile(values, 0.50));
+    snprintf(p99, sizeof(p99), format, Percentile(values, 0.99));
+    snprintf(max, sizeof(max), format, Percentile(values, 1.0));
+    printf("%-22s %12s %12s %12s\n", label, p50, p99, max);
+}
+
+/**
+ * @brief Micro-banc de DownscaleBox (SIMD) contre sa version scalaire
+ *
+ * Réductions typiques d'un GIF vers sa taille d'affichage, sur une image
+ * aléatoire dont un quart des pixels est transparent.
+ * @return 1 si les deux versions ne donnent pas les mêmes octets
+ */
+static int RunResampleBench()
+{
+    static const int CASES[][4] = {
+        { 480, 480, 120, 120 },
+        { 500, 281, 160, 90 },
+        { 256, 256, 200, 200 },
+        { 1000, 700, 100, 70 },
+    };
+    static const int ITERATIONS = 200;
+
+    std::mt19937 rng(7);
+    int failures = 0;
+    printf("%-22s %12s %12s %10s\n", "reduction", "SIMD ms", "scalaire ms", "Mpx/s");
+    for (const auto& sizes : CASES)
+    {
+        const int srcWidth = sizes[0], srcHeight = sizes[1], dstWidth = sizes[2], dstHeight = sizes[3];
+        std::vector<uint8_t> source(static_cast<size_t>(srcWidth) * srcHeight * 4);
+        for (size_t i = 0; i < source.size(); ++i)
+            source[i] = static_cast<uint8_t>(rng());
+        for (size_t i = 3; i < source.size(); i += 16)
+            source[i] = 0;
+
+        std::vector<uint8_t> simd(static_cast<size_t>(dstWidth) * dstHeight * 4);
+        std::vector<uint8_t> scalar(simd.size());
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i)
+            DownscaleBox(source.data(), srcWidth, srcHeight, srcWidth * 4, dstWidth, dstHeight,
+                         0, 0, dstWidth, dstHeight, simd.data(), dstWidth * 4);
+        auto middle = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i)
+            DownscaleBoxScalar(source.data(), srcWidth, srcHeight, srcWidth * 4, dstWidth, dstHeight,
+                               0, 0, dstWidth, dstHeight, scalar.data(), dstWidth * 4);
+        auto end = std::chrono::steady_clock::now();
+
+        const double simdMs = std::chrono::duration<double, std::milli>(middle - start).count() / ITERATIONS;
+        const double scalarMs = std::chrono::duration<double, std::milli>(end - middle).count() / ITERATIONS;
+        char label[32];
+        snprintf(label, sizeof(label), "%dx%d -> %dx%d", srcWidth, srcHeight, dstWidth, dstHeight);
+        printf("%-22s %12.3f %12.3f %10.0f%s\n", label, simdMs, scalarMs,
+               srcWidth * static_cast<double>(srcHeight) / (simdMs * 1000.0),
+               simd == scalar ? "" : "  DIFFERENT");
+        if (simd != scalar)
+            ++failures;
+    }
+    return failures ? 1 : 0;
+}
+
+/**
+ * @brief Débit de décodage des PNG et JPEG d'un dossier
+ *
+ * Chaque fichier est d'abord décodé sur le thread courant (débit par
+ * format), puis tout le dossier est chargé par LoadImageFromMemory :
+ * décodage sur les threads de travail et rangement dans l'atlas par
+ * Update(), jusqu'à ce que la dernière image soit rangée.
+ * @return 1 si aucun fichier n'a pu être décodé
+ */
+static int RunImageBench(const char* directory)
+{
+    struct FormatStats
+    {
+        const char* name;
+        int files;
+        int failures;
+        size_t bytes;
+        double pixels;
+        double ms;
+    };
+    FormatStats formats[2] = { { "PNG", 0, 0, 0, 0.0, 0.0 }, { "JPEG", 0, 0, 0, 0.0, 0.0 } };
+
+    std::vector<std::pair<std::string, std::vector<unsigned char>>> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(
+             directory, std::filesystem::directory_options::skip_permission_denied, error))
+    {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (!entry.is_regular_file() || (extension != ".png" && extension != ".jpg" && extension != ".jpeg"))
+            continue;
+
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const bool png = IsPng(data.data(), data.size());
+        if (!png && !IsJpeg(data.data(), data.size()))
+            continue;
+
+        FormatStats& stats = formats[png ? 0 : 1];
+        std::vector<uint8_t> pixels;
+        int width = 0, height = 0;
+        auto start = std::chrono::steady_clock::now();
+        const bool decoded = png ? DecodePng(data.data(), data.size(), pixels, width, height)
+                                 : DecodeJpeg(data.data(), data.size(), pixels, width, height);
+        stats.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!decoded)
+        {
+            ++stats.failures;
+            fprintf(stderr, "Image illisible : %s\n", entry.path().string().c_str());
+            continue;
+        }
+        ++stats.files;
+        stats.bytes += data.size();
+        stats.pixels += static_cast<double>(width) * height;
+        files.emplace_back(entry.path().string(), std::move(data));
+    }
+    if (error)
+        fprintf(stderr, "Impossible de lire %s\n", directory);
+    if (files.empty())
+        return 1;
+
+    printf("%-8s %8s %8s %10s %10s %10s %10s\n", "format", "fichiers", "echecs", "Mo", "Mpx", "ms", "Mpx/s");
+    double totalPixels = 0.0;
+    for (const FormatStats& stats : formats)
+    {
+        totalPixels += stats.pixels;
+        printf("%-8s %8d %8d %10.1f %10.1f %10.1f %10.1f\n", stats.name, stats.files, stats.failures,
+               stats.bytes / (1024.0 * 1024.0), stats.pixels / 1e6, stats.ms,
+               stats.ms > 0.0 ? stats.pixels / (stats.ms * 1000.0) : 0.0);
+    }
+
+    // Même corpus par les threads de travail, sans éviction ni limite
+    // d'envoi par frame pendant la mesure
+    TextureManager textures(nullptr);
+    textures.SetBudgets(SIZE_MAX, SIZE_MAX);
+    textures.SetUploadBudget(0, 0.0);
+    std::vector<ImageHandle> handles;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& file : files)
+        handles.push_back(textures.LoadImageFromMemory(file.second.data(), static_cast<int>(file.second.size()),
+                                                       file.first));
+    // Chaque image rangée est aussitôt déchargée : la mémoire reste bornée
+    size_t loaded = 0;
+    while (loaded < handles.size())
+    {
+        textures.BeginFrame();
+        textures.Update();
+        for (ImageHandle& handle : handles)
+        {
+            if (handle.IsValid() && textures.IsLoaded(handle))
+            {
+                textures.Unload(handle);
+                handle = ImageHandle();
+                ++loaded;
+            }
+        }
+        if (loaded < handles.size())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double poolMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("TextureManager : %zu images en %.1f ms (%.1f Mpx/s, threads de travail + rangement dans l'atlas)\n",
+           handles.size(), poolMs, totalPixels / (poolMs * 1000.0));
+    return 0;
+}
+
+// Serveur simulé de --media-bench
+static const char MOCK_HOMESERVER[] = "https://mock.local";
+static const char MOCK_SERVER_NAME[] = "mock.local";
+static const char MOCK_TOKEN[] = "bench-token";
+
+/**
+ * @brief Ajoute un chunk PNG (longueur, type, données, CRC)
+ */
+static void AppendPngChunk(std::vector<unsigned char>& png, const char* type, const std::vector<unsigned char>& data)
+{
+    static uint32_t crcTable[256];
+    if (crcTable[1] == 0)
+    {
+        for (uint32_t n = 0; n < 256; ++n)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            crcTable[n] = c;
+        }
+    }
+
+    const uint32_t length = static_cast<uint32_t>(data.size());
+    for (int shift = 24; shift >= 0; shift -= 8)
+        png.push_back(static_cast<unsigned char>(length >> shift));
+    const size_t typeStart = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = typeStart; i < png.size(); ++i)
+        crc = crcTable[(crc ^ png[i]) & 0xFF] ^ (crc >> 8);
+    crc ^= 0xFFFFFFFFu;
+    for (int shift = 24; shift >= 0; shift -= 8)
+        png.push_back(static_cast<unsigned char>(crc >> shift));
+}
+
+/**
+ * @brief Encode une image RGBA en PNG non compressé (blocs DEFLATE stored)
+ */
+static std::vector<unsigned char> EncodeStoredPng(const std::vector<uint8_t>& rgba, int width, int height)
+{
+    std::vector<unsigned char> raw;
+    raw.reserve(static_cast<size_t>(width * 4 + 1) * height);
+    for (int y = 0; y < height; ++y)
+    {
+        raw.push_back(0); // Filtre None
+        raw.insert(raw.end(), rgba.begin() + static_cast<size_t>(y) * width * 4,
+                   rgba.begin() + static_cast<size_t>(y + 1) * width * 4);
+    }
+
+    std::vector<unsigned char> zlib = { 0x78, 0x01 };
+    for (size_t pos = 0; pos < raw.size(); pos += 65535)
+    {
+        const size_t length = std::min<size_t>(65535, raw.size() - pos);
+        zlib.push_back(pos + length == raw.size() ? 1 : 0);
+        zlib.push_back(static_cast<unsigned char>(length));
+        zlib.push_back(static_cast<unsigned char>(length >> 8));
+        zlib.push_back(static_cast<unsigned char>(~length));
+        zlib.push_back(static_cast<unsigned char>(~length >> 8));
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + length);
+    }
+    uint32_t a = 1, b = 0;
+    for (unsigned char byte : raw)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    const uint32_t adler = (b << 16) | a;
+    for (int shift = 24; shift >= 0; shift -= 8)
+        zlib.push_back(static_cast<unsigned char>(adler >> shift));
+
+    std::vector<unsigned char> header(13, 0);
+    for (int i = 0; i < 4; ++i)
+    {
+        header[i] = static_cast<unsigned char>(width >> (24 - 8 * i));
+        header[4 + i] = static_cast<unsigned char>(height >> (24 - 8 * i));
+    }
+    header[8] = 8;  // 8 bits par canal
+    header[9] = 6;  // RGBA
+
+    std::vector<unsigned char> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    AppendPngChunk(png, "IHDR", header);
+    AppendPngChunk(png, "IDAT", zlib);
+    AppendPngChunk(png, "IEND", std::vector<unsigned char>());
+    return png;
+}
+
+/**
+ * @class MockMediaServer
+ * @brief Points d'accès /_matrix/client/v1/media simulés pour --media-bench
+ *
+ * Répond comme un serveur Matrix : rien (401) sans le bon token, rien
+ * (404) pour un média inconnu ou une miniature impossible (médias dont
+ * l'identifiant commence par « nothumb »). Les miniatures ne sont jamais
+ * plus grandes que l'original ; elles sont calculées à la première
+ * demande puis gardées, comme sur un vrai serveur. Les fichiers sont des
+ * PNG non compressés : leur taille suit le nombre de pixels.
+ */
+class MockMediaServer
+{
+public:
+    std::atomic<uint64_t> requests{ 0 };    // Requêtes reçues
+    std::atomic<uint64_t> refused{ 0 };     // Requêtes sans réponse (401, 404)
+    std::atomic<uint64_t> bytes{ 0 };       // Octets envoyés
+
+    /**
+     * @brief Ajoute un média généré (dégradé propre à chaque graine)
+     */
+    void AddMedia(const std::string& mediaId, int width, int height, uint32_t seed)
+    {
+        Media& media = m_media[mediaId];
+        media.width = width;
+        media.height = height;
+        media.rgba.resize(static_cast<size_t>(width) * height * 4);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                uint8_t* pixel = &media.rgba[(static_cast<size_t>(y) * width + x) * 4];
+                pixel[0] = static_cast<uint8_t>(x * 255 / width + seed * 37);
+                pixel[1] = static_cast<uint8_t>(y * 255 / height + seed * 91);
+                pixel[2] = static_cast<uint8_t>((x ^ y) + seed * 13);
+                pixel[3] = 255;
+            }
+        }
+        media.file = EncodeStoredPng(media.rgba, width, height);
+    }
+
+    /**
+     * @brief Réponse à une requête (Downloader du TextureManager)
+     */
+    std::vector<unsigned char> Handle(const std::string& url, const std::string& authorization)
+    {
+        ++requests;
+        std::vector<unsigned char> response = Respond(url, authorization);
+        if (response.empty())
+            ++refused;
+        bytes += response.size();
+        return response;
+    }
+
+private:
+    struct Media
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> rgba;
+        std::vector<unsigned char> file;
+    };
+
+    std::map<std::string, Media> m_media;   // Fixé avant la première requête
+    std::mutex m_thumbnailMutex;
+    std::map<std::string, std::vector<unsigned char>> m_thumbnails; // URL -> fichier
+
+    std::vector<unsigned char> Respond(const std::string& url, const std::string& authorization)
+    {
+        if (authorization != std::string("Bearer ") + MOCK_TOKEN)
+            return {};
+
+        const std::string base = std::string(MOCK_HOMESERVER) + "/_matrix/client/v1/media/";
+        const std::string download = "download/" + std::string(MOCK_SERVER_NAME) + "/";
+        const std::string thumbnail = "thumbnail/" + std::string(MOCK_SERVER_NAME) + "/";
+        if (url.compare(0, base.size(), base) != 0)
+            return {};
+        const std::string path = url.substr(base.size());
+
+        if (path.compare(0, download.size(), download) == 0)
+        {
+            auto it = m_media.find(path.substr(download.size()));
+            return it != m_media.end() ? it->second.file : std::vector<unsigned char>();
+        }
+        if (path.compare(0, thumbnail.size(), thumbnail) != 0)
+            return {};
+
+        const size_t query = path.find('?');
+        auto it = m_media.find(path.substr(thumbnail.size(), query - thumbnail.size()));
+        if (it == m_media.end() || query == std::string::npos || it->first.compare(0, 7, "nothumb") == 0)
+            return {};
+
+        {
+            std::lock_guard<std::mutex> lock(m_thumbnailMutex);
+            auto cached = m_thumbnails.find(url);
+            if (cached != m_thumbnails.end())
+                return cached->second;
+        }
+        std::vector<unsigned char> file = MakeThumbnail(it->second, path.substr(query + 1));
+        std::lock_guard<std::mutex> lock(m_thumbnailMutex);
+        m_thumbnails[url] = file;
+        return file;
+    }
+
+    /**
+     * @brief Miniature selon les paramètres width, height et method
+     */
+    static std::vector<unsigned char> MakeThumbnail(const Media& media, const std::string& query)
+    {
+        int width = 0, height = 0;
+        bool crop = false;
+        size_t start = 0;
+        while (start < query.size())
+        {
+            size_t end = query.find('&', start);
+            if (end == std::string::npos)
+                end = query.size();
+            const std::string parameter = query.substr(start, end - start);
+            if (parameter.compare(0, 6, "width=") == 0)
+                width = atoi(parameter.c_str() + 6);
+            else if (parameter.compare(0, 7, "height=") == 0)
+                height = atoi(parameter.c_str() + 7);
+            else if (parameter == "method=crop")
+                crop = true;
+            start = end + 1;
+        }
+        if (width <= 0 || height <= 0)
+            return {};
+
+        // Zone de l'original utilisée (centrée, aux proportions demandées pour crop)
+        int srcWidth = media.width;
+        int srcHeight = media.height;
+        if (crop)
+        {
+            if (static_cast<int64_t>(srcWidth) * height > static_cast<int64_t>(srcHeight) * width)
+                srcWidth = std::max(1, static_cast<int>(static_cast<int64_t>(srcHeight) * width / height));
+            else
+                srcHeight = std::max(1, static_cast<int>(static_cast<int64_t>(srcWidth) * height / width));
+        }
+        const double scale = std::min(1.0, std::min(static_cast<double>(width) / srcWidth,
+                                                    static_cast<double>(height) / srcHeight));
+        const int dstWidth = std::max(1, std::min(srcWidth, static_cast<int>(srcWidth * scale + 0.5)));
+        const int dstHeight = std::max(1, std::min(srcHeight, static_cast<int>(srcHeight * scale + 0.5)));
+
+        const uint8_t* src = media.rgba.data()
+            + (static_cast<size_t>((media.height - srcHeight) / 2) * media.width + (media.width - srcWidth) / 2) * 4;
+        std::vector<uint8_t> pixels(static_cast<size_t>(dstWidth) * dstHeight * 4);
+        DownscaleBox(src, srcWidth, srcHeight, media.width * 4, dstWidth, dstHeight,
+                     0, 0, dstWidth, dstHeight, pixels.data(), dstWidth * 4);
+        return EncodeStoredPng(pixels, dstWidth, dstHeight);
+    }
+};
+
+/**
+ * @brief Charge les médias d'une timeline simulée via MediaFetcher
+ *
+ * Avatars en 32x32 recadrés et images des messages en 320x240, demandés à
+ * chaque frame comme le ferait l'interface, contre le même écran chargé
+ * avec les fichiers d'origine. Un serveur simulé (MockMediaServer) répond
+ * aux requêtes ; deux images n'ont pas de miniature (repli sur l'original)
+ * et une URI mxc:// est invalide.
+ * @return 1 si une image n'a pas pu être chargée, ou est plus grande que
+ *         son widget
+ */
+static int RunMediaBench()
+{
+    static const int AVATARS = 12;
+    static const int PHOTOS = 10;
+    static const int MESSAGES = 200;
+
+    MockMediaServer server;
+    for (int i = 0; i < AVATARS; ++i)
+        server.AddMedia("avatar" + std::to_string(i), 512, 512, i);
+    for (int i = 0; i < PHOTOS; ++i)
+        server.AddMedia((i < PHOTOS - 2 ? "photo" : "nothumb") + std::to_string(i), 1280, 960, 100 + i);
+
+    struct Widget
+    {
+        std::string uri;
+        int width;
+        int height;
+        ThumbnailMethod method;
+    };
+    const std::string prefix = std::string("mxc://") + MOCK_SERVER_NAME + "/";
+    std::vector<Widget> widgets;
+    for (int i = 0; i < MESSAGES; ++i)
+    {
+        widgets.push_back({ prefix + "avatar" + std::to_string(i % AVATARS), 32, 32, ThumbnailMethod::Crop });
+        if (i % 5 == 0)
+        {
+            const int photo = (i / 5) % PHOTOS;
+            widgets.push_back({ prefix + (photo < PHOTOS - 2 ? "photo" : "nothumb") + std::to_string(photo),
+                                320, 240, ThumbnailMethod::Scale });
+        }
+    }
+    widgets.push_back({ prefix + "../../admin", 32, 32, ThumbnailMethod::Crop });
+
+    printf("%-12s %8s %8s %8s %10s %10s %10s\n", "medias", "images", "requetes", "refus", "Mo", "Mpx", "ms");
+    int result = 0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        const bool thumbnails = pass == 0;
+        server.requests = 0;
+        server.refused = 0;
+        server.bytes = 0;
+
+        TextureManager textures(nullptr);
+        textures.SetBudgets(SIZE_MAX, SIZE_MAX);
+        textures.SetDownloader([&server](const std::string& url, const std::string& authorization)
+        {
+            return server.Handle(url, authorization);
+        });
+        MediaFetcher fetcher(&textures);
+        fetcher.SetServer(std::string(MOCK_HOMESERVER) + "/", MOCK_TOKEN);
+
+        // Une frame : chaque widget demande son image et la dessine si elle est prête
+        std::vector<ImageHandle> handles(widgets.size());
+        size_t pending = widgets.size();
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::seconds(30);
+        while (pending > 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            textures.BeginFrame();
+            pending = 0;
+            for (size_t i = 0; i < widgets.size(); ++i)
+            {
+                const Widget& widget = widgets[i];
+                handles[i] = fetcher.Request(widget.uri, thumbnails ? widget.width : 0,
+                                             thumbnails ? widget.height : 0, widget.method);
+                if (handles[i].IsValid() && !textures.IsLoaded(handles[i]))
+                    ++pending;
+                else
+                    textures.GetImage(handles[i]);
+            }
+            textures.Update();
+            if (pending > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // Pixels décodés (taille des fichiers reçus) et taille dans l'atlas
+        std::vector<ImageHandle> distinct;
+        double pixels = 0.0;
+        for (size_t i = 0; i < widgets.size(); ++i)
+        {
+            if (!handles[i].IsValid() || std::find(distinct.begin(), distinct.end(), handles[i]) != distinct.end())
+                continue;
+            distinct.push_back(handles[i]);
+            int width = 0, height = 0;
+            if (!textures.IsLoaded(handles[i]) || !textures.GetGifSize(handles[i], width, height))
+            {
+                fprintf(stderr, "Média non chargé : %s\n", widgets[i].uri.c_str());
+                result = 1;
+                continue;
+            }
+            pixels += static_cast<double>(width) * height;
+
+            const TextureRegion region = textures.GetImage(handles[i]);
+            if (thumbnails && (region.width > widgets[i].width || region.height > widgets[i].height))
+            {
+                fprintf(stderr, "%s : %dx%d dans l'atlas pour un widget de %dx%d\n", widgets[i].uri.c_str(),
+                        region.width, region.height, widgets[i].width, widgets[i].height);
+                result = 1;
+            }
+        }
+
+        printf("%-12s %8zu %8llu %8llu %10.1f %10.1f %10.1f\n", thumbnails ? "miniatures" : "originaux",
+               distinct.size(), static_cast<unsigned long long>(server.requests.load()),
+               static_cast<unsigned long long>(server.refused.load()),
+               server.bytes.load() / (1024.0 * 1024.0), pixels / 1e6, ms);
+        if (thumbnails)
+        {
+            const MediaFetcher::Stats& stats = fetcher.GetStats();
+            printf("MediaFetcher : %llu demandes, %llu regroupées, %llu téléchargements, %llu URI invalides\n",
+                   static_cast<unsigned long long>(stats.requests), static_cast<unsigned long long>(stats.coalesced),
+                   static_cast<unsigned long long>(stats.downloads), static_cast<unsigned long long>(stats.invalid));
+        }
+    }
+    return result;
+}
+
+/**
+ * @class MutexDeltaQueue
+ * @brief File des mises à jour protégée par un mutex (ancien chemin)
+ *
+ * Même interface et même capacité que SpscQueue : chaque ajout et chaque
+ * retrait prend le verrou partagé par les deux threads.
+ */
+class MutexDeltaQueue
+{
+public:
+    explicit MutexDeltaQueue(size_t capacity) : m_capacity(capacity) {}
+
+    bool TryPush(RoomDelta&& delta)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_items.size() >= m_capacity)
+            return false;
+        m_items.push_back(std::move(delta));
+        return true;
+    }
+
+    bool TryPop(RoomDelta& delta)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_items.empty())
+            return false;
+        delta = std::move(m_items.front());
+        m_items.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<RoomDelta> m_items;
+    size_t m_capacity;
+};
+
+/**
+ * @brief Fait passer count mises à jour d'un thread producteur au thread courant
+ *
+ * Le consommateur vide la file par frames d'au plus DRAIN_PER_FRAME
+ * éléments, comme PumpEvents ; seules les frames qui ont reçu quelque chose
+ * sont chronométrées.
+ */
+template <typename Queue>
+static void MeasureDeltaQueue(const char* label, Queue& queue, const RoomDelta& sample, int count)
+{
+    static const int DRAIN_PER_FRAME = 64;
+
+    std::atomic<uint64_t> producerWaits{ 0 };
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]()
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            RoomDelta delta = sample;
+            delta.value = std::to_string(i);
+            while (!queue.TryPush(std::move(delta)))
+            {
+                producerWaits.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<double> frameUs;
+    size_t received = 0;
+    size_t messages = 0;
+    RoomDelta delta;
+    while (received < static_cast<size_t>(count))
+    {
+        auto frameStart = std::chrono::steady_clock::now();
+        int drained = 0;
+        while (drained < DRAIN_PER_FRAME && queue.TryPop(delta))
+        {
+            messages += delta.messages.size();
+            ++drained;
+        }
+        if (drained == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        frameUs.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count());
+        received += drained;
+    }
+    producer.join();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%-8s %10.1f %12.2f %10.2f %10.2f %10.2f %12llu\n", label, ms, count / (ms * 1000.0),
+           Percentile(frameUs, 0.50), Percentile(frameUs, 0.99), Percentile(frameUs, 1.0),
+           static_cast<unsigned long long>(producerWaits.load()));
+    if (messages != sample.messages.size() * count)
+        printf("%-8s messages perdus : %zu reçus sur %zu\n", label, messages, sample.messages.size() * count);
+}
+
+/**
+ * @brief Micro-banc de la file des mises à jour de sync : SpscQueue contre mutex
+ *
+ * Un thread joue la synchronisation et envoie des RoomDelta de quatre
+ * messages ; le thread courant joue le rendu et les retire. Les deux files
+ * ont la capacité de celle du MatrixClient (1024). Affiche la durée totale,
+ * le débit, le temps passé par frame à vider la file (p50, p99, max, en µs)
+ * et le nombre de fois où le producteur a trouvé la file pleine.
+ */
+static int RunQueueBench()
+{
+    static const int DELTAS = 200000;
+    static const size_t CAPACITY = 1024;
+
+    RoomDelta sample;
+    sample.type = RoomDeltaType::Messages;
+    sample.roomId = "!bench:localhost";
+    for (int i = 0; i < 4; ++i)
+    {
+        Message& message = sample.messages.emplace_back();
+        message.id = "$event" + std::to_string(i) + ":localhost";
+        message.sender = BENCH_USER;
+        message.senderName = "bench";
+        message.bodyLength = 48;
+        message.bodyInPayload = true;
+    }
+
+    printf("%-8s %10s %12s %10s %10s %10s %12s\n", "file", "ms", "Mdeltas/s", "p50 us", "p99 us", "max us", "file pleine");
+    for (int run = 0; run < 2; ++run)
+    {
+        SpscQueue<RoomDelta> spsc(CAPACITY);
+        MeasureDeltaQueue("spsc", spsc, sample, DELTAS);
+        MutexDeltaQueue locked(CAPACITY);
+        MeasureDeltaQueue("mutex", locked, sample, DELTAS);
+    }
+    return 0;
+}
+
+/**
+ * @struct LegacyMessage
+ * @brief Message tel que les salons le stockaient avant le TimelineStore
+ */
+struct LegacyMessage
+{
+    std::string id;
+    std::string sender;
+    std::string senderName;
+    std::string content;
+    std::string timestamp;  // Heure déjà formatée ("HH:MM")
+    bool isOwn;
+};
+
+/**
+ * @brief Octets alloués pour une chaîne hors de son objet (0 si en ligne)
+ */
+static size_t StringHeapBytes(const std::string& text)
+{
+    static const size_t inlineCapacity = std::string().capacity();
+    return text.capacity() > inlineCapacity ? text.capacity() + 1 : 0;
+}
+
+/**
+ * @brief Micro-banc du stockage des timelines : TimelineStore contre std::vector<Message>
+ *
+ * La même timeline (8 expéditeurs, corps de MakeBody) est rangée dans
+ * l'ancien tableau de structures de chaînes, dans un TimelineStore dont les
+ * corps sont dans l'arène, et dans un TimelineStore dont les corps restent
+ * dans la réponse de sync (chemin de la synchronisation avant compactage).
+ * Affiche les octets par message et le débit d'une recherche sans
+ * résultat (tous les corps lus).
+ * @return 1 si les trois stockages ne trouvent pas le même message
+ */
+static int RunTimelineBench()
+{
+    static const int MESSAGES = 100000;
+    static const int SCANS = 20;
+    static const char* NEEDLE = "chien";    // Absent de MakeBody : parcours complet
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> senderDist(0, 7);
+    std::vector<LegacyMessage> legacy;
+    TimelineStore arena;
+    TimelineStore retained;
+    auto payload = std::make_shared<PayloadChunk>();
+    payload->serial = 1;
+
+    std::vector<std::string> bodies;
+    bodies.reserve(MESSAGES);
+    size_t bodyBytes = 0;
+    for (int i = 0; i < MESSAGES; ++i)
+    {
+        bodies.push_back(MakeBody(rng));
+        bodyBytes += bodies.back().size();
+        payload->data += "\"" + bodies.back() + "\",";
+    }
+
+    size_t payloadOffset = 0;
+    for (int i = 0; i < MESSAGES; ++i)
+    {
+        const int sender = senderDist(rng);
+        const std::string senderId = sender == 0 ? std::string(BENCH_USER) : "@chat" + std::to_string(sender) + ":localhost";
+        const std::string senderName = senderId.substr(1, senderId.find(':') - 1);
+        const std::string id = "$r0m" + std::to_string(i);
+        const long long timestamp = 1700000000000LL + i * 1000LL;
+
+        legacy.push_back({ id, senderId, senderName, bodies[i], "12:34", sender == 0 });
+        arena.Append(id, senderId, senderName, bodies[i], timestamp, sender == 0);
+        retained.AppendRetained(id, senderId, senderName, payload, static_cast<uint32_t>(payloadOffset + 1),
+                                static_cast<uint32_t>(bodies[i].size()), timestamp, sender == 0);
+        payloadOffset += bodies[i].size() + 3;
+    }
+
+    size_t legacyBytes = legacy.capacity() * sizeof(LegacyMessage);
+    for (const LegacyMessage& message : legacy)
+    {
+        legacyBytes += StringHeapBytes(message.id) + StringHeapBytes(message.sender)
+                     + StringHeapBytes(message.senderName) + StringHeapBytes(message.content)
+                     + StringHeapBytes(message.timestamp);
+    }
+
+    auto legacyFind = [&legacy](std::string_view needle)
+    {
+        for (size_t i = 0; i < legacy.size(); ++i)
+        {
+            if (legacy[i].content.find(needle) != std::string::npos)
+                return i;
+        }
+        return legacy.size();
+    };
+
+    printf("%d messages, corps moyen %.1f octets\n", MESSAGES, bodyBytes / static_cast<double>(MESSAGES));
+    printf("%-26s %12s %12s %12s\n", "stockage", "octets/msg", "ns/msg", "Mo/s");
+    auto measure = [&](const char* label, size_t bytes, auto find)
+    {
+        size_t found = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int scan = 0; scan < SCANS; ++scan)
+            found += find(NEEDLE);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%-26s %12.1f %12.2f %12.0f\n", label, bytes / static_cast<double>(MESSAGES),
+               seconds * 1e9 / (static_cast<double>(SCANS) * MESSAGES),
+               bodyBytes * static_cast<double>(SCANS) / (seconds * 1024.0 * 1024.0));
+        return found / SCANS;
+    };
+    const size_t legacyFound = measure("std::vector<Message>", legacyBytes, legacyFind);
+    const size_t arenaFound = measure("TimelineStore (arene)", arena.BytesUsed(),
+                                      [&arena](std::string_view needle) { return arena.Find(needle); });
+    const size_t retainedFound = measure("TimelineStore (retenu)", retained.BytesUsed(),
+                                         [&retained](std::string_view needle) { return retained.Find(needle); });
+    printf("(réponse de sync retenue non comptée : %.1f octets/msg, partagée entre les salons du lot)\n",
+           payload->data.size() / static_cast<double>(MESSAGES));
+
+    // Un corps présent, pour vérifier que les trois parcours s'accordent
+    const std::string needle = bodies[MESSAGES * 3 / 4];
+    const size_t expected = legacyFind(needle);
+    if (legacyFound != arenaFound || legacyFound != retainedFound ||
+        arena.Find(needle) != expected || retained.Find(needle) != expected)
+    {
+        printf("Résultats différents\n");
+        return 1;
+    }
+    return 0;
+}
+
+// DOM des réponses de sync tel que MatrixClient le construit : noeuds,
+// tableaux, objets et chaînes alloués dans une BatchArena
+using ArenaJson = nlohmann::basic_json<std::map, std::vector,
+                                       std::basic_string<char, std::char_traits<char>, BatchAllocator<char>>,
+                                       bool, std::int64_t, std::uint64_t, double, BatchAllocator>;
+
+/**
+ * @brief Nombre d'événements d'une réponse de sync (toutes sections)
+ */
+static size_t CountSyncEvents(const nlohmann::json& sync)
+{
+    static const char* SECTIONS[] = { "state", "timeline", "ephemeral", "account_data" };
+
+    auto rooms = sync.find("rooms");
+    if (rooms == sync.end() || !rooms->contains("join"))
+        return 0;
+
+    size_t count = 0;
+    for (const auto& room : (*rooms)["join"])
+    {
+        for (const char* section : SECTIONS)
+        {
+            auto part = room.find(section);
+            if (part != room.end() && part->contains("events"))
+                count += (*part)["events"].size();
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Micro-banc des allocations du parsing des réponses de sync
+ *
+ * Chaque réponse générée (synchronisation initiale puis réponses
+ * incrémentales) est parsée deux fois : en nlohmann::json, alloué par
+ * operator new comme avant l'arène, puis dans une BatchArena remise à zéro
+ * après chaque lot comme dans ProcessSyncResponse. Affiche les appels à
+ * operator new par événement, les allocations servies par l'arène, le
+ * temps de parsing et la mémoire que l'arène garde entre deux lots.
+ */
+static int RunArenaBench(int roomCount, int messagesPerRoom)
+{
+    const std::vector<std::string> responses = BuildSyncResponses(roomCount, messagesPerRoom);
+    BatchArena arena;
+
+    printf("%-8s %10s %12s %12s %10s %6s %10s %10s %12s\n", "lot", "evenements", "new/evt json",
+           "new/evt arene", "arene/evt", "blocs", "ms json", "ms arene", "garde Ko");
+    for (size_t i = 0; i < responses.size(); ++i)
+    {
+        size_t allocations = t_allocations;
+        auto start = std::chrono::steady_clock::now();
+        size_t events = 0;
+        {
+            nlohmann::json dom = nlohmann::json::parse(responses[i]);
+            events = CountSyncEvents(dom);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        const size_t legacyAllocations = t_allocations - allocations;
+
+        allocations = t_allocations;
+        size_t arenaAllocations = 0;
+        size_t blocks = 0;
+        {
+            BatchArena::Scope scope(arena);
+            {
+                ArenaJson dom = ArenaJson::parse(responses[i]);
+            }
+            arenaAllocations = arena.AllocationCount();
+            blocks = arena.BlockCount();
+            arena.Reset();
+        }
+        auto end = std::chrono::steady_clock::now();
+        const size_t arenaNew = t_allocations - allocations;
+
+        const double perEvent = events ? 1.0 / events : 0.0;
+        printf("%-8s %10zu %12.2f %12.2f %10.2f %6zu %10.3f %10.3f %12.1f\n",
+               i == 0 ? "initial" : ("+" + std::to_string(i)).c_str(), events,
+               legacyAllocations * perEvent, arenaNew * perEvent, arenaAllocations * perEvent, blocks,
+               std::chrono::duration<double, std::milli>(middle - start).count(),
+               std::chrono::duration<double, std::milli>(end - middle).count(),
+               arena.ReservedBytes() / 1024.0);
+    }
+    return 0;
+}
+
+/**
+ * @brief Micro-banc de l'ordre des salons : RoomList contre tri complet
+ *
+ * Des changements tirés au hasard (nouveau message, salon lu, favori
+ * ajouté ou retiré) sont appliqués à roomCount salons ; chaque changement
+ * met à jour la RoomList, puis retrie entièrement un tableau d'index comme
+ * le ferait une liste sans arbre. Affiche le coût d'un changement (p50,
+ * p99, max, en µs) pour les deux.
+ * @return 1 si les deux ordres diffèrent à la fin
+ */
+static int RunRoomOrderBench(int roomCount)
+{
+    static const int UPDATES = 5000;
+
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> roomDist(0, roomCount - 1);
+    std::uniform_int_distribution<int> eventDist(0, 9);
+    long long now = 1767225600000LL;
+
+    std::vector<RoomList::Key> keys(roomCount);
+    std::vector<uint32_t> sorted(roomCount);
+    RoomList list;
+    for (int r = 0; r < roomCount; ++r)
+    {
+        keys[r].index = static_cast<uint32_t>(r);
+        keys[r].favourite = r % 50 == 0;
+        keys[r].unread = r % 7 == 0;
+        keys[r].lastActivity = now - r * 1000LL;
+        list.Update(keys[r]);
+        sorted[r] = static_cast<uint32_t>(r);
+    }
+    auto byKey = [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; };
+    std::sort(sorted.begin(), sorted.end(), byKey);
+
+    std::vector<double> incrementalUs;
+    std::vector<double> resortUs;
+    incrementalUs.reserve(UPDATES);
+    resortUs.reserve(UPDATES);
+    for (int i = 0; i < UPDATES; ++i)
+    {
+        RoomList::Key& key = keys[roomDist(rng)];
+        const int event = eventDist(rng);
+        if (event < 7)
+        {
+            key.lastActivity = (now += 1000);
+            key.unread = true;
+        }
+        else if (event < 9)
+        {
+            key.unread = false;
+        }
+        else
+        {
+            key.favourite = !key.favourite;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        list.Update(key);
+        auto middle = std::chrono::steady_clock::now();
+        std::sort(sorted.begin(), sorted.end(), byKey);
+        auto end = std::chrono::steady_clock::now();
+        incrementalUs.push_back(std::chrono::duration<double, std::micro>(middle - start).count());
+        resortUs.push_back(std::chrono::duration<double, std::micro>(end - middle).count());
+    }
+
+    printf("%d salons, %d changements\n", roomCount, UPDATES);
+    printf("%-22s %12s %12s %12s\n", "ordre", "p50 us", "p99 us", "max us");
+    printf("%-22s %12.3f %12.3f %12.3f\n", "RoomList", Percentile(incrementalUs, 0.50),
+           Percentile(incrementalUs, 0.99), Percentile(incrementalUs, 1.0));
+    printf("%-22s %12.3f %12.3f %12.3f\n", "tri complet", Percentile(resortUs, 0.50),
+           Percentile(resortUs, 0.99), Percentile(resortUs, 1.0));
+
+    std::vector<uint32_t> ordered;
+    ordered.reserve(list.Size());
+    for (uint32_t index : list)
+        ordered.push_back(index);
+    if (ordered != sorted)
+    {
+        printf("Ordres différents\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Filtre sans index : minuscules et sous-séquence recalculées à chaque frappe
+ */
+static bool NaiveRoomMatch(const std::string& query, const std::string& name, const std::string& alias)
+{
+    for (const std::string* text : { &name, &alias })
+    {
+        size_t q = 0;
+        for (char c : *text)
+        {
+            const char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (q < query.size() && lower == query[q])
+                ++q;
+        }
+        if (q == query.size())
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Micro-banc du filtre des salons : latence par frappe
+ *
+ * Des requêtes sont tapées puis effacées caractère par caractère sur
+ * roomCount salons. Pour chaque frappe, le filtre indexé (RoomFilter::
+ * SetQuery puis liste visible dans l'ordre de la RoomList, comme
+ * ChatWindow::UpdateRoomList) est comparé à un filtre sans index qui
+ * re-teste tous les salons. Affiche la latence par frappe (p50, p99, max,
+ * en µs).
+ * @return 1 si les deux filtres ne retiennent pas les mêmes salons
+ */
+static int RunFilterBench(int roomCount)
+{
+    static const char* TYPED[] = { "moustache", "sal42", "#croq", "gnrl" };
+
+    std::mt19937 rng(9);
+    std::vector<std::string> names(roomCount);
+    std::vector<std::string> aliases(roomCount);
+    RoomList order;
+    RoomFilter filter;
+    for (int r = 0; r < roomCount; ++r)
+    {
+        std::string word = MakeBody(rng);
+        word = word.substr(0, word.find_first_of(" \n"));
+        names[r] = "Salon " + std::to_string(r) + " " + word;
+        aliases[r] = "#" + word + std::to_string(r) + ":localhost";
+        filter.UpdateRoom(static_cast<uint32_t>(r), names[r], aliases[r]);
+
+        RoomList::Key key;
+        key.index = static_cast<uint32_t>(r);
+        key.lastActivity = r;
+        order.Update(key);
+    }
+
+    // Frappes successives : chaque requête est tapée puis effacée
+    std::vector<std::string> keystrokes;
+    for (const char* typed : TYPED)
+    {
+        const std::string query(typed);
+        for (size_t length = 1; length <= query.size(); ++length)
+            keystrokes.push_back(query.substr(0, length));
+        for (size_t length = query.size(); length-- > 0;)
+            keystrokes.push_back(query.substr(0, length));
+    }
+
+    std::vector<double> indexedUs;
+    std::vector<double> naiveUs;
+    std::vector<uint32_t> visible;
+    std::vector<uint32_t> naiveVisible;
+    int result = 0;
+    for (const std::string& query : keystrokes)
+    {
+        auto start = std::chrono::steady_clock::now();
+        filter.SetQuery(query);
+        visible.clear();
+        for (uint32_t index : order)
+        {
+            if (filter.Matches(index))
+                visible.push_back(index);
+        }
+        auto middle = std::chrono::steady_clock::now();
+        std::string lowered;
+        for (char c : query)
+            lowered.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        naiveVisible.clear();
+        for (uint32_t index : order)
+        {
+            if (NaiveRoomMatch(lowered, names[index], aliases[index]))
+                naiveVisible.push_back(index);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        indexedUs.push_back(std::chrono::duration<double, std::micro>(middle - start).count());
+        naiveUs.push_back(std::chrono::duration<double, std::micro>(end - middle).count());
+        if (visible != naiveVisible)
+        {
+            printf("\"%s\" : %zu salons retenus, %zu sans index\n", query.c_str(), visible.size(), naiveVisible.size());
+            result = 1;
+        }
+    }
+
+    printf("%d salons, %zu frappes\n", roomCount, keystrokes.size());
+    printf("%-22s %12s %12s %12s\n", "filtre", "p50 us", "p99 us", "max us");
+    printf("%-22s %12.1f %12.1f %12.1f\n", "RoomFilter", Percentile(indexedUs, 0.50),
+           Percentile(indexedUs, 0.99), Percentile(indexedUs, 1.0));
+    printf("%-22s %12.1f %12.1f %12.1f\n", "sans index", Percentile(naiveUs, 0.50),
+           Percentile(naiveUs, 0.99), Percentile(naiveUs, 1.0));
+    return result;
+}
+
+/**
+ * @brief Point d'entrée du pilote headless
+ */
+int main(int argc, char** argv)
+{
+    int frameCount = 600;
+    int warmupFrames = 60;
+    int roomCount = 200;
+    int messagesPerRoom = 50;
+    int particleCount = -1;
+    bool loginScreen = false;
+    int gifCount = 0;
+    const char* gifDirectory = nullptr;
+    int cpuBudgetMb = -1;
+    int gpuBudgetMb = -1;
+    int uploadBudgetKb = -1;
+    int gifSize = 0;
+    bool arenaBench = false;
+    bool roomOrderBench = false;
+    bool filterBench = false;
+    const char* csvPath = nullptr;
+    const char* tracePath = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (hasValue && strcmp(argv[i], "--frames") == 0)
+            frameCount = std::max(1, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--warmup") == 0)
+            warmupFrames = std::max(0, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--rooms") == 0)
+            roomCount = std::max(1, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--messages") == 0)
+            messagesPerRoom = std::max(0, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--particles") == 0)
+            particleCount = std::max(0, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--gifs") == 0)
+            gifCount = std::max(0, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--gif-dir") == 0)
+            gifDirectory = argv[++i];
+        else if (hasValue && strcmp(argv[i], "--cpu-budget") == 0)
+            cpuBudgetMb = std::max(0, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--gpu-budget") == 0)
+            gpuBudgetMb = std::max(0, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--upload-budget") == 0)
+            uploadBudgetKb = std::max(0, atoi(argv[++i]));
+        else if (hasValue && strcmp(argv[i], "--gif-size") == 0)
+            gifSize = std::max(0, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--resample-bench") == 0)
+            return RunResampleBench();
+        else if (hasValue && strcmp(argv[i], "--image-bench") == 0)
+            return RunImageBench(argv[++i]);
+        else if (strcmp(argv[i], "--media-bench") == 0)
+            return RunMediaBench();
+        else if (strcmp(argv[i], "--queue-bench") == 0)
+            return RunQueueBench();
+        else if (strcmp(argv[i], "--timeline-bench") == 0)
+            return RunTimelineBench();
+        else if (strcmp(argv[i], "--arena-bench") == 0)
+            arenaBench = true;
+        else if (strcmp(argv[i], "--room-order-bench") == 0)
+            roomOrderBench = true;
+        else if (strcmp(argv[i], "--filter-bench") == 0)
+            filterBench = true;
+        else if (strcmp(argv[i], "--login") == 0)
+            loginScreen = true;
+        else if (hasValue && strcmp(argv[i], "--csv") == 0)
+            csvPath = argv[++i];
+        else if (hasValue && strcmp(argv[i], "--trace") == 0)
+            tracePath = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage : %s [--frames N] [--warmup N] [--rooms N] [--messages N] [--particles N] [--login] [--gifs N] [--gif-dir dossier] [--cpu-budget Mo] [--gpu-budget Mo] [--upload-budget Ko] [--gif-size px] [--resample-bench] [--image-bench dossier] [--media-bench] [--queue-bench] [--timeline-bench] [--arena-bench] [--room-order-bench] [--filter-bench] [--csv fichier] [--trace fichier]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (arenaBench)
+        return RunArenaBench(roomCount, messagesPerRoom);
+    if (roomOrderBench)
+        return RunRoomOrderBench(roomCount);
+    if (filterBench)
+        return RunFilterBench(roomCount);
+
+    // Contexte ImGui sans backend : taille d'affichage fixe, atlas de police
+    // construit en mémoire (jamais envoyé à un GPU)
+    ImGui::SetAllocatorFunctions(CountingAlloc, CountingFree);
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* fontPixels = nullptr;
+    int fontWidth = 0;
+    int fontHeight = 0;
+    io.Fonts->GetTexDataAsRGBA32(&fontPixels, &fontWidth, &fontHeight);
+    ChatWindow::ApplyStyle();
+
+    std::vector<FrameStats> frames;
+    frames.reserve(frameCount);
+    TextureAtlas::Stats atlas;
+    TextureManager::GifStats gifStats;
+    TextureManager::CacheStats cacheStats;
+    TextureManager::UploadStats uploadStats;
+    int corpusGifs = 0;
+    {
+        auto matrixClient = std::make_unique<MatrixClient>();
+        auto textureManager = std::make_unique<TextureManager>(nullptr);
+        auto chatWindow = std::make_unique<ChatWindow>(matrixClient.get(), textureManager.get());
+        if (particleCount >= 0)
+            chatWindow->SetBackgroundParticles(static_cast<size_t>(particleCount));
+        textureManager->SetBudgets(
+            cpuBudgetMb >= 0 ? static_cast<size_t>(cpuBudgetMb) << 20 : TextureManager::DEFAULT_CPU_BUDGET,
+            gpuBudgetMb >= 0 ? static_cast<size_t>(gpuBudgetMb) << 20 : TextureManager::DEFAULT_GPU_BUDGET);
+        if (uploadBudgetKb >= 0)
+        {
+            // 0 : tout ce qui arrive est rangé dans la frame, sans limite de temps
+            textureManager->SetUploadBudget(static_cast<size_t>(uploadBudgetKb) << 10,
+                                            uploadBudgetKb > 0 ? TextureManager::DEFAULT_UPLOAD_MS : 0.0);
+        }
+        std::vector<ImageHandle> gifs;
+        LoadSyntheticGifs(*textureManager, gifCount, gifs);
+        if (gifDirectory)
+            corpusGifs = LoadGifDirectory(*textureManager, gifDirectory, gifs);
+        for (ImageHandle gif : gifs)
+        {
+            textureManager->SetTargetSize(gif, gifSize, gifSize);
+        }
+
+        if (!loginScreen)
+            matrixClient->StartOfflineSession(BENCH_USER, BuildSyncResponses(roomCount, messagesPerRoom));
+
+        for (int frame = 0; frame < frameCount; ++frame)
+        {
+            ScriptInput(frame, *matrixClient);
+
+            FrameStats stats;
+            const size_t allocationsBefore = t_allocations;
+            const size_t bytesBefore = t_allocatedBytes;
+            auto start = std::chrono::steady_clock::now();
+
+            chatWindow->BeginFrame();
+            ImGui::NewFrame();
+            chatWindow->Render();
+
+            // Médias visibles : une fenêtre de quatre GIFs qui avance toutes les 30 frames
+            for (size_t k = 0; k < std::min<size_t>(4, gifs.size()); ++k)
+            {
+                textureManager->GetCurrentFrame(gifs[(frame / 30 + k) % gifs.size()]);
+            }
+            ImGui::Render();
+
+            // Rastériseur nul : parcours des commandes comme un backend
+            const ImDrawData* drawData = ImGui::GetDrawData();
+            for (int i = 0; i < drawData->CmdListsCount; ++i)
+            {
+                stats.commands += static_cast<size_t>(drawData->CmdLists[i]->CmdBuffer.Size);
+            }
+            stats.vertices = static_cast<size_t>(drawData->TotalVtxCount);
+            stats.indices = static_cast<size_t>(drawData->TotalIdxCount);
+
+            auto end = std::chrono::steady_clock::now();
+            stats.cpuMs = std::chrono::duration<double, std::milli>(end - start).count();
+            stats.allocations = t_allocations - allocationsBefore;
+            stats.allocatedBytes = t_allocatedBytes - bytesBefore;
+            stats.particles = chatWindow->GetBackgroundParticles().GetActiveCount();
+            frames.push_back(stats);
+        }
+        atlas = textureManager->GetAtlasStats();
+        gifStats = textureManager->GetGifStats();
+        cacheStats = textureManager->GetCacheStats();
+        uploadStats = textureManager->GetUploadStats();
+    }
+    ImGui::DestroyContext();
+
+    if (csvPath)
+    {
+        FILE* csv = fopen(csvPath, "w");
+        if (!csv)
+        {
+            fprintf(stderr, "Impossible d'ouvrir %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "frame,cpu_ms,vertices,indices,commands,allocations,allocated_bytes,particles\n");
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            const FrameStats& f = frames[i];
+            fprintf(csv, "%zu,%.4f,%zu,%zu,%zu,%zu,%zu,%zu\n", i, f.cpuMs, f.vertices, f.indices,
+                    f.commands, f.allocations, f.allocatedBytes, f.particles);
+        }
+        fclose(csv);
+    }
+
+    // Résumé hors frames de chauffe (application de la synchronisation initiale)
+    std::vector<FrameStats> measured(frames.begin() + std::min<size_t>(warmupFrames, frames.size()), frames.end());
+    if (measured.empty())
+        measured = frames;
+
+    printf("Kitty Chat headless : %zu frames mesurees (+%d de chauffe), ",
+           measured.size(), static_cast<int>(frames.size() - measured.size()));
+    if (loginScreen)
+        printf("ecran de connexion\n\n");
+    else
+        printf("%d salons x %d messages\n\n", roomCount, messagesPerRoom);
+    printf("%-22s %12s %12s %12s\n", "", "p50", "p99", "max");
+    PrintRow<double>("temps CPU (ms)", measured, [](const FrameStats& f) { return f.cpuMs; }, "%.3f");
+    PrintRow<size_t>("sommets", measured, [](const FrameStats& f) { return f.vertices; }, "%zu");
+    PrintRow<size_t>("indices", measured, [](const FrameStats& f) { return f.indices; }, "%zu");
+    PrintRow<size_t>("commandes de dessin", measured, [](const FrameStats& f) { return f.commands; }, "%zu");
+    PrintRow<size_t>("allocations", measured, [](const FrameStats& f) { return f.allocations; }, "%zu");
+    PrintRow<size_t>("octets alloues", measured, [](const FrameStats& f) { return f.allocatedBytes; }, "%zu");
+    PrintRow<size_t>("etoiles affichees", measured, [](const FrameStats& f) { return f.particles; }, "%zu");
+
+    // Sections chronométrées (fenêtre glissante des dernières frames)
+    const FrameProfiler& profiler = FrameProfiler::Get();
+    printf("\n%-26s %10s %10s %10s\n", "section (ms)", "p50", "p99", "max");
+    for (size_t i = 0; i < static_cast<size_t>(ProfileSection::Count); ++i)
+    {
+        ProfileSection section = static_cast<ProfileSection>(i);
+        FrameProfiler::Stats stats = profiler.GetStats(section);
+        if (stats.samples == 0)
+            continue;
+        printf("%-26s %10.3f %10.3f %10.3f\n", FrameProfiler::SectionName(section), stats.p50, stats.p99, stats.max);
+    }
+
+    printf("\natlas de textures : %zu pages pour %zu images (%.1f %% occupe)\n", atlas.textures, atlas.regions,
+           atlas.totalPixels ? 100.0 * atlas.usedPixels / atlas.totalPixels : 0.0);
+    if (gifDirectory)
+        printf("corpus %s : %d GIFs decodes\n", gifDirectory, corpusGifs);
+    printf("frames GIF en memoire : %zu GIFs, %zu frames, %.1f Mo indexes + %.1f Mo de toiles (%.1f Mo en RGBA)\n",
+           gifStats.gifs, gifStats.frames, gifStats.indexedBytes / 1048576.0, gifStats.canvasBytes / 1048576.0,
+           gifStats.rgbaBytes / 1048576.0);
+    printf("envoi des frames GIF : %.1f Mo (%.1f Mo en frames entieres)\n",
+           gifStats.uploadedBytes / 1048576.0, gifStats.fullFrameBytes / 1048576.0);
+    printf("animations actives : %zu sur %zu GIFs\n", gifStats.animating, gifStats.gifs);
+
+    printf("cache de textures : CPU %.1f / %.0f Mo, GPU %.1f / %.0f Mo\n",
+           cacheStats.cpuBytes / 1048576.0, cacheStats.cpuBudget / 1048576.0,
+           cacheStats.gpuBytes / 1048576.0, cacheStats.gpuBudget / 1048576.0);
+    printf("  %llu succes, %llu echecs, %llu evictions GPU, %llu evictions CPU, %llu redecodages\n",
+           static_cast<unsigned long long>(cacheStats.hits), static_cast<unsigned long long>(cacheStats.misses),
+           static_cast<unsigned long long>(cacheStats.gpuEvictions),
+           static_cast<unsigned long long>(cacheStats.cpuEvictions),
+           static_cast<unsigned long long>(cacheStats.redecodes));
+    printf("file d'envoi : %llu images rangees, max %.1f Mo / %.2f ms par frame, %llu frames au budget, %zu en attente\n",
+           static_cast<unsigned long long>(uploadStats.uploads), uploadStats.maxFrameBytes / 1048576.0,
+           uploadStats.maxFrameMs, static_cast<unsigned long long>(uploadStats.deferredFrames), uploadStats.queued);
+
+    // ru_maxrss est en Ko sous Linux
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        printf("memoire residente max : %.1f Mo\n", usage.ru_maxrss / 1024.0);
+
+    if (tracePath && !profiler.ExportChromeTrace(tracePath))
+    {
+        fprintf(stderr, "Impossible d'ecrire %s\n", tracePath);
+        return 1;
+    }
+
+    return 0;
+}
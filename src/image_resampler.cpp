@@ -0,0 +1,141 @@
+/**
+ * @file image_resampler.cpp
+ * @brief Implémentation de la réduction d'images RGBA (filtre boîte)
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "image_resampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_RESAMPLER_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Ajoute (r*a, g*a, b*a, a) des pixels d'un morceau de ligne
+ */
+static void SumRowScalar(const uint8_t* row, int count, uint32_t sums[4])
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const uint8_t* pixel = row + i * 4;
+        const uint32_t alpha = pixel[3];
+        sums[0] += pixel[0] * alpha;
+        sums[1] += pixel[1] * alpha;
+        sums[2] += pixel[2] * alpha;
+        sums[3] += alpha;
+    }
+}
+
+#if defined(IMAGE_RESAMPLER_SSE2)
+
+/**
+ * @brief SumRowScalar, deux pixels par tour
+ *
+ * Les canaux sont élargis en 16 bits et multipliés par l'alpha en une
+ * instruction (255 * 255 tient sur 16 bits non signés), puis ajoutés aux
+ * quatre sommes 32 bits.
+ */
+static void SumRowSse2(const uint8_t* row, int count, uint32_t sums[4])
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i colorLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alphaOne = _mm_set_epi16(1, 0, 0, 0, 1, 0, 0, 0);
+
+    __m128i accumulator = zero;
+    int i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i * 4)), zero);
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+                                            _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i weights = _mm_or_si128(_mm_and_si128(alpha, colorLanes), alphaOne);
+        __m128i products = _mm_mullo_epi16(pixels, weights);
+        accumulator = _mm_add_epi32(accumulator, _mm_unpacklo_epi16(products, zero));
+        accumulator = _mm_add_epi32(accumulator, _mm_unpackhi_epi16(products, zero));
+    }
+
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+    for (int k = 0; k < 4; ++k)
+    {
+        sums[k] += lanes[k];
+    }
+    SumRowScalar(row + i * 4, count - i, sums);
+}
+
+#endif // IMAGE_RESAMPLER_SSE2
+
+/**
+ * @brief Réduction d'une zone, somme des lignes fournie par SumRow
+ *
+ * Le pixel réduit (dx, dy) couvre les pixels source
+ * [dx * srcWidth / dstWidth, ceil((dx + 1) * srcWidth / dstWidth)[, idem
+ * en hauteur. Couleur = somme(c * a) / somme(a), alpha = moyenne des a.
+ */
+template <void (*SumRow)(const uint8_t*, int, uint32_t*)>
+static void Downscale(const uint8_t* src, int srcWidth, int srcHeight, int srcPitch,
+                      int dstWidth, int dstHeight, int x, int y, int width, int height,
+                      uint8_t* dst, int dstPitch)
+{
+    for (int dy = y; dy < y + height; ++dy)
+    {
+        const int sy0 = static_cast<int>(static_cast<int64_t>(dy) * srcHeight / dstHeight);
+        const int sy1 = static_cast<int>((static_cast<int64_t>(dy + 1) * srcHeight + dstHeight - 1) / dstHeight);
+        uint8_t* out = dst + static_cast<size_t>(dy - y) * dstPitch;
+
+        for (int dx = x; dx < x + width; ++dx)
+        {
+            const int sx0 = static_cast<int>(static_cast<int64_t>(dx) * srcWidth / dstWidth);
+            const int sx1 = static_cast<int>((static_cast<int64_t>(dx + 1) * srcWidth + dstWidth - 1) / dstWidth);
+
+            uint64_t sums[4] = { 0, 0, 0, 0 };
+            for (int sy = sy0; sy < sy1; ++sy)
+            {
+                uint32_t row[4] = { 0, 0, 0, 0 };
+                SumRow(src + static_cast<size_t>(sy) * srcPitch + static_cast<size_t>(sx0) * 4, sx1 - sx0, row);
+                for (int k = 0; k < 4; ++k)
+                {
+                    sums[k] += row[k];
+                }
+            }
+
+            const double alpha = static_cast<double>(sums[3]);
+            const double colorScale = sums[3] ? 1.0 / alpha : 0.0;
+            for (int k = 0; k < 3; ++k)
+            {
+                out[k] = static_cast<uint8_t>(std::min(255L, std::lround(sums[k] * colorScale)));
+            }
+            out[3] = static_cast<uint8_t>(std::lround(alpha / (static_cast<double>(sx1 - sx0) * (sy1 - sy0))));
+            out += 4;
+        }
+    }
+}
+
+/**
+ * @brief Réduit une zone d'une image RGBA (filtre boîte)
+ */
+void DownscaleBox(const uint8_t* src, int srcWidth, int srcHeight, int srcPitch,
+                  int dstWidth, int dstHeight, int x, int y, int width, int height,
+                  uint8_t* dst, int dstPitch)
+{
+#if defined(IMAGE_RESAMPLER_SSE2)
+    Downscale<SumRowSse2>(src, srcWidth, srcHeight, srcPitch, dstWidth, dstHeight, x, y, width, height, dst, dstPitch);
+#else
+    Downscale<SumRowScalar>(src, srcWidth, srcHeight, srcPitch, dstWidth, dstHeight, x, y, width, height, dst, dstPitch);
+#endif
+}
+
+/**
+ * @brief Version scalaire de DownscaleBox
+ */
+void DownscaleBoxScalar(const uint8_t* src, int srcWidth, int srcHeight, int srcPitch,
+                        int dstWidth, int dstHeight, int x, int y, int width, int height,
+                        uint8_t* dst, int dstPitch)
+{
+    Downscale<SumRowScalar>(src, srcWidth, srcHeight, srcPitch, dstWidth, dstHeight, x, y, width, height, dst, dstPitch);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file image_resampler.h
+ * @brief Réduction d'images RGBA à leur taille d'affichage
+ *
+ * Filtre boîte : chaque pixel réduit est la moyenne des pixels source
+ * qu'il recouvre, pondérée par l'alpha (pas de halo sombre autour des
+ * zones transparentes). Une zone de l'image réduite peut être calculée
+ * seule, pour ne refaire que le rectangle modifié d'une frame de GIF.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef IMAGE_RESAMPLER_H
+#define IMAGE_RESAMPLER_H
+
+#include <cstdint>
+
+/**
+ * @brief Réduit une zone d'une image RGBA (filtre boîte)
+ * @param src Image source
+ * @param srcWidth Largeur de la source
+ * @param srcHeight Hauteur de la source
+ * @param srcPitch Octets par ligne de la source
+ * @param dstWidth Largeur de l'image réduite complète (au plus srcWidth)
+ * @param dstHeight Hauteur de l'image réduite complète (au plus srcHeight)
+ * @param x Zone à calculer, en pixels de l'image réduite
+ * @param y Zone à calculer, en pixels de l'image réduite
+ * @param width Zone à calculer, en pixels de l'image réduite
+ * @param height Zone à calculer, en pixels de l'image réduite
+ * @param dst Pixels de la zone (sortie)
+ * @param dstPitch Octets par ligne de dst
+ *
+ * Accumulation en SSE2 quand le compilateur le cible, sinon scalaire ;
+ * les deux donnent les mêmes octets.
+ */
+void DownscaleBox(const uint8_t* src, int srcWidth, int srcHeight, int srcPitch,
+                  int dstWidth, int dstHeight, int x, int y, int width, int height,
+                  uint8_t* dst, int dstPitch);
+
+/**
+ * @brief Version scalaire de DownscaleBox (référence du banc de mesure)
+ */
+void DownscaleBoxScalar(const uint8_t* src, int srcWidth, int srcHeight, int srcPitch,
+                        int dstWidth, int dstHeight, int x, int y, int width, int height,
+                        uint8_t* dst, int dstPitch);
+
+#endif // IMAGE_RESAMPLER_H
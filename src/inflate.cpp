@@ -0,0 +1,457 @@
+/**
+ * @file inflate.cpp
+ * @brief Implémentation de la décompression DEFLATE (RFC 1950 / 1951)
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "inflate.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INFLATE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Bits lus d'un coup par la table rapide
+static const int FAST_BITS = 9;
+
+// Longueur maximale d'un code de Huffman
+static const int MAX_CODE_BITS = 15;
+
+static const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Ordre des longueurs du code des longueurs (blocs dynamiques)
+static const uint8_t CODE_LENGTH_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/**
+ * @class BitReader
+ * @brief Lecture des bits du flux, du poids faible au poids fort
+ *
+ * Au-delà de la fin des données, on lit des zéros ; Overrun() le signale.
+ */
+class BitReader
+{
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+        , m_pos(0)
+        , m_bits(0)
+        , m_count(0)
+    {
+    }
+
+    uint32_t Peek(int count)
+    {
+        if (m_count < count)
+            Refill();
+        return static_cast<uint32_t>(m_bits & ((1ull << count) - 1));
+    }
+
+    void Consume(int count)
+    {
+        m_bits >>= count;
+        m_count -= count;
+    }
+
+    uint32_t Bits(int count)
+    {
+        uint32_t value = Peek(count);
+        Consume(count);
+        return value;
+    }
+
+    /**
+     * @brief Saute les bits jusqu'à la limite d'octet suivante
+     */
+    void AlignToByte() { Consume(m_count & 7); }
+
+    /**
+     * @brief Copie des octets entiers (après AlignToByte)
+     * @return false si les données s'arrêtent avant
+     */
+    bool ReadBytes(uint8_t* out, size_t count)
+    {
+        while (count > 0 && m_count >= 8)
+        {
+            *out++ = static_cast<uint8_t>(Bits(8));
+            --count;
+        }
+        if (count > 0)
+        {
+            // Tampon de bits vide : lecture directe (les octets lus en avance
+            // par Refill sont oubliés, m_pos ne les compte pas)
+            m_bits = 0;
+            if (m_pos > m_size || m_size - m_pos < count)
+                return false;
+            memcpy(out, m_data + m_pos, count);
+            m_pos += count;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Plus de bits consommés que le flux n'en contient
+     */
+    bool Overrun() const { return m_pos * 8 - m_count > m_size * 8; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos;       // Octets chargés dans m_bits (zéros de remplissage compris)
+    uint64_t m_bits;
+    int m_count;
+
+    void Refill()
+    {
+        if (m_pos + 8 <= m_size)
+        {
+            // Huit octets d'un coup : on garde ceux qui tiennent
+            uint64_t word;
+            memcpy(&word, m_data + m_pos, 8);
+            m_bits |= word << m_count;
+            m_pos += (63 - m_count) >> 3;
+            m_count |= 56;
+            return;
+        }
+        while (m_count <= 56)
+        {
+            uint64_t byte = m_pos < m_size ? m_data[m_pos] : 0;
+            m_bits |= byte << m_count;
+            m_count += 8;
+            ++m_pos;
+        }
+    }
+};
+
+/**
+ * @class Huffman
+ * @brief Code de Huffman canonique d'un bloc DEFLATE
+ */
+class Huffman
+{
+public:
+    /**
+     * @brief Construit le code à partir des longueurs de chaque symbole
+     * @return false si les longueurs décrivent plus de codes que possible
+     */
+    bool Build(const uint8_t* lengths, int count)
+    {
+        memset(m_fast, 0, sizeof(m_fast));
+        memset(m_count, 0, sizeof(m_count));
+        for (int i = 0; i < count; ++i)
+        {
+            ++m_count[lengths[i]];
+        }
+        m_count[0] = 0;
+
+        // Un code incomplet est permis (un seul code de distance, par exemple)
+        int left = 1;
+        for (int length = 1; length <= MAX_CODE_BITS; ++length)
+        {
+            left = (left << 1) - m_count[length];
+            if (left < 0)
+                return false;
+        }
+
+        uint16_t offsets[MAX_CODE_BITS + 1];
+        uint16_t nextCode[MAX_CODE_BITS + 1];
+        offsets[1] = 0;
+        nextCode[1] = 0;
+        for (int length = 1; length < MAX_CODE_BITS; ++length)
+        {
+            offsets[length + 1] = offsets[length] + m_count[length];
+            nextCode[length + 1] = static_cast<uint16_t>((nextCode[length] + m_count[length]) << 1);
+        }
+
+        for (int symbol = 0; symbol < count; ++symbol)
+        {
+            const int length = lengths[symbol];
+            if (length == 0)
+                continue;
+            m_symbols[offsets[length]++] = static_cast<uint16_t>(symbol);
+
+            const int code = nextCode[length]++;
+            if (length > FAST_BITS)
+                continue;
+
+            // Les codes sont lus bit à bit depuis le poids fort : on les retourne
+            int reversed = 0;
+            for (int bit = 0; bit < length; ++bit)
+            {
+                reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+            }
+            for (int index = reversed; index < (1 << FAST_BITS); index += 1 << length)
+            {
+                m_fast[index] = static_cast<uint16_t>((symbol << 4) | length);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Décode un symbole
+     * @return -1 si aucun code ne correspond
+     */
+    int Decode(BitReader& reader) const
+    {
+        const uint32_t bits = reader.Peek(MAX_CODE_BITS);
+        const uint16_t entry = m_fast[bits & ((1 << FAST_BITS) - 1)];
+        if (entry)
+        {
+            reader.Consume(entry & 15);
+            return entry >> 4;
+        }
+
+        // Code long : parcours canonique, longueur par longueur
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int length = 1; length <= MAX_CODE_BITS; ++length)
+        {
+            code |= (bits >> (length - 1)) & 1;
+            const int count = m_count[length];
+            if (code - count < first)
+            {
+                reader.Consume(length);
+                return m_symbols[index + (code - first)];
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+private:
+    uint16_t m_fast[1 << FAST_BITS];    // (symbole << 4) | longueur, 0 pour un code long
+    uint16_t m_count[MAX_CODE_BITS + 1];
+    uint16_t m_symbols[288];            // Symboles rangés par code croissant
+};
+
+/**
+ * @brief Recopie len octets situés dist octets plus tôt
+ *
+ * À 16 octets de distance ou plus, source et destination d'un bloc de 16
+ * ne se recouvrent pas : copie par blocs. Distance 1 : simple remplissage.
+ */
+static void CopyMatch(uint8_t* out, size_t dist, size_t len)
+{
+    const uint8_t* src = out - dist;
+    if (dist >= 16)
+    {
+        for (; len >= 16; len -= 16)
+        {
+#if defined(INFLATE_SSE2)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+#else
+            memcpy(out, src, 16);
+#endif
+            out += 16;
+            src += 16;
+        }
+    }
+    else if (dist == 1)
+    {
+        memset(out, *src, len);
+        return;
+    }
+
+    while (len-- > 0)
+    {
+        *out++ = *src++;
+    }
+}
+
+/**
+ * @brief Lit les codes d'un bloc à Huffman dynamique
+ */
+static bool ReadDynamicTables(BitReader& reader, Huffman& literals, Huffman& distances)
+{
+    const int literalCount = static_cast<int>(reader.Bits(5)) + 257;
+    const int distanceCount = static_cast<int>(reader.Bits(5)) + 1;
+    const int codeLengthCount = static_cast<int>(reader.Bits(4)) + 4;
+    if (literalCount > 286 || distanceCount > 30)
+        return false;
+
+    uint8_t codeLengths[19] = {};
+    for (int i = 0; i < codeLengthCount; ++i)
+    {
+        codeLengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(reader.Bits(3));
+    }
+    Huffman codeLengthCode;
+    if (!codeLengthCode.Build(codeLengths, 19))
+        return false;
+
+    uint8_t lengths[286 + 30];
+    const int total = literalCount + distanceCount;
+    int count = 0;
+    while (count < total)
+    {
+        const int symbol = codeLengthCode.Decode(reader);
+        if (symbol < 0 || reader.Overrun())
+            return false;
+        if (symbol < 16)
+        {
+            lengths[count++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint8_t value = 0;
+        int repeat;
+        if (symbol == 16)
+        {
+            if (count == 0)
+                return false;
+            value = lengths[count - 1];
+            repeat = 3 + static_cast<int>(reader.Bits(2));
+        }
+        else if (symbol == 17)
+            repeat = 3 + static_cast<int>(reader.Bits(3));
+        else
+            repeat = 11 + static_cast<int>(reader.Bits(7));
+
+        if (count + repeat > total)
+            return false;
+        memset(lengths + count, value, repeat);
+        count += repeat;
+    }
+
+    // Le symbole de fin de bloc doit avoir un code
+    if (lengths[256] == 0)
+        return false;
+    return literals.Build(lengths, literalCount) && distances.Build(lengths + literalCount, distanceCount);
+}
+
+/**
+ * @brief Tables du code fixe (blocs de type 1)
+ */
+static void BuildFixedTables(Huffman& literals, Huffman& distances)
+{
+    uint8_t lengths[288];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    literals.Build(lengths, 288);
+
+    memset(lengths, 5, 30);
+    distances.Build(lengths, 30);
+}
+
+/**
+ * @brief Décompresse un flux zlib dans un tampon de taille connue
+ */
+bool ZlibInflate(const uint8_t* data, size_t size, uint8_t* out, size_t outSize, size_t& written)
+{
+    written = 0;
+    if (!data || size < 2)
+        return false;
+
+    // En-tête zlib : méthode 8 (deflate), pas de dictionnaire prédéfini
+    const int cmf = data[0];
+    const int flags = data[1];
+    if ((cmf & 15) != 8 || ((cmf << 8) | flags) % 31 != 0 || (flags & 0x20))
+        return false;
+
+    BitReader reader(data + 2, size - 2);
+    Huffman literals;
+    Huffman distances;
+    size_t pos = 0;
+    bool last = false;
+
+    while (!last)
+    {
+        last = reader.Bits(1) != 0;
+        const uint32_t type = reader.Bits(2);
+        if (reader.Overrun())
+            break;
+
+        if (type == 0)
+        {
+            // Bloc stocké tel quel
+            reader.AlignToByte();
+            const uint32_t length = reader.Bits(16);
+            const uint32_t inverse = reader.Bits(16);
+            if (reader.Overrun())
+                break;
+            if ((length ^ 0xFFFF) != inverse || length > outSize - pos)
+                return false;
+            if (!reader.ReadBytes(out + pos, length))
+                break;
+            pos += length;
+            continue;
+        }
+
+        if (type == 1)
+            BuildFixedTables(literals, distances);
+        else if (type != 2 || !ReadDynamicTables(reader, literals, distances))
+        {
+            written = pos;
+            return reader.Overrun();
+        }
+
+        for (;;)
+        {
+            const int symbol = literals.Decode(reader);
+            if (reader.Overrun())
+            {
+                written = pos;
+                return true;
+            }
+            if (symbol < 0)
+                return false;
+
+            if (symbol < 256)
+            {
+                if (pos >= outSize)
+                    return false;
+                out[pos++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            if (symbol == 256)
+                break;
+
+            const int lengthSymbol = symbol - 257;
+            if (lengthSymbol >= 29)
+                return false;
+            const size_t length = LENGTH_BASE[lengthSymbol] + reader.Bits(LENGTH_EXTRA[lengthSymbol]);
+
+            const int distanceSymbol = distances.Decode(reader);
+            if (distanceSymbol < 0 || distanceSymbol >= 30)
+                return false;
+            const size_t distance = DISTANCE_BASE[distanceSymbol] + reader.Bits(DISTANCE_EXTRA[distanceSymbol]);
+            if (reader.Overrun())
+            {
+                written = pos;
+                return true;
+            }
+            if (distance > pos || length > outSize - pos)
+                return false;
+
+            CopyMatch(out + pos, distance, length);
+            pos += length;
+        }
+    }
+
+    written = pos;
+    return true;
+}
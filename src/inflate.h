@@ -0,0 +1,32 @@
+/**
+ * @file inflate.h
+ * @brief Décompression des flux zlib (DEFLATE), pour les images PNG
+ *
+ * Décodage de Huffman par table (9 bits d'un coup, puis code canonique
+ * pour les codes plus longs). Les copies de répétitions lointaines se font
+ * par blocs de 16 octets (SSE2 quand le compilateur le cible).
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Décompresse un flux zlib dans un tampon de taille connue
+ * @param data Flux zlib (en-tête de 2 octets, blocs DEFLATE)
+ * @param size Taille du flux
+ * @param out Destination
+ * @param outSize Taille de la destination
+ * @param written Octets écrits (sortie)
+ * @return false si le flux est invalide ou déborde de la destination
+ *
+ * Un flux tronqué s'arrête sans erreur : written dit jusqu'où il est allé.
+ * La somme Adler-32 n'est pas vérifiée.
+ */
+bool ZlibInflate(const uint8_t* data, size_t size, uint8_t* out, size_t outSize, size_t& written);
+
+#endif // INFLATE_H
@@ -0,0 +1,1183 @@
+/**
+ * @file jpeg_decoder.cpp
+ * @brief Implémentation du décodage JPEG
+ *
+ * Les coefficients de tous les blocs sont gardés jusqu'à la fin du fichier
+ * (un JPEG progressif les affine scan après scan), puis chaque composante
+ * passe par la transformée inverse, le sur-échantillonnage et la
+ * conversion de couleurs.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "jpeg_decoder.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JPEG_DECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Limite de taille des images acceptées (pixels)
+static const size_t MAX_JPEG_PIXELS = 8192 * 8192;
+
+// Bits lus d'un coup par la table rapide de Huffman
+static const int FAST_BITS = 9;
+
+static const int MAX_COMPONENTS = 3;
+
+/**
+ * @brief Position naturelle (ligne * 8 + colonne) du k-ième coefficient en zigzag
+ *
+ * Les 16 entrées en trop absorbent les débordements d'un flux corrompu.
+ */
+static const uint8_t ZIGZAG[64 + 16] = {
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+};
+
+// Facteurs d'échelle de la transformée AAN : cos(k * pi / 16) * sqrt(2), 1 pour k = 0
+static const double AAN_SCALE[8] = {
+    1.0, 1.387039845, 1.306562965, 1.175875602, 1.0, 0.785694958, 0.541196100, 0.275899379
+};
+
+/**
+ * @class JpegBits
+ * @brief Lecture des bits d'un scan, du poids fort au poids faible
+ *
+ * Retire les octets de bourrage (0xFF 0x00). À la rencontre d'un marqueur,
+ * ou au-delà de la fin des données, on lit des zéros.
+ */
+class JpegBits
+{
+public:
+    JpegBits(const uint8_t* data, size_t size, size_t pos)
+        : m_data(data)
+        , m_size(size)
+        , m_pos(pos)
+        , m_bits(0)
+        , m_count(0)
+        , m_marker(false)
+    {
+    }
+
+    uint32_t Peek(int count)
+    {
+        if (m_count < count)
+            Refill();
+        return static_cast<uint32_t>(m_bits >> (64 - count));
+    }
+
+    void Consume(int count)
+    {
+        m_bits <<= count;
+        m_count -= count;
+    }
+
+    int Bits(int count)
+    {
+        if (count == 0)
+            return 0;
+        int value = static_cast<int>(Peek(count));
+        Consume(count);
+        return value;
+    }
+
+    /**
+     * @brief Lit count bits et leur rend leur signe (extension JPEG)
+     */
+    int Signed(int count)
+    {
+        const int value = Bits(count);
+        return value < (1 << (count - 1)) ? value - (1 << count) + 1 : value;
+    }
+
+    /**
+     * @brief Saute le marqueur RSTn suivant et repart d'un octet neuf
+     */
+    void Restart()
+    {
+        m_bits = 0;
+        m_count = 0;
+        m_marker = false;
+        while (m_pos + 1 < m_size)
+        {
+            if (m_data[m_pos] == 0xFF && m_data[m_pos + 1] >= 0xD0 && m_data[m_pos + 1] <= 0xD7)
+            {
+                m_pos += 2;
+                return;
+            }
+            if (m_data[m_pos] == 0xFF && m_data[m_pos + 1] != 0x00 && m_data[m_pos + 1] != 0xFF)
+                return;     // Autre marqueur : RSTn manquant
+            ++m_pos;
+        }
+    }
+
+    /**
+     * @brief Position à partir de laquelle chercher le marqueur suivant
+     *
+     * Refill lit jusqu'à huit octets d'avance : on recule d'autant, la
+     * recherche saute les octets de bourrage.
+     */
+    size_t ResumePosition(size_t scanStart) const
+    {
+        return std::max(scanStart, m_pos - std::min<size_t>(m_pos, 8));
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos;
+    uint64_t m_bits;    // Bits à lire, alignés sur le poids fort
+    int m_count;
+    bool m_marker;      // Marqueur atteint : plus que des zéros
+
+    void Refill()
+    {
+        if (!m_marker && m_pos + 8 <= m_size)
+        {
+            uint64_t word = 0;
+            for (int i = 0; i < 8; ++i)
+            {
+                word = (word << 8) | m_data[m_pos + i];
+            }
+            // Sans octet 0xFF (ni bourrage ni marqueur), on prend d'un coup
+            // les octets entiers qui tiennent
+            const uint64_t inverted = ~word;
+            if (((inverted - 0x0101010101010101ull) & word & 0x8080808080808080ull) == 0)
+            {
+                const int bytes = (63 - m_count) >> 3;
+                m_bits |= (word & ~((1ull << (64 - bytes * 8)) - 1)) >> m_count;
+                m_count += bytes * 8;
+                m_pos += bytes;
+                return;
+            }
+        }
+        while (m_count <= 56)
+        {
+            uint64_t byte = 0;
+            if (!m_marker && m_pos < m_size)
+            {
+                byte = m_data[m_pos];
+                if (byte != 0xFF)
+                {
+                    ++m_pos;
+                }
+                else if (m_pos + 1 < m_size && m_data[m_pos + 1] == 0x00)
+                {
+                    m_pos += 2;
+                }
+                else
+                {
+                    m_marker = true;
+                    byte = 0;
+                }
+            }
+            m_bits |= byte << (56 - m_count);
+            m_count += 8;
+        }
+    }
+};
+
+/**
+ * @class JpegHuffman
+ * @brief Table de Huffman d'un segment DHT
+ */
+class JpegHuffman
+{
+public:
+    bool defined = false;
+
+    /**
+     * @brief Construit la table depuis le nombre de codes par longueur et les symboles
+     * @return false si les longueurs décrivent plus de codes qu'il n'en existe
+     */
+    bool Build(const uint8_t counts[16], const uint8_t* symbols, int symbolCount)
+    {
+        memset(m_fastLength, 0, sizeof(m_fastLength));
+        memset(m_symbols, 0, sizeof(m_symbols));
+        memcpy(m_symbols, symbols, symbolCount);
+
+        int code = 0;
+        int index = 0;
+        for (int length = 1; length <= 16; ++length)
+        {
+            m_offset[length] = index - code;
+            if (code + counts[length - 1] > (1 << length))
+                return false;
+            for (int i = 0; i < counts[length - 1]; ++i, ++code, ++index)
+            {
+                if (length <= FAST_BITS)
+                {
+                    const int shift = FAST_BITS - length;
+                    for (int fill = 0; fill < (1 << shift); ++fill)
+                    {
+                        m_fastLength[(code << shift) | fill] = static_cast<uint8_t>(length);
+                        m_fastSymbol[(code << shift) | fill] = symbols[index];
+                    }
+                }
+            }
+            // Plus grand code de cette longueur (sous le premier s'il n'y en a pas)
+            m_maxCode[length] = code - 1;
+            code <<= 1;
+        }
+        defined = true;
+        return true;
+    }
+
+    /**
+     * @brief Décode un symbole (0 si le code n'existe pas)
+     */
+    int Decode(JpegBits& bits) const
+    {
+        const uint32_t peek = bits.Peek(16);
+        const int fast = peek >> (16 - FAST_BITS);
+        if (m_fastLength[fast])
+        {
+            bits.Consume(m_fastLength[fast]);
+            return m_fastSymbol[fast];
+        }
+        for (int length = FAST_BITS + 1; length <= 16; ++length)
+        {
+            const int code = static_cast<int>(peek >> (16 - length));
+            if (code <= m_maxCode[length])
+            {
+                bits.Consume(length);
+                return m_symbols[(code + m_offset[length]) & 0xFF];
+            }
+        }
+        bits.Consume(16);
+        return 0;
+    }
+
+private:
+    uint8_t m_fastLength[1 << FAST_BITS];
+    uint8_t m_fastSymbol[1 << FAST_BITS];
+    int m_maxCode[17];
+    int m_offset[17];
+    uint8_t m_symbols[256];
+};
+
+/**
+ * @struct JpegComponent
+ * @brief Composante (Y, Cb, Cr ou gris) et ses coefficients
+ */
+struct JpegComponent
+{
+    int id = 0;
+    int h = 1;                      // Facteurs d'échantillonnage
+    int v = 1;
+    int quantTable = 0;
+    int blocksPerLine = 0;          // Blocs stockés (multiple des MCU)
+    int blocksPerColumn = 0;
+    int usedBlocksX = 0;            // Blocs couvrant l'image (scans non entrelacés)
+    int usedBlocksY = 0;
+    int dcTable = 0;
+    int acTable = 0;
+    int dcPredictor = 0;
+    std::vector<int16_t> coefficients;  // 64 par bloc, ordre naturel
+    std::vector<uint8_t> samples;       // Après transformée inverse
+};
+
+/**
+ * @class JpegFrame
+ * @brief État du décodage : tables, composantes, progression des scans
+ */
+class JpegFrame
+{
+public:
+    bool Decode(const uint8_t* data, size_t size, std::vector<uint8_t>& rgba, int& width, int& height);
+
+private:
+    uint16_t m_quant[4][64] = {};
+    JpegHuffman m_dcTables[4];
+    JpegHuffman m_acTables[4];
+    JpegComponent m_components[MAX_COMPONENTS];
+    int m_componentCount = 0;
+    int m_width = 0;
+    int m_height = 0;
+    int m_hmax = 1;
+    int m_vmax = 1;
+    int m_mcusX = 0;
+    int m_mcusY = 0;
+    int m_restartInterval = 0;
+    bool m_progressive = false;
+    bool m_adobeRgb = false;
+
+    // Scan en cours
+    int m_spectralStart = 0;
+    int m_spectralEnd = 63;
+    int m_approxHigh = 0;
+    int m_approxLow = 0;
+    int m_eobRun = 0;
+
+    bool ReadQuantTables(const uint8_t* segment, size_t length);
+    bool ReadHuffmanTables(const uint8_t* segment, size_t length);
+    bool ReadFrameHeader(const uint8_t* segment, size_t length);
+    bool DecodeScan(const uint8_t* data, size_t size, size_t& pos, size_t length);
+    void DecodeBlock(JpegBits& bits, JpegComponent& component, int16_t* block);
+    void Finish(std::vector<uint8_t>& rgba);
+};
+
+static int ReadU16(const uint8_t* data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+/**
+ * @brief Vérifie la signature JPEG (marqueur SOI)
+ */
+bool IsJpeg(const uint8_t* data, size_t size)
+{
+    return data && size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+/**
+ * @brief Segment DQT : tables de quantification, rangées en ordre naturel
+ */
+bool JpegFrame::ReadQuantTables(const uint8_t* segment, size_t length)
+{
+    size_t pos = 0;
+    while (pos < length)
+    {
+        const int precision = segment[pos] >> 4;
+        const int table = segment[pos] & 15;
+        ++pos;
+        if (table > 3 || pos + (precision ? 128 : 64) > length)
+            return false;
+        for (int k = 0; k < 64; ++k)
+        {
+            m_quant[table][ZIGZAG[k]] = precision ? static_cast<uint16_t>(ReadU16(segment + pos + k * 2))
+                                                  : segment[pos + k];
+        }
+        pos += precision ? 128 : 64;
+    }
+    return true;
+}
+
+/**
+ * @brief Segment DHT : tables de Huffman DC et AC
+ */
+bool JpegFrame::ReadHuffmanTables(const uint8_t* segment, size_t length)
+{
+    size_t pos = 0;
+    while (pos + 17 <= length)
+    {
+        const int tableClass = segment[pos] >> 4;
+        const int table = segment[pos] & 15;
+        const uint8_t* counts = segment + pos + 1;
+        int total = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            total += counts[i];
+        }
+        pos += 17;
+        if (tableClass > 1 || table > 3 || total > 256 || pos + total > length)
+            return false;
+        if (!(tableClass ? m_acTables : m_dcTables)[table].Build(counts, segment + pos, total))
+            return false;
+        pos += total;
+    }
+    return pos == length;
+}
+
+/**
+ * @brief Segment SOFn : taille de l'image et composantes
+ */
+bool JpegFrame::ReadFrameHeader(const uint8_t* segment, size_t length)
+{
+    if (length < 6 || segment[0] != 8)
+        return false;
+    m_height = ReadU16(segment + 1);
+    m_width = ReadU16(segment + 3);
+    m_componentCount = segment[5];
+    if (m_width == 0 || m_height == 0 || static_cast<size_t>(m_width) * m_height > MAX_JPEG_PIXELS)
+        return false;
+    if ((m_componentCount != 1 && m_componentCount != 3) || length < 6 + static_cast<size_t>(m_componentCount) * 3)
+        return false;
+
+    m_hmax = 1;
+    m_vmax = 1;
+    for (int c = 0; c < m_componentCount; ++c)
+    {
+        JpegComponent& component = m_components[c];
+        const uint8_t* spec = segment + 6 + c * 3;
+        component.id = spec[0];
+        component.h = m_componentCount == 1 ? 1 : spec[1] >> 4;
+        component.v = m_componentCount == 1 ? 1 : spec[1] & 15;
+        component.quantTable = spec[2];
+        if (component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 || component.quantTable > 3)
+            return false;
+        m_hmax = std::max(m_hmax, component.h);
+        m_vmax = std::max(m_vmax, component.v);
+    }
+
+    m_mcusX = (m_width + 8 * m_hmax - 1) / (8 * m_hmax);
+    m_mcusY = (m_height + 8 * m_vmax - 1) / (8 * m_vmax);
+    for (int c = 0; c < m_componentCount; ++c)
+    {
+        JpegComponent& component = m_components[c];
+        component.blocksPerLine = m_mcusX * component.h;
+        component.blocksPerColumn = m_mcusY * component.v;
+        component.usedBlocksX = ((m_width * component.h + m_hmax - 1) / m_hmax + 7) / 8;
+        component.usedBlocksY = ((m_height * component.v + m_vmax - 1) / m_vmax + 7) / 8;
+        component.coefficients.assign(static_cast<size_t>(component.blocksPerLine) * component.blocksPerColumn * 64, 0);
+    }
+    return true;
+}
+
+/**
+ * @brief Décode un bloc selon le type du scan en cours
+ */
+void JpegFrame::DecodeBlock(JpegBits& bits, JpegComponent& component, int16_t* block)
+{
+    const JpegHuffman& dc = m_dcTables[component.dcTable];
+    const JpegHuffman& ac = m_acTables[component.acTable];
+
+    if (!m_progressive)
+    {
+        // Différence DC sur 15 bits au plus ; le prédicteur reste sur 16 bits
+        const int dcBits = dc.Decode(bits) & 15;
+        component.dcPredictor = static_cast<int16_t>(component.dcPredictor + (dcBits ? bits.Signed(dcBits) : 0));
+        block[0] = static_cast<int16_t>(component.dcPredictor);
+        for (int k = 1; k < 64; )
+        {
+            const int symbol = ac.Decode(bits);
+            const int run = symbol >> 4;
+            const int magnitude = symbol & 15;
+            if (magnitude)
+            {
+                k += run;
+                block[ZIGZAG[k]] = static_cast<int16_t>(bits.Signed(magnitude));
+                ++k;
+            }
+            else if (run == 15)
+            {
+                k += 16;
+            }
+            else
+            {
+                break;
+            }
+        }
+        return;
+    }
+
+    if (m_spectralStart == 0)
+    {
+        // Scan DC : première passe ou bit de raffinement
+        if (m_approxHigh == 0)
+        {
+            const int dcBits = dc.Decode(bits) & 15;
+            component.dcPredictor = static_cast<int16_t>(component.dcPredictor + (dcBits ? bits.Signed(dcBits) : 0));
+            block[0] = static_cast<int16_t>(component.dcPredictor * (1 << m_approxLow));
+        }
+        else if (bits.Bits(1))
+        {
+            block[0] = static_cast<int16_t>(block[0] | (1 << m_approxLow));
+        }
+        return;
+    }
+
+    if (m_approxHigh == 0)
+    {
+        // Première passe AC, avec séries de blocs vides (EOBRUN)
+        if (m_eobRun > 0)
+        {
+            --m_eobRun;
+            return;
+        }
+        for (int k = m_spectralStart; k <= m_spectralEnd; )
+        {
+            const int symbol = ac.Decode(bits);
+            const int run = symbol >> 4;
+            const int magnitude = symbol & 15;
+            if (magnitude)
+            {
+                k += run;
+                block[ZIGZAG[k]] = static_cast<int16_t>(bits.Signed(magnitude) * (1 << m_approxLow));
+                ++k;
+            }
+            else if (run == 15)
+            {
+                k += 16;
+            }
+            else
+            {
+                m_eobRun = (1 << run) - 1 + bits.Bits(run);
+                break;
+            }
+        }
+        return;
+    }
+
+    // Raffinement AC : un bit de plus pour les coefficients déjà non nuls,
+    // nouveaux coefficients à +-1 placés après run coefficients nuls
+    const int plus = 1 << m_approxLow;
+    const int minus = -plus;
+    int k = m_spectralStart;
+    if (m_eobRun == 0)
+    {
+        for (; k <= m_spectralEnd; ++k)
+        {
+            const int symbol = ac.Decode(bits);
+            int run = symbol >> 4;
+            int value = 0;
+            if (symbol & 15)
+            {
+                value = bits.Bits(1) ? plus : minus;
+            }
+            else if (run != 15)
+            {
+                m_eobRun = (1 << run) + bits.Bits(run);
+                break;
+            }
+
+            do
+            {
+                int16_t& coefficient = block[ZIGZAG[k]];
+                if (coefficient != 0)
+                {
+                    if (bits.Bits(1) && (coefficient & plus) == 0)
+                        coefficient = static_cast<int16_t>(coefficient + (coefficient >= 0 ? plus : minus));
+                }
+                else if (--run < 0)
+                {
+                    break;
+                }
+                ++k;
+            } while (k <= m_spectralEnd);
+
+            if (value)
+                block[ZIGZAG[k]] = static_cast<int16_t>(value);
+        }
+    }
+
+    if (m_eobRun > 0)
+    {
+        for (; k <= m_spectralEnd; ++k)
+        {
+            int16_t& coefficient = block[ZIGZAG[k]];
+            if (coefficient != 0 && bits.Bits(1) && (coefficient & plus) == 0)
+                coefficient = static_cast<int16_t>(coefficient + (coefficient >= 0 ? plus : minus));
+        }
+        --m_eobRun;
+    }
+}
+
+/**
+ * @brief Segment SOS et données du scan qui le suivent
+ * @param pos Début du segment ; en sortie, position du marqueur suivant
+ */
+bool JpegFrame::DecodeScan(const uint8_t* data, size_t size, size_t& pos, size_t length)
+{
+    const uint8_t* segment = data + pos;
+    const int count = segment[0];
+    if (count < 1 || count > m_componentCount || length < 4 + static_cast<size_t>(count) * 2)
+        return false;
+
+    JpegComponent* scan[MAX_COMPONENTS];
+    for (int i = 0; i < count; ++i)
+    {
+        const int id = segment[1 + i * 2];
+        const int tables = segment[2 + i * 2];
+        scan[i] = nullptr;
+        for (int c = 0; c < m_componentCount; ++c)
+        {
+            if (m_components[c].id == id)
+                scan[i] = &m_components[c];
+        }
+        if (!scan[i])
+            return false;
+        scan[i]->dcTable = (tables >> 4) & 3;
+        scan[i]->acTable = tables & 3;
+        scan[i]->dcPredictor = 0;
+    }
+
+    const uint8_t* progression = segment + 1 + count * 2;
+    m_spectralStart = progression[0];
+    m_spectralEnd = progression[1];
+    m_approxHigh = progression[2] >> 4;
+    m_approxLow = progression[2] & 15;
+    m_eobRun = 0;
+    if (!m_progressive)
+    {
+        m_spectralStart = 0;
+        m_spectralEnd = 63;
+        m_approxHigh = 0;
+        m_approxLow = 0;
+    }
+    if (m_spectralEnd > 63 || m_spectralStart > m_spectralEnd || m_approxLow > 13 ||
+        (m_spectralStart > 0 && count != 1))
+        return false;
+
+    // Tables utilisées par ce scan
+    const bool needsDc = !m_progressive || (m_spectralStart == 0 && m_approxHigh == 0);
+    const bool needsAc = !m_progressive || m_spectralStart > 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if ((needsDc && !m_dcTables[scan[i]->dcTable].defined) || (needsAc && !m_acTables[scan[i]->acTable].defined))
+            return false;
+    }
+
+    const size_t scanStart = pos + length;
+    JpegBits bits(data, size, scanStart);
+    int untilRestart = m_restartInterval;
+
+    // Un scan à une composante parcourt ses blocs un à un, sinon par MCU
+    const int unitsX = count == 1 ? scan[0]->usedBlocksX : m_mcusX;
+    const int unitsY = count == 1 ? scan[0]->usedBlocksY : m_mcusY;
+    for (int unitY = 0; unitY < unitsY; ++unitY)
+    {
+        for (int unitX = 0; unitX < unitsX; ++unitX)
+        {
+            if (m_restartInterval)
+            {
+                if (untilRestart == 0)
+                {
+                    bits.Restart();
+                    for (int i = 0; i < count; ++i)
+                    {
+                        scan[i]->dcPredictor = 0;
+                    }
+                    m_eobRun = 0;
+                    untilRestart = m_restartInterval;
+                }
+                --untilRestart;
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+                JpegComponent& component = *scan[i];
+                const int blocksX = count == 1 ? 1 : component.h;
+                const int blocksY = count == 1 ? 1 : component.v;
+                for (int by = 0; by < blocksY; ++by)
+                {
+                    for (int bx = 0; bx < blocksX; ++bx)
+                    {
+                        const int blockX = unitX * blocksX + bx;
+                        const int blockY = unitY * blocksY + by;
+                        int16_t* block = component.coefficients.data() +
+                                         (static_cast<size_t>(blockY) * component.blocksPerLine + blockX) * 64;
+                        DecodeBlock(bits, component, block);
+                    }
+                }
+            }
+        }
+    }
+
+    pos = bits.ResumePosition(scanStart);
+    return true;
+}
+
+#if defined(JPEG_DECODER_SSE2)
+
+/**
+ * @struct Float4
+ * @brief Quatre flottants, pour écrire la transformée une seule fois
+ */
+struct Float4
+{
+    __m128 v;
+
+    Float4() {}
+    Float4(__m128 value) : v(value) {}
+    explicit Float4(float value) : v(_mm_set1_ps(value)) {}
+};
+
+static inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+static inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+static inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+
+#endif // JPEG_DECODER_SSE2
+
+/**
+ * @brief Transformée inverse 1D de 8 points (AAN, sortie de jidctflt.c)
+ *
+ * Entrées pré-multipliées par les facteurs AAN_SCALE (voir PrepareQuant).
+ */
+template <typename V>
+static inline void Idct8(const V* in, V* out)
+{
+    // Partie paire
+    V tmp10 = in[0] + in[4];
+    V tmp11 = in[0] - in[4];
+    V tmp13 = in[2] + in[6];
+    V tmp12 = (in[2] - in[6]) * V(1.414213562f) - tmp13;
+
+    V tmp0 = tmp10 + tmp13;
+    V tmp3 = tmp10 - tmp13;
+    V tmp1 = tmp11 + tmp12;
+    V tmp2 = tmp11 - tmp12;
+
+    // Partie impaire
+    V z13 = in[5] + in[3];
+    V z10 = in[5] - in[3];
+    V z11 = in[1] + in[7];
+    V z12 = in[1] - in[7];
+
+    V tmp7 = z11 + z13;
+    V odd11 = (z11 - z13) * V(1.414213562f);
+    V z5 = (z10 + z12) * V(1.847759065f);
+    V odd10 = z12 * V(1.082392200f) - z5;
+    V odd12 = z10 * V(-2.613125930f) + z5;
+
+    V tmp6 = odd12 - tmp7;
+    V tmp5 = odd11 - tmp6;
+    V tmp4 = odd10 + tmp5;
+
+    out[0] = tmp0 + tmp7;
+    out[7] = tmp0 - tmp7;
+    out[1] = tmp1 + tmp6;
+    out[6] = tmp1 - tmp6;
+    out[2] = tmp2 + tmp5;
+    out[5] = tmp2 - tmp5;
+    out[4] = tmp3 + tmp4;
+    out[3] = tmp3 - tmp4;
+}
+
+/**
+ * @brief Table de quantification multipliée par les facteurs AAN et 1/8
+ */
+static void PrepareQuant(const uint16_t* quant, float* scaled)
+{
+    for (int row = 0; row < 8; ++row)
+    {
+        for (int col = 0; col < 8; ++col)
+        {
+            scaled[row * 8 + col] = static_cast<float>(quant[row * 8 + col] * AAN_SCALE[row] * AAN_SCALE[col] * 0.125);
+        }
+    }
+}
+
+/**
+ * @brief Échantillon final : recentré sur 128, arrondi et borné
+ */
+static inline uint8_t ClampSample(float value)
+{
+    return static_cast<uint8_t>(static_cast<int>(std::min(std::max(value + 128.5f, 0.0f), 255.0f)));
+}
+
+#if !defined(JPEG_DECODER_SSE2)
+
+/**
+ * @brief Transformée inverse d'un bloc (colonnes puis lignes)
+ */
+static void IdctBlockScalar(const int16_t* block, const float* quant, uint8_t* out, int pitch)
+{
+    float workspace[64];
+    for (int col = 0; col < 8; ++col)
+    {
+        float in[8];
+        float result[8];
+        for (int row = 0; row < 8; ++row)
+        {
+            in[row] = block[row * 8 + col] * quant[row * 8 + col];
+        }
+        Idct8(in, result);
+        for (int row = 0; row < 8; ++row)
+        {
+            workspace[row * 8 + col] = result[row];
+        }
+    }
+
+    for (int row = 0; row < 8; ++row)
+    {
+        float result[8];
+        Idct8(workspace + row * 8, result);
+        for (int col = 0; col < 8; ++col)
+        {
+            out[row * pitch + col] = ClampSample(result[col]);
+        }
+    }
+}
+
+#else
+
+/**
+ * @brief Transformée inverse d'un bloc, quatre colonnes puis quatre lignes
+ * à la fois (mêmes opérations, dans le même ordre, que la version scalaire)
+ */
+static void IdctBlockSse2(const int16_t* block, const float* quant, uint8_t* out, int pitch)
+{
+    // Colonnes : deux moitiés de quatre colonnes
+    __m128 workspace[8][2];
+    for (int half = 0; half < 2; ++half)
+    {
+        Float4 in[8];
+        Float4 result[8];
+        for (int row = 0; row < 8; ++row)
+        {
+            __m128i values = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block + row * 8 + half * 4));
+            __m128 coefficients = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16));
+            in[row] = _mm_mul_ps(coefficients, _mm_loadu_ps(quant + row * 8 + half * 4));
+        }
+        Idct8(in, result);
+        for (int row = 0; row < 8; ++row)
+        {
+            workspace[row][half] = result[row].v;
+        }
+    }
+
+    // Lignes : après transposition, in[col] contient quatre lignes
+    for (int rows = 0; rows < 8; rows += 4)
+    {
+        Float4 in[8] = { workspace[rows][0], workspace[rows + 1][0], workspace[rows + 2][0], workspace[rows + 3][0],
+                         workspace[rows][1], workspace[rows + 1][1], workspace[rows + 2][1], workspace[rows + 3][1] };
+        _MM_TRANSPOSE4_PS(in[0].v, in[1].v, in[2].v, in[3].v);
+        _MM_TRANSPOSE4_PS(in[4].v, in[5].v, in[6].v, in[7].v);
+        Float4 result[8];
+        Idct8(in, result);
+        _MM_TRANSPOSE4_PS(result[0].v, result[1].v, result[2].v, result[3].v);
+        _MM_TRANSPOSE4_PS(result[4].v, result[5].v, result[6].v, result[7].v);
+
+        const __m128 center = _mm_set1_ps(128.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 maxValue = _mm_set1_ps(255.0f);
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128 left = _mm_min_ps(_mm_max_ps(_mm_add_ps(result[i].v, center), zero), maxValue);
+            __m128 right = _mm_min_ps(_mm_max_ps(_mm_add_ps(result[i + 4].v, center), zero), maxValue);
+            __m128i words = _mm_packs_epi32(_mm_cvttps_epi32(left), _mm_cvttps_epi32(right));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + (rows + i) * pitch), _mm_packus_epi16(words, words));
+        }
+    }
+}
+
+#endif // JPEG_DECODER_SSE2
+
+/**
+ * @brief Pixel RGBA depuis Y, Cb et Cr (JFIF, arrondi au plus proche)
+ */
+static inline void YCbCrToRgba(int y, int cb, int cr, uint8_t* out)
+{
+    const float luma = static_cast<float>(y);
+    const float blue = static_cast<float>(cb - 128);
+    const float red = static_cast<float>(cr - 128);
+    out[0] = static_cast<uint8_t>(static_cast<int>(std::min(std::max(luma + 1.402f * red + 0.5f, 0.0f), 255.0f)));
+    out[1] = static_cast<uint8_t>(static_cast<int>(
+        std::min(std::max(luma - 0.344136f * blue - 0.714136f * red + 0.5f, 0.0f), 255.0f)));
+    out[2] = static_cast<uint8_t>(static_cast<int>(std::min(std::max(luma + 1.772f * blue + 0.5f, 0.0f), 255.0f)));
+    out[3] = 255;
+}
+
+/**
+ * @brief Convertit une ligne YCbCr en RGBA
+ */
+static void YCbCrRowToRgba(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, int count, uint8_t* out)
+{
+    int x = 0;
+#if defined(JPEG_DECODER_SSE2)
+    // Quatre pixels par tour, calcul identique à YCbCrToRgba
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi32(128);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 low = _mm_setzero_ps();
+    const __m128 high = _mm_set1_ps(255.0f);
+    for (; x + 4 <= count; x += 4)
+    {
+        uint32_t packed[3];
+        memcpy(&packed[0], y + x, 4);
+        memcpy(&packed[1], cb + x, 4);
+        memcpy(&packed[2], cr + x, 4);
+        __m128i yi = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(packed[0])), zero), zero);
+        __m128i cbi = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(packed[1])), zero), zero);
+        __m128i cri = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(packed[2])), zero), zero);
+        __m128 luma = _mm_cvtepi32_ps(yi);
+        __m128 blue = _mm_cvtepi32_ps(_mm_sub_epi32(cbi, offset));
+        __m128 red = _mm_cvtepi32_ps(_mm_sub_epi32(cri, offset));
+
+        __m128 r = _mm_add_ps(_mm_add_ps(luma, _mm_mul_ps(_mm_set1_ps(1.402f), red)), half);
+        __m128 g = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(luma, _mm_mul_ps(_mm_set1_ps(0.344136f), blue)),
+                                         _mm_mul_ps(_mm_set1_ps(0.714136f), red)), half);
+        __m128 b = _mm_add_ps(_mm_add_ps(luma, _mm_mul_ps(_mm_set1_ps(1.772f), blue)), half);
+        __m128i ri = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(r, low), high));
+        __m128i gi = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(g, low), high));
+        __m128i bi = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(b, low), high));
+
+        // Octets R, G, B, A d'un pixel dans chaque mot de 32 bits
+        __m128i pixels = _mm_or_si128(_mm_or_si128(ri, _mm_slli_epi32(gi, 8)),
+                                      _mm_or_si128(_mm_slli_epi32(bi, 16), alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), pixels);
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        YCbCrToRgba(y[x], cb[x], cr[x], out + x * 4);
+    }
+}
+
+/**
+ * @brief Ligne d'une composante ramenée à la pleine résolution (réplication)
+ */
+static void UpsampleRow(const uint8_t* src, int h, int hmax, int width, uint8_t* dst)
+{
+    if (h == hmax)
+    {
+        memcpy(dst, src, width);
+        return;
+    }
+
+    int x = 0;
+    if (hmax == 2 * h)
+    {
+#if defined(JPEG_DECODER_SSE2)
+        for (; x + 32 <= width; x += 32)
+        {
+            __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x / 2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_unpacklo_epi8(samples, samples));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 16), _mm_unpackhi_epi8(samples, samples));
+        }
+#endif
+        for (; x < width; ++x)
+        {
+            dst[x] = src[x >> 1];
+        }
+        return;
+    }
+
+    for (; x < width; ++x)
+    {
+        dst[x] = src[x * h / hmax];
+    }
+}
+
+/**
+ * @brief Convertit une ligne en niveaux de gris en RGBA
+ */
+static void GrayRowToRgba(const uint8_t* gray, int count, uint8_t* out)
+{
+    int x = 0;
+#if defined(JPEG_DECODER_SSE2)
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    for (; x + 16 <= count; x += 16)
+    {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gray + x));
+        __m128i low = _mm_unpacklo_epi8(samples, samples);
+        __m128i high = _mm_unpackhi_epi8(samples, samples);
+        __m128i* dst = reinterpret_cast<__m128i*>(out + x * 4);
+        _mm_storeu_si128(dst, _mm_or_si128(_mm_unpacklo_epi16(low, low), alpha));
+        _mm_storeu_si128(dst + 1, _mm_or_si128(_mm_unpackhi_epi16(low, low), alpha));
+        _mm_storeu_si128(dst + 2, _mm_or_si128(_mm_unpacklo_epi16(high, high), alpha));
+        _mm_storeu_si128(dst + 3, _mm_or_si128(_mm_unpackhi_epi16(high, high), alpha));
+    }
+#endif
+    for (; x < count; ++x)
+    {
+        out[x * 4 + 0] = out[x * 4 + 1] = out[x * 4 + 2] = gray[x];
+        out[x * 4 + 3] = 255;
+    }
+}
+
+/**
+ * @brief Vrai si seul le coefficient DC du bloc est non nul
+ *
+ * La transformée d'un tel bloc est constante : c'est le cas de la plupart
+ * des blocs de chrominance.
+ */
+static bool HasOnlyDc(const int16_t* block)
+{
+#if defined(JPEG_DECODER_SSE2)
+    const __m128i* rows = reinterpret_cast<const __m128i*>(block);
+    __m128i any = _mm_and_si128(_mm_loadu_si128(rows), _mm_set_epi16(-1, -1, -1, -1, -1, -1, -1, 0));
+    for (int i = 1; i < 8; ++i)
+    {
+        any = _mm_or_si128(any, _mm_loadu_si128(rows + i));
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xFFFF;
+#else
+    for (int i = 1; i < 64; ++i)
+    {
+        if (block[i])
+            return false;
+    }
+    return true;
+#endif
+}
+
+/**
+ * @brief Transformée inverse de toutes les composantes, puis pixels RGBA
+ */
+void JpegFrame::Finish(std::vector<uint8_t>& rgba)
+{
+    for (int c = 0; c < m_componentCount; ++c)
+    {
+        JpegComponent& component = m_components[c];
+        float quant[64];
+        PrepareQuant(m_quant[component.quantTable], quant);
+
+        const int pitch = component.blocksPerLine * 8;
+        component.samples.resize(static_cast<size_t>(pitch) * component.blocksPerColumn * 8);
+        for (int by = 0; by < component.blocksPerColumn; ++by)
+        {
+            for (int bx = 0; bx < component.blocksPerLine; ++bx)
+            {
+                const int16_t* block = component.coefficients.data() +
+                                       (static_cast<size_t>(by) * component.blocksPerLine + bx) * 64;
+                uint8_t* out = component.samples.data() + static_cast<size_t>(by) * 8 * pitch + bx * 8;
+                if (HasOnlyDc(block))
+                {
+                    // Même résultat que la transformée complète, sans la calculer
+                    const uint8_t value = ClampSample(block[0] * quant[0]);
+                    for (int row = 0; row < 8; ++row)
+                    {
+                        memset(out + row * pitch, value, 8);
+                    }
+                    continue;
+                }
+#if defined(JPEG_DECODER_SSE2)
+                IdctBlockSse2(block, quant, out, pitch);
+#else
+                IdctBlockScalar(block, quant, out, pitch);
+#endif
+            }
+        }
+        std::vector<int16_t>().swap(component.coefficients);
+    }
+
+    rgba.resize(static_cast<size_t>(m_width) * m_height * 4);
+    std::vector<uint8_t> rows(static_cast<size_t>(m_width) * MAX_COMPONENTS);
+    for (int y = 0; y < m_height; ++y)
+    {
+        uint8_t* out = rgba.data() + static_cast<size_t>(y) * m_width * 4;
+        for (int c = 0; c < m_componentCount; ++c)
+        {
+            const JpegComponent& component = m_components[c];
+            const int pitch = component.blocksPerLine * 8;
+            const uint8_t* src = component.samples.data() + static_cast<size_t>(y * component.v / m_vmax) * pitch;
+            UpsampleRow(src, component.h, m_hmax, m_width, rows.data() + c * m_width);
+        }
+
+        const uint8_t* first = rows.data();
+        if (m_componentCount == 1)
+        {
+            GrayRowToRgba(first, m_width, out);
+        }
+        else if (m_adobeRgb)
+        {
+            for (int x = 0; x < m_width; ++x)
+            {
+                out[x * 4 + 0] = first[x];
+                out[x * 4 + 1] = first[m_width + x];
+                out[x * 4 + 2] = first[2 * m_width + x];
+                out[x * 4 + 3] = 255;
+            }
+        }
+        else
+        {
+            YCbCrRowToRgba(first, first + m_width, first + 2 * m_width, m_width, out);
+        }
+    }
+}
+
+/**
+ * @brief Parcourt les marqueurs du fichier et décode les scans
+ */
+bool JpegFrame::Decode(const uint8_t* data, size_t size, std::vector<uint8_t>& rgba, int& width, int& height)
+{
+    bool hasFrame = false;
+    bool hasScan = false;
+    size_t pos = 2;
+    while (pos + 4 <= size)
+    {
+        if (data[pos] != 0xFF)
+        {
+            ++pos;      // Octets parasites entre deux segments
+            continue;
+        }
+        const int marker = data[pos + 1];
+        if (marker == 0xFF || marker == 0x00 || (marker >= 0xD0 && marker <= 0xD7))
+        {
+            ++pos;
+            continue;
+        }
+        if (marker == 0xD9)
+            break;
+
+        const size_t length = static_cast<size_t>(ReadU16(data + pos + 2));
+        if (length < 2 || pos + 2 + length > size)
+            break;
+        const uint8_t* segment = data + pos + 4;
+        const size_t bodyLength = length - 2;
+
+        switch (marker)
+        {
+        case 0xC0:
+        case 0xC1:
+        case 0xC2:
+            if (hasFrame)
+                return false;
+            m_progressive = marker == 0xC2;
+            if (!ReadFrameHeader(segment, bodyLength))
+                return false;
+            hasFrame = true;
+            break;
+
+        case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+        case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+            return false;   // Sans perte, hiérarchique ou codage arithmétique
+
+        case 0xC4:
+            if (!ReadHuffmanTables(segment, bodyLength))
+                return false;
+            break;
+
+        case 0xDB:
+            if (!ReadQuantTables(segment, bodyLength))
+                return false;
+            break;
+
+        case 0xDD:
+            if (bodyLength < 2)
+                return false;
+            m_restartInterval = ReadU16(segment);
+            break;
+
+        case 0xEE:
+            // APP14 Adobe : transformée 0 = composantes RGB sans conversion
+            if (bodyLength >= 12 && memcmp(segment, "Adobe", 5) == 0)
+                m_adobeRgb = segment[11] == 0;
+            break;
+
+        case 0xDA:
+        {
+            if (!hasFrame)
+                return false;
+            size_t scanPos = pos + 4;
+            if (!DecodeScan(data, size, scanPos, bodyLength))
+                return false;
+            hasScan = true;
+            pos = scanPos;
+            continue;
+        }
+
+        default:
+            break;
+        }
+        pos += 2 + length;
+    }
+
+    if (!hasScan)
+        return false;
+
+    width = m_width;
+    height = m_height;
+    Finish(rgba);
+    return true;
+}
+
+/**
+ * @brief Décode une image JPEG
+ */
+bool DecodeJpeg(const uint8_t* data, size_t size, std::vector<uint8_t>& rgba, int& width, int& height)
+{
+    if (!IsJpeg(data, size))
+        return false;
+    JpegFrame frame;
+    return frame.Decode(data, size, rgba, width, height);
+}
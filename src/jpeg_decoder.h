@@ -0,0 +1,41 @@
+/**
+ * @file jpeg_decoder.h
+ * @brief Décodage des images JPEG en pixels RGBA
+ *
+ * JPEG baseline et progressif (codage de Huffman), niveaux de gris ou
+ * YCbCr avec sous-échantillonnage quelconque. La transformée inverse (AAN
+ * en flottants) et la conversion YCbCr -> RGB traitent quatre lignes ou
+ * quatre pixels par instruction en SSE2 ; les versions scalaires donnent
+ * exactement les mêmes octets.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef JPEG_DECODER_H
+#define JPEG_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Vérifie la signature JPEG (marqueur SOI)
+ */
+bool IsJpeg(const uint8_t* data, size_t size);
+
+/**
+ * @brief Décode une image JPEG
+ * @param data Contenu du fichier
+ * @param size Taille des données
+ * @param rgba Pixels RGBA, ligne par ligne (sortie)
+ * @param width Largeur (sortie)
+ * @param height Hauteur (sortie)
+ * @return false si le fichier n'est pas un JPEG lisible (codage
+ *         arithmétique, sans perte, CMJN...)
+ *
+ * Comme pour les GIF, un fichier tronqué donne une image partielle : les
+ * blocs manquants sont gris.
+ */
+bool DecodeJpeg(const uint8_t* data, size_t size, std::vector<uint8_t>& rgba, int& width, int& height);
+
+#endif // JPEG_DECODER_H
@@ -100,56 +100,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;   // Navigation clavier
     io.IniFilename = nullptr;                                // Pas de fichier de configuration
 
-    // Configuration du style visuel - thème moderne violet/rose
-    ImGuiStyle& style = ImGui::GetStyle();
-    style.WindowRounding = 15.0f;
-    style.FrameRounding = 10.0f;
-    style.GrabRounding = 8.0f;
-    style.ScrollbarRounding = 10.0f;
-    style.TabRounding = 8.0f;
-    style.ChildRounding = 12.0f;
-    style.PopupRounding = 12.0f;
-    style.WindowPadding = ImVec2(15, 15);
-    style.FramePadding = ImVec2(12, 6);
-    style.ItemSpacing = ImVec2(10, 8);
-    style.ScrollbarSize = 12.0f;
-    style.GrabMinSize = 10.0f;
-
-    // Couleurs modernes - palette violet/rose/doré
-    ImVec4* colors = style.Colors;
-    colors[ImGuiCol_WindowBg]           = ImVec4(0.08f, 0.06f, 0.12f, 1.00f);   // Violet très foncé
-    colors[ImGuiCol_ChildBg]            = ImVec4(0.10f, 0.08f, 0.15f, 0.90f);
-    colors[ImGuiCol_PopupBg]            = ImVec4(0.12f, 0.10f, 0.18f, 0.98f);
-    colors[ImGuiCol_Border]             = ImVec4(0.50f, 0.35f, 0.55f, 0.40f);
-    colors[ImGuiCol_BorderShadow]       = ImVec4(0.00f, 0.00f, 0.00f, 0.00f);
-    colors[ImGuiCol_FrameBg]            = ImVec4(0.15f, 0.12f, 0.22f, 1.00f);
-    colors[ImGuiCol_FrameBgHovered]     = ImVec4(0.22f, 0.18f, 0.30f, 1.00f);
-    colors[ImGuiCol_FrameBgActive]      = ImVec4(0.28f, 0.22f, 0.38f, 1.00f);
-    colors[ImGuiCol_TitleBg]            = ImVec4(0.12f, 0.10f, 0.18f, 1.00f);
-    colors[ImGuiCol_TitleBgActive]      = ImVec4(0.18f, 0.14f, 0.25f, 1.00f);
-    colors[ImGuiCol_MenuBarBg]          = ImVec4(0.12f, 0.10f, 0.18f, 1.00f);
-    colors[ImGuiCol_ScrollbarBg]        = ImVec4(0.08f, 0.06f, 0.12f, 0.60f);
-    colors[ImGuiCol_ScrollbarGrab]      = ImVec4(0.40f, 0.30f, 0.50f, 1.00f);
-    colors[ImGuiCol_ScrollbarGrabHovered] = ImVec4(0.50f, 0.40f, 0.60f, 1.00f);
-    colors[ImGuiCol_ScrollbarGrabActive]  = ImVec4(0.60f, 0.50f, 0.70f, 1.00f);
-    colors[ImGuiCol_CheckMark]          = ImVec4(1.00f, 0.70f, 0.40f, 1.00f);   // Doré
-    colors[ImGuiCol_SliderGrab]         = ImVec4(0.90f, 0.60f, 0.35f, 1.00f);
-    colors[ImGuiCol_SliderGrabActive]   = ImVec4(1.00f, 0.70f, 0.45f, 1.00f);
-    colors[ImGuiCol_Button]             = ImVec4(0.45f, 0.30f, 0.50f, 1.00f);
-    colors[ImGuiCol_ButtonHovered]      = ImVec4(0.55f, 0.40f, 0.60f, 1.00f);
-    colors[ImGuiCol_ButtonActive]       = ImVec4(0.65f, 0.50f, 0.70f, 1.00f);
-    colors[ImGuiCol_Header]             = ImVec4(0.35f, 0.25f, 0.45f, 1.00f);
-    colors[ImGuiCol_HeaderHovered]      = ImVec4(0.45f, 0.35f, 0.55f, 1.00f);
-    colors[ImGuiCol_HeaderActive]       = ImVec4(0.50f, 0.40f, 0.60f, 1.00f);
-    colors[ImGuiCol_Tab]                = ImVec4(0.25f, 0.18f, 0.32f, 1.00f);
-    colors[ImGuiCol_TabHovered]         = ImVec4(0.45f, 0.35f, 0.55f, 1.00f);
-    colors[ImGuiCol_TabActive]          = ImVec4(0.38f, 0.28f, 0.48f, 1.00f);
-    colors[ImGuiCol_Text]               = ImVec4(0.95f, 0.92f, 0.98f, 1.00f);   // Blanc légèrement rose
-    colors[ImGuiCol_TextDisabled]       = ImVec4(0.55f, 0.50f, 0.60f, 1.00f);
-    colors[ImGuiCol_PlotLines]          = ImVec4(1.00f, 0.70f, 0.40f, 1.00f);
-    colors[ImGuiCol_PlotLinesHovered]   = ImVec4(1.00f, 0.80f, 0.50f, 1.00f);
-    colors[ImGuiCol_TextSelectedBg]     = ImVec4(0.50f, 0.35f, 0.60f, 0.50f);
-    colors[ImGuiCol_ModalWindowDimBg]   = ImVec4(0.05f, 0.03f, 0.08f, 0.70f);
+    // Thème visuel (partagé avec le pilote headless)
+    ChatWindow::ApplyStyle();
 
     // Initialisation des backends ImGui
     ImGui_ImplWin32_Init(hwnd);
@@ -184,7 +136,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         if (!running)
             break;
 
-        // Début d'une nouvelle frame ImGui
+        // Début d'une nouvelle frame ImGui (les textes de la frame
+        // précédente ont été recopiés dans ses listes de dessin)
+        chatWindow->BeginFrame();
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
@@ -8,8 +8,10 @@
  * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie 
  */
 
+#ifdef _WIN32
 #include <windows.h>
 #include <winhttp.h>
+#endif
 
 // Désactivation des macros Windows conflictuelles
 // SendMessage est une macro définie dans windows.h qui interfère avec notre méthode
@@ -18,18 +20,339 @@
 #endif
 
 #include "matrix_client.h"
+#include "event_registry.h"
+#include "frame_profiler.h"
 #include <nlohmann/json.hpp>
 #include <random>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
 
 using json = nlohmann::json;
 
+// DOM des réponses de sync : noeuds, tableaux, objets et chaînes sont alloués
+// dans l'arène du lot (BatchArena) et libérés en bloc après traitement
+using BatchString = std::basic_string<char, std::char_traits<char>, BatchAllocator<char>>;
+using BatchJson = nlohmann::basic_json<std::map, std::vector, BatchString, bool,
+                                       std::int64_t, std::uint64_t, double, BatchAllocator>;
+
 // URL par défaut du serveur Matrix
 // Serveur accessible via Cloudflare Tunnel
 static const std::string DEFAULT_HOMESERVER = "https://matrix.buffertavern.com";
 
+// Capacité de la file de mises à jour sync -> UI
+static const size_t DELTA_QUEUE_CAPACITY = 1024;
+
+// Délai de regroupement des accusés de lecture : on attend que l'utilisateur
+// reste sur le salon avant d'envoyer, sans dépasser le délai maximum
+static const auto RECEIPT_DEBOUNCE = std::chrono::milliseconds(500);
+static const auto RECEIPT_MAX_DELAY = std::chrono::milliseconds(2000);
+
+// Nombre de lots de synchronisation dont les réponses brutes restent
+// référencées par les messages avant recopie dans l'arène des salons
+static const uint32_t RETAINED_SYNC_BATCHES = 2;
+
+/**
+ * @struct TrackingIterator
+ * @brief Itérateur sur la réponse brute qui publie sa position de lecture
+ * 
+ * Permet de retrouver, pendant le parsing, l'emplacement exact d'une
+ * chaîne JSON dans la réponse d'origine.
+ */
+struct TrackingIterator
+{
+    using iterator_category = std::input_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = const char&;
+
+    const char* ptr;
+    const char** cursor;    // Position juste après le dernier caractère lu
+
+    reference operator*() const { return *ptr; }
+    TrackingIterator& operator++() { *cursor = ++ptr; return *this; }
+    TrackingIterator operator++(int) { TrackingIterator copy = *this; ++*this; return copy; }
+    bool operator==(const TrackingIterator& other) const { return ptr == other.ptr; }
+    bool operator!=(const TrackingIterator& other) const { return ptr != other.ptr; }
+};
+
+/**
+ * @struct BodySpan
+ * @brief Position d'un corps de message dans la réponse brute
+ */
+struct BodySpan
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+/**
+ * @brief Retourne une chaîne d'un objet JSON sans la recopier
+ * @return Vue vide si la clé est absente ou n'est pas une chaîne
+ */
+static std::string_view StringField(const BatchJson& object, const char* key)
+{
+    auto it = object.find(key);
+    if (it == object.end() || !it->is_string())
+        return std::string_view();
+
+    const BatchString& value = it->get_ref<const BatchString&>();
+    return std::string_view(value.data(), value.size());
+}
+
+/**
+ * @struct NodeTable
+ * @brief Valeurs attachées à des chaînes du DOM, hors du DOM
+ * 
+ * La clé est l'adresse de la chaîne : nlohmann::basic_json la garde sur le
+ * tas et la déplace avec le noeud, elle ne change donc pas entre le callback
+ * du parseur et le parcours du DOM. Le JSON lui-même n'est jamais modifié :
+ * une valeur envoyée par le serveur ne peut pas se faire passer pour une
+ * entrée de la table.
+ */
+template <typename T>
+struct NodeTable
+{
+    using Entry = std::pair<const BatchString*, T>;
+    std::vector<Entry, BatchAllocator<Entry>> entries;
+
+    void Add(const BatchString* node, const T& value) { entries.emplace_back(node, value); }
+
+    /**
+     * @brief Trie les entrées (à appeler une fois le parsing terminé)
+     */
+    void Seal()
+    {
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry& a, const Entry& b) { return std::less<const BatchString*>()(a.first, b.first); });
+    }
+
+    /**
+     * @brief Valeur attachée au noeud (nullptr si ce n'est pas une chaîne enregistrée)
+     */
+    const T* Find(const BatchJson& node) const
+    {
+        if (!node.is_string())
+            return nullptr;
+        const BatchString* key = &node.get_ref<const BatchString&>();
+        auto it = std::lower_bound(entries.begin(), entries.end(), key,
+                                   [](const Entry& e, const BatchString* k) { return std::less<const BatchString*>()(e.first, k); });
+        return it != entries.end() && it->first == key ? &it->second : nullptr;
+    }
+};
+
+/**
+ * @struct SyncPayloadIndex
+ * @brief Informations relevées au parsing d'une réponse de sync
+ */
+struct SyncPayloadIndex
+{
+    NodeTable<BodySpan> bodies;     // "body" identiques octet pour octet dans la réponse
+    NodeTable<uint16_t> types;      // "type" d'événements connus du registre
+};
+
+/**
+ * @struct SyncRoomContext
+ * @brief État du traitement d'un salon pendant une réponse de sync
+ */
+struct SyncRoomContext
+{
+    const std::string& roomId;
+    const std::shared_ptr<const PayloadChunk>& payload;
+    const SyncPayloadIndex& index;
+    RoomDelta batch;            // Messages consécutifs regroupés en une mise à jour
+    bool announced = false;     // Au moins une mise à jour émise pour ce salon
+};
+
+/**
+ * @struct SyncEventHandlers
+ * @brief Traitements des événements de sync, enregistrés par type dans SyncEvents()
+ */
+struct SyncEventHandlers
+{
+    static void RoomName(MatrixClient& client, SyncRoomContext& room, const BatchJson& event);
+    static void RoomTopic(MatrixClient& client, SyncRoomContext& room, const BatchJson& event);
+    static void RoomAlias(MatrixClient& client, SyncRoomContext& room, const BatchJson& event);
+    static void RoomMessage(MatrixClient& client, SyncRoomContext& room, const BatchJson& event);
+    static void Receipt(MatrixClient& client, SyncRoomContext& room, const BatchJson& event);
+    static void FullyRead(MatrixClient& client, SyncRoomContext& room, const BatchJson& event);
+    static void Tags(MatrixClient& client, SyncRoomContext& room, const BatchJson& event);
+
+    /**
+     * @brief Transmet les messages regroupés et commence un nouveau lot
+     */
+    static void FlushMessages(MatrixClient& client, SyncRoomContext& room);
+};
+
+using SyncEventHandler = void (*)(MatrixClient&, SyncRoomContext&, const BatchJson&);
+using SyncEventRegistry = EventTypeRegistry<SyncEventHandler>;
+
+/**
+ * @brief Registre des événements traités par la synchronisation
+ * 
+ * Pour gérer un nouveau type d'événement, il suffit d'ajouter son
+ * traitement ici : la boucle de ProcessSyncResponse n'a pas à changer.
+ */
+static const SyncEventRegistry& SyncEvents()
+{
+    static const SyncEventRegistry registry = []
+    {
+        SyncEventRegistry events;
+        events.On(SyncSection::State, "m.room.name", &SyncEventHandlers::RoomName);
+        events.On(SyncSection::State, "m.room.topic", &SyncEventHandlers::RoomTopic);
+        events.On(SyncSection::Timeline, "m.room.name", &SyncEventHandlers::RoomName);
+        events.On(SyncSection::Timeline, "m.room.topic", &SyncEventHandlers::RoomTopic);
+        events.On(SyncSection::State, "m.room.canonical_alias", &SyncEventHandlers::RoomAlias);
+        events.On(SyncSection::Timeline, "m.room.canonical_alias", &SyncEventHandlers::RoomAlias);
+        events.On(SyncSection::Timeline, "m.room.message", &SyncEventHandlers::RoomMessage);
+        events.On(SyncSection::Ephemeral, "m.receipt", &SyncEventHandlers::Receipt);
+        events.On(SyncSection::AccountData, "m.fully_read", &SyncEventHandlers::FullyRead);
+        events.On(SyncSection::AccountData, "m.tag", &SyncEventHandlers::Tags);
+        return events;
+    }();
+    return registry;
+}
+
+/**
+ * @brief Retourne l'identifiant de type d'un événement (relevé au parsing)
+ * 
+ * Un "type" absent, qui n'est pas une chaîne ou qui n'est pas enregistré
+ * est inconnu.
+ */
+static uint16_t EventTypeId(const SyncPayloadIndex& index, const BatchJson& event)
+{
+    auto it = event.find("type");
+    if (it == event.end())
+        return SyncEventRegistry::UNKNOWN_TYPE;
+    const uint16_t* id = index.types.Find(*it);
+    return id ? *id : SyncEventRegistry::UNKNOWN_TYPE;
+}
+
+/**
+ * @brief Retourne le champ "content" d'un événement (objet vide si absent)
+ */
+static const BatchJson& EventContent(const BatchJson& event)
+{
+    static const BatchJson empty;
+    auto it = event.find("content");
+    return it != event.end() ? *it : empty;
+}
+
+/**
+ * @brief Retourne la liste "events" d'une section d'un salon (nullptr si absente)
+ */
+static const BatchJson* SectionEvents(const BatchJson& roomData, const char* section)
+{
+    auto part = roomData.find(section);
+    if (part == roomData.end())
+        return nullptr;
+
+    auto events = part->find("events");
+    if (events == part->end() || !events->is_array())
+        return nullptr;
+    return &*events;
+}
+
+/**
+ * @brief Passe chaque événement d'une section à son traitement enregistré
+ * @return Nombre d'événements parcourus
+ */
+static size_t DispatchEvents(MatrixClient& client, SyncRoomContext& room,
+                             SyncSection section, const BatchJson* events)
+{
+    if (!events)
+        return 0;
+
+    const SyncEventRegistry& registry = SyncEvents();
+    for (const auto& event : *events)
+    {
+        if (SyncEventHandler handler = registry.Find(section, EventTypeId(room.index, event)))
+            handler(client, room, event);
+    }
+    return events->size();
+}
+
+/**
+ * @brief Parse une réponse de sync sans recopier les corps de messages
+ * 
+ * Chaque "body" d'un objet "content" qui ne contient pas de séquence
+ * d'échappement est identique octet pour octet dans la réponse : sa
+ * position est notée dans index.bodies. Les corps échappés n'y sont pas.
+ * 
+ * Le "type" des événements enregistrés dans SyncEvents() est haché ici une
+ * seule fois, son identifiant noté dans index.types (voir EventTypeId).
+ */
+static BatchJson ParseSyncPayload(const std::string& data, SyncPayloadIndex& index)
+{
+    // Seules quelques clés intéressent le callback
+    enum : uint8_t { KEY_OTHER, KEY_CONTENT, KEY_BODY, KEY_TYPE, KEY_EVENTS };
+
+    const char* base = data.data();
+    const char* cursor = base;
+    uint8_t lastKey = KEY_OTHER;
+    std::vector<uint8_t, BatchAllocator<uint8_t>> keyStack;
+    keyStack.reserve(32);
+
+    auto callback = [&](int, BatchJson::parse_event_t event, BatchJson& parsed) -> bool
+    {
+        switch (event)
+        {
+        case BatchJson::parse_event_t::key:
+        {
+            const BatchString& key = parsed.get_ref<const BatchString&>();
+            lastKey = key == "body" ? KEY_BODY
+                    : key == "content" ? KEY_CONTENT
+                    : key == "type" ? KEY_TYPE
+                    : key == "events" ? KEY_EVENTS
+                    : KEY_OTHER;
+            break;
+        }
+        case BatchJson::parse_event_t::object_start:
+        case BatchJson::parse_event_t::array_start:
+            keyStack.push_back(lastKey);
+            lastKey = KEY_OTHER;
+            break;
+        case BatchJson::parse_event_t::object_end:
+        case BatchJson::parse_event_t::array_end:
+            if (!keyStack.empty())
+                keyStack.pop_back();
+            break;
+        case BatchJson::parse_event_t::value:
+            if (parsed.is_string() && lastKey == KEY_BODY && !keyStack.empty() && keyStack.back() == KEY_CONTENT)
+            {
+                // Le lexer vient de lire le guillemet fermant
+                const BatchString& body = parsed.get_ref<const BatchString&>();
+                const char* end = cursor - 1;
+                const char* begin = end - body.size();
+                if (begin > base && begin[-1] == '"' && memcmp(begin, body.data(), body.size()) == 0)
+                {
+                    index.bodies.Add(&body, { static_cast<uint32_t>(begin - base), static_cast<uint32_t>(body.size()) });
+                }
+            }
+            else if (parsed.is_string() && lastKey == KEY_TYPE &&
+                     keyStack.size() >= 2 && keyStack[keyStack.size() - 2] == KEY_EVENTS)
+            {
+                // Type d'un événement d'une liste "events" : haché une seule fois ici
+                const BatchString& type = parsed.get_ref<const BatchString&>();
+                uint16_t id = SyncEvents().Lookup(std::string_view(type.data(), type.size()));
+                if (id != SyncEventRegistry::UNKNOWN_TYPE)
+                    index.types.Add(&type, id);
+            }
+            break;
+        }
+        return true;
+    };
+
+    TrackingIterator first{ base, &cursor };
+    TrackingIterator last{ base + data.size(), &cursor };
+    BatchJson sync = BatchJson::parse(first, last, callback);
+    index.bodies.Seal();
+    index.types.Seal();
+    return sync;
+}
+
 /**
  * @brief Constructeur - Initialise le client avec les valeurs par défaut
  */
@@ -37,6 +360,7 @@ MatrixClient::MatrixClient()
     : m_homeserver(DEFAULT_HOMESERVER)
     , m_isLoggedIn(false)
     , m_isSyncing(false)
+    , m_deltaQueue(DELTA_QUEUE_CAPACITY)
     , m_stopSync(false)
 {
 }
@@ -47,6 +371,71 @@ MatrixClient::MatrixClient()
 MatrixClient::~MatrixClient()
 {
     StopSync();
+
+    if (m_warmUpThread.joinable())
+    {
+        m_warmUpThread.join();
+    }
+
+#ifdef _WIN32
+    if (m_httpConnect)
+    {
+        WinHttpCloseHandle(static_cast<HINTERNET>(m_httpConnect));
+    }
+    if (m_httpSession)
+    {
+        WinHttpCloseHandle(static_cast<HINTERNET>(m_httpSession));
+    }
+#endif
+}
+
+/**
+ * @brief Lance la connexion en arrière-plan
+ */
+AuthTask MatrixClient::LoginAsync(const std::string& username, const std::string& password)
+{
+    AuthTask task;
+    task.operation = std::make_shared<AuthOperation>();
+    task.result = std::async(std::launch::async, [this, username, password, operation = task.operation]()
+    {
+        return RunLogin(username, password, *operation);
+    });
+    return task;
+}
+
+/**
+ * @brief Lance l'inscription en arrière-plan
+ */
+AuthTask MatrixClient::RegisterAsync(const std::string& username, const std::string& password)
+{
+    AuthTask task;
+    task.operation = std::make_shared<AuthOperation>();
+    task.result = std::async(std::launch::async, [this, username, password, operation = task.operation]()
+    {
+        return RunRegister(username, password, *operation);
+    });
+    return task;
+}
+
+/**
+ * @brief Ouvre la connexion au serveur en arrière-plan
+ * 
+ * /versions ne demande pas d'authentification : la requête sert seulement à
+ * résoudre le nom, établir TCP et négocier TLS avant le login. Son erreur
+ * éventuelle reste dans une opération propre au thread : m_lastError
+ * n'appartient qu'au thread de rendu (FinishAuth l'efface).
+ */
+void MatrixClient::WarmUpConnection()
+{
+    if (m_warmUpStarted.exchange(true))
+        return;
+
+    m_warmUpThread = std::thread([this]()
+    {
+        AuthOperation warmUp;
+        std::string response;
+        HttpRequest("GET", "/_matrix/client/versions", "", response, &warmUp);
+    });
 }
 
 /**
@@ -57,13 +446,14 @@ MatrixClient::~MatrixClient()
  * - Complet : @utilisateur:serveur
  * - Simple : utilisateur (le serveur par défaut sera utilisé)
  */
-bool MatrixClient::Login(const std::string& username, const std::string& password)
+bool MatrixClient::RunLogin(const std::string& username, const std::string& password, AuthOperation& operation)
 {
     // Préparation du nom d'utilisateur
     std::string user = username;
     if (user.empty() || password.empty())
     {
-        m_lastError = "Nom d'utilisateur ou mot de passe vide";
+        operation.m_error = "Nom d'utilisateur ou mot de passe vide";
+        operation.m_stage = AuthStage::Failed;
         return false;
     }
 
@@ -86,13 +476,21 @@ bool MatrixClient::Login(const std::string& username, const std::string& passwor
         {"initial_device_display_name", "Kitty Chat C++"}
     };
 
+    operation.m_stage = AuthStage::Authenticating;
     std::string response;
     bool success = HttpRequest("POST", "/_matrix/client/v3/login", 
-                               loginRequest.dump(), response);
+                               loginRequest.dump(), response, &operation);
+
+    if (operation.IsCancelled())
+    {
+        operation.m_stage = AuthStage::Cancelled;
+        return false;
+    }
 
     if (!success)
     {
-        m_lastError = "Erreur de connexion au serveur";
+        operation.m_error = "Erreur de connexion au serveur";
+        operation.m_stage = AuthStage::Failed;
         return false;
     }
 
@@ -104,32 +502,21 @@ bool MatrixClient::Login(const std::string& username, const std::string& passwor
         if (loginResponse.contains("errcode"))
         {
             // Erreur retournée par le serveur
-            m_lastError = loginResponse.value("error", "Erreur inconnue");
+            operation.m_error = loginResponse.value("error", "Erreur inconnue");
+            operation.m_stage = AuthStage::Failed;
             return false;
         }
 
         // Extraction des informations de connexion
-        m_accessToken = loginResponse.value("access_token", "");
-        m_userId = loginResponse.value("user_id", user);
-        m_deviceId = loginResponse.value("device_id", "");
-
-        if (m_accessToken.empty())
-        {
-            m_lastError = "Token d'accès non reçu";
-            return false;
-        }
-
-        m_isLoggedIn = true;
-        m_lastError.clear();
-
-        // Démarrage de la synchronisation
-        StartSync();
-
-        return true;
+        return CompleteAuth(loginResponse.value("access_token", ""),
+                            loginResponse.value("user_id", user),
+                            loginResponse.value("device_id", ""),
+                            operation);
     }
     catch (const json::exception& e)
     {
-        m_lastError = std::string("Erreur de parsing JSON: ") + e.what();
+        operation.m_error = std::string("Erreur de parsing JSON: ") + e.what();
+        operation.m_stage = AuthStage::Failed;
         return false;
     }
 }
@@ -141,11 +528,12 @@ bool MatrixClient::Login(const std::string& username, const std::string& passwor
  * Note: L'inscription peut nécessiter des étapes supplémentaires (captcha, email)
  * selon la configuration du serveur.
  */
-bool MatrixClient::Register(const std::string& username, const std::string& password)
+bool MatrixClient::RunRegister(const std::string& username, const std::string& password, AuthOperation& operation)
 {
     if (username.empty() || password.empty())
     {
-        m_lastError = "Nom d'utilisateur ou mot de passe vide";
+        operation.m_error = "Nom d'utilisateur ou mot de passe vide";
+        operation.m_stage = AuthStage::Failed;
         return false;
     }
 
@@ -159,14 +547,22 @@ bool MatrixClient::Register(const std::string& username, const std::string& pass
         }}
     };
 
+    operation.m_stage = AuthStage::Authenticating;
     std::string response;
-    bool success = HttpRequest("POST", "/_matrix/client/v3/register", 
-                               registerRequest.dump(), response);
+    HttpRequest("POST", "/_matrix/client/v3/register", 
+                registerRequest.dump(), response, &operation);
+
+    if (operation.IsCancelled())
+    {
+        operation.m_stage = AuthStage::Cancelled;
+        return false;
+    }
 
     // Vérifier que la requête a au moins retourné quelque chose
     if (response.empty())
     {
-        m_lastError = "Pas de reponse du serveur";
+        operation.m_error = "Pas de reponse du serveur";
+        operation.m_stage = AuthStage::Failed;
         return false;
     }
 
@@ -191,8 +587,15 @@ bool MatrixClient::Register(const std::string& username, const std::string& pass
                 }}
             };
 
-            success = HttpRequest("POST", "/_matrix/client/v3/register", 
-                                 authRequest.dump(), response);
+            operation.m_stage = AuthStage::InteractiveAuth;
+            HttpRequest("POST", "/_matrix/client/v3/register", 
+                        authRequest.dump(), response, &operation);
+
+            if (operation.IsCancelled())
+            {
+                operation.m_stage = AuthStage::Cancelled;
+                return false;
+            }
             registerResponse = json::parse(response);
         }
 
@@ -201,47 +604,136 @@ bool MatrixClient::Register(const std::string& username, const std::string& pass
             std::string errcode = registerResponse.value("errcode", "");
             if (errcode == "M_USER_IN_USE")
             {
-                m_lastError = "Ce nom d'utilisateur est deja pris, miaou!";
+                operation.m_error = "Ce nom d'utilisateur est deja pris, miaou!";
             }
             else if (errcode == "M_FORBIDDEN")
             {
-                m_lastError = "L'inscription est desactivee sur ce serveur";
+                operation.m_error = "L'inscription est desactivee sur ce serveur";
             }
             else
             {
-                m_lastError = registerResponse.value("error", "Erreur d'inscription");
+                operation.m_error = registerResponse.value("error", "Erreur d'inscription");
             }
+            operation.m_stage = AuthStage::Failed;
             return false;
         }
 
         // Inscription réussie - extraire les informations de connexion
-        m_accessToken = registerResponse.value("access_token", "");
-        m_userId = registerResponse.value("user_id", "");
-        m_deviceId = registerResponse.value("device_id", "");
+        return CompleteAuth(registerResponse.value("access_token", ""),
+                            registerResponse.value("user_id", ""),
+                            registerResponse.value("device_id", ""),
+                            operation);
+    }
+    catch (const json::exception& e)
+    {
+        std::string preview = response.substr(0, 100);
+        operation.m_error = std::string("Erreur JSON: ") + e.what() + " - Reponse: " + preview;
+        operation.m_stage = AuthStage::Failed;
+        return false;
+    }
+}
+
+/**
+ * @brief Termine une authentification réussie
+ * 
+ * Passé ce point, l'opération ne peut plus être annulée. La session reste
+ * dans l'opération : le client n'est modifié que par FinishAuth, sur le
+ * thread de rendu.
+ */
+bool MatrixClient::CompleteAuth(const std::string& accessToken, const std::string& userId,
+                                const std::string& deviceId, AuthOperation& operation)
+{
+    if (accessToken.empty())
+    {
+        operation.m_error = "Token d'acces non recu";
+        operation.m_stage = AuthStage::Failed;
+        return false;
+    }
 
-        if (m_accessToken.empty())
+    {
+        // Même verrou que Cancel : soit l'annulation passe avant et la
+        // session est abandonnée, soit elle arrive après et reste sans effet
+        std::lock_guard<std::mutex> lock(operation.m_requestMutex);
+        if (operation.m_cancelled)
         {
-            m_lastError = "Token d'acces non recu apres inscription";
+            operation.m_stage = AuthStage::Cancelled;
             return false;
         }
+        operation.m_stage = AuthStage::StartingSync;
+    }
 
-        m_isLoggedIn = true;
-        m_lastError.clear();
+    operation.m_accessToken = accessToken;
+    operation.m_userId = userId;
+    operation.m_deviceId = deviceId;
+    return true;
+}
 
-        // Démarrage de la synchronisation
-        StartSync();
+/**
+ * @brief Ouvre la session obtenue par une connexion ou inscription réussie
+ */
+void MatrixClient::FinishAuth(AuthOperation& operation)
+{
+    if (operation.GetStage() != AuthStage::StartingSync)
+        return;
 
-        return true;
-    }
-    catch (const json::exception& e)
+    m_accessToken = std::move(operation.m_accessToken);
+    m_userId = std::move(operation.m_userId);
+    m_deviceId = std::move(operation.m_deviceId);
+    m_lastError.clear();
+    m_isLoggedIn = true;
+
+    // Démarrage de la synchronisation
+    StartSync();
+
+    operation.m_stage = AuthStage::Done;
+}
+
+/**
+ * @brief Annule l'opération et interrompt la requête HTTP en cours
+ * 
+ * Fermer le handle depuis un autre thread fait échouer immédiatement
+ * l'appel WinHTTP bloquant du thread de l'opération.
+ */
+void AuthOperation::Cancel()
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    if (m_stage == AuthStage::StartingSync || m_stage == AuthStage::Done)
+        return;
+
+    m_cancelled = true;
+    if (m_activeRequest)
     {
-        // Afficher les premiers caractères de la réponse pour debug
-        std::string preview = response.substr(0, 100);
-        m_lastError = std::string("Erreur JSON: ") + e.what() + " - Reponse: " + preview;
-        return false;
+#ifdef _WIN32
+        WinHttpCloseHandle(static_cast<HINTERNET>(m_activeRequest));
+#endif
+        m_activeRequest = nullptr;
     }
 }
 
+/**
+ * @brief Enregistre la requête en cours pour pouvoir l'interrompre
+ */
+bool AuthOperation::AttachRequest(void* request)
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    if (m_cancelled)
+        return false;
+    m_activeRequest = request;
+    return true;
+}
+
+/**
+ * @brief Oublie la requête en cours
+ */
+bool AuthOperation::DetachRequest()
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    if (!m_activeRequest)
+        return false;
+    m_activeRequest = nullptr;
+    return true;
+}
+
 /**
  * @brief Déconnecte l'utilisateur et nettoie les données
  */
@@ -249,8 +741,18 @@ void MatrixClient::Logout()
 {
     StopSync();
 
+    // Accusés encore retenus par le délai de regroupement : envoyés tant que
+    // le token est valide, et jamais rejoués dans la session suivante
+    std::map<std::string, std::string> receipts;
+    {
+        std::lock_guard<std::mutex> lock(m_receiptMutex);
+        receipts.swap(m_pendingReceipts);
+    }
+
     if (m_isLoggedIn && !m_accessToken.empty())
     {
+        SendReadReceipts(receipts);
+
         // Appel à l'API de logout (optionnel, on ignore les erreurs)
         std::string response;
         HttpRequest("POST", "/_matrix/client/v3/logout", "{}", response);
@@ -263,8 +765,21 @@ void MatrixClient::Logout()
     m_syncToken.clear();
     m_isLoggedIn = false;
 
-    std::lock_guard<std::mutex> lock(m_roomsMutex);
+    // Les mises à jour encore en transit appartiennent à l'ancienne session
+    RoomDelta discarded;
+    while (m_deltaQueue.TryPop(discarded))
+    {
+    }
+    m_pendingDeltas.clear();
+    m_syncKnownRooms.clear();
+    m_payloadSerial = 0;
+    m_appliedPayloadSerial = 0;
+    m_compactedBeforeSerial = 0;
+
     m_rooms.clear();
+    m_roomIndex.clear();
+    m_roomOrder.Clear();
+    m_roomsRevision++;
     m_selectedRoomId.clear();
 }
 
@@ -273,18 +788,43 @@ void MatrixClient::Logout()
  */
 void MatrixClient::SelectRoom(const std::string& roomId)
 {
-    std::lock_guard<std::mutex> lock(m_roomsMutex);
     m_selectedRoomId = roomId;
 
-    // Remise à zéro du compteur de messages non lus
-    for (auto& room : m_rooms)
+    // Le serveur remettra les compteurs à zéro à réception de l'accusé
+    MarkRoomRead(roomId);
+}
+
+/**
+ * @brief Marque un salon comme lu jusqu'à son dernier événement
+ * 
+ * Les compteurs locaux sont remis à zéro immédiatement ; l'accusé est mis
+ * en attente et envoyé par ReceiptLoop. Plusieurs appels pour le même salon
+ * ne produisent qu'une requête, pour l'événement le plus récent.
+ */
+void MatrixClient::MarkRoomRead(const std::string& roomId)
+{
+    Room* room = FindRoom(roomId);
+    if (!room)
+        return;
+
+    if (room->unreadCount != 0 || room->highlightCount != 0)
     {
-        if (room.id == roomId)
-        {
-            room.unreadCount = 0;
-            break;
-        }
+        room->unreadCount = 0;
+        room->highlightCount = 0;
+        TouchRoom(*room);
+        UpdateRoomOrder(*room);
+    }
+
+    if (room->lastEventId.empty() || room->lastEventId == room->readEventId)
+        return;
+
+    room->readEventId = room->lastEventId;
+    {
+        auto lock = ProfiledLock(m_receiptMutex, ProfileSection::ReceiptLockWait);
+        m_pendingReceipts[roomId] = room->lastEventId;
+        m_lastReceiptRequest = std::chrono::steady_clock::now();
     }
+    m_receiptCv.notify_one();
 }
 
 /**
@@ -292,15 +832,46 @@ void MatrixClient::SelectRoom(const std::string& roomId)
  */
 const Room* MatrixClient::GetSelectedRoom() const
 {
-    std::lock_guard<std::mutex> lock(m_roomsMutex);
-    for (const auto& room : m_rooms)
-    {
-        if (room.id == m_selectedRoomId)
-        {
-            return &room;
-        }
-    }
-    return nullptr;
+    return FindRoom(m_selectedRoomId);
+}
+
+/**
+ * @brief Retourne un salon par son identifiant
+ */
+Room* MatrixClient::FindRoom(const std::string& roomId)
+{
+    auto it = m_roomIndex.find(roomId);
+    return it != m_roomIndex.end() ? &m_rooms[it->second] : nullptr;
+}
+
+const Room* MatrixClient::FindRoom(const std::string& roomId) const
+{
+    auto it = m_roomIndex.find(roomId);
+    return it != m_roomIndex.end() ? &m_rooms[it->second] : nullptr;
+}
+
+/**
+ * @brief Replace un salon dans l'ordre d'affichage après un changement
+ */
+void MatrixClient::UpdateRoomOrder(const Room& room)
+{
+    RoomList::Key key;
+    key.favourite = room.isFavourite;
+    key.unread = room.unreadCount > 0 || room.highlightCount > 0;
+    key.lastActivity = room.lastActivity;
+    key.index = static_cast<uint32_t>(&room - m_rooms.data());
+    if (m_roomOrder.Update(key))
+        m_roomsRevision++;
+}
+
+/**
+ * @brief Signale un changement du libellé d'un salon
+ */
+void MatrixClient::TouchRoom(Room& room)
+{
+    // Révision unique : un salon recréé au même index après une
+    // déconnexion ne peut pas être confondu avec l'ancien
+    room.revision = static_cast<uint32_t>(++m_roomsRevision);
 }
 
 /**
@@ -477,6 +1048,7 @@ void MatrixClient::StartSync()
     m_stopSync = false;
     m_isSyncing = true;
     m_syncThread = std::thread(&MatrixClient::SyncLoop, this);
+    m_receiptThread = std::thread(&MatrixClient::ReceiptLoop, this);
 }
 
 /**
@@ -487,16 +1059,42 @@ void MatrixClient::StopSync()
     if (!m_isSyncing)
         return;
 
-    m_stopSync = true;
+    {
+        // Sous le verrou : ReceiptLoop teste m_stopSync puis s'endort sous ce
+        // même verrou, le réveil ne peut pas tomber entre les deux
+        std::lock_guard<std::mutex> lock(m_receiptMutex);
+        m_stopSync = true;
+    }
+    m_receiptCv.notify_one();
     if (m_syncThread.joinable())
     {
         m_syncThread.join();
     }
+    if (m_receiptThread.joinable())
+    {
+        m_receiptThread.join();
+    }
     m_isSyncing = false;
 }
 
 /**
- * @brief Boucle de synchronisation exécutée dans un thread séparé
+ * @brief Ouvre une session hors ligne qui rejoue des réponses /sync
+ * 
+ * Pas de thread d'accusés de lecture : il n'y a pas de serveur à prévenir.
+ */
+void MatrixClient::StartOfflineSession(const std::string& userId, std::vector<std::string> syncResponses)
+{
+    StopSync();
+
+    m_userId = userId;
+    m_isLoggedIn = true;
+    m_stopSync = false;
+    m_isSyncing = true;
+    m_syncThread = std::thread(&MatrixClient::ReplaySyncLoop, this, std::move(syncResponses));
+}
+
+/**
+ * @brief Boucle de synchronisation exécutée dans un thread séparé
  * 
  * Cette fonction implémente le "long polling" pour la synchronisation temps réel.
  * 
@@ -533,12 +1131,21 @@ void MatrixClient::SyncLoop()
             endpoint += "&filter={\"room\":{\"timeline\":{\"limit\":50}}}";
         }
 
-        std::string response;
-        bool success = HttpRequest("GET", endpoint, "", response);
+        auto payload = std::make_shared<PayloadChunk>();
+        bool success = HttpRequest("GET", endpoint, "", payload->data);
+
+        if (success && !payload->data.empty())
+        {
+            // La réponse devient immuable : les messages peuvent y pointer
+            payload->serial = ++m_payloadSerial;
+            ProcessSyncResponse(payload);
+        }
 
-        if (success && !response.empty())
+        // Contre-pression : si l'UI est en retard, on attend qu'elle ait
+        // consommé les mises à jour avant de relancer une requête
+        while (!m_stopSync && !FlushPendingDeltas())
         {
-            ProcessSyncResponse(response);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
         }
 
         // Pause courte entre les syncs (le timeout de 30s sur le serveur
@@ -550,156 +1157,595 @@ void MatrixClient::SyncLoop()
     }
 }
 
+/**
+ * @brief Boucle de synchronisation d'une session hors ligne
+ * 
+ * Même traitement et même contre-pression que SyncLoop, mais les réponses
+ * viennent de la liste fournie au lieu du serveur.
+ */
+void MatrixClient::ReplaySyncLoop(std::vector<std::string> syncResponses)
+{
+    for (std::string& data : syncResponses)
+    {
+        if (m_stopSync)
+            break;
+
+        auto payload = std::make_shared<PayloadChunk>();
+        payload->data = std::move(data);
+        payload->serial = ++m_payloadSerial;
+        ProcessSyncResponse(payload);
+
+        while (!m_stopSync && !FlushPendingDeltas())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+/**
+ * @brief Boucle d'envoi des accusés de lecture
+ * 
+ * Attend qu'un salon ait été marqué comme lu, puis laisse passer un court
+ * délai sans nouvelle demande (ou le délai maximum) avant d'envoyer tous les
+ * marqueurs en attente. Un seul POST /read_markers par salon positionne à la
+ * fois m.read et m.fully_read.
+ */
+void MatrixClient::ReceiptLoop()
+{
+    std::unique_lock<std::mutex> lock(m_receiptMutex);
+
+    while (!m_stopSync)
+    {
+        m_receiptCv.wait(lock, [this] { return m_stopSync || !m_pendingReceipts.empty(); });
+        if (m_stopSync)
+            break;
+
+        // Regroupement : on attend que les demandes se calment
+        auto firstRequest = std::chrono::steady_clock::now();
+        while (!m_stopSync)
+        {
+            auto deadline = std::min(m_lastReceiptRequest + RECEIPT_DEBOUNCE,
+                                     firstRequest + RECEIPT_MAX_DELAY);
+            if (m_receiptCv.wait_until(lock, deadline) == std::cv_status::timeout &&
+                std::chrono::steady_clock::now() >= deadline)
+                break;
+        }
+        if (m_stopSync)
+            break;
+
+        std::map<std::string, std::string> receipts;
+        receipts.swap(m_pendingReceipts);
+        lock.unlock();
+
+        SendReadReceipts(receipts);
+
+        lock.lock();
+    }
+}
+
+/**
+ * @brief Envoie des accusés de lecture
+ */
+void MatrixClient::SendReadReceipts(const std::map<std::string, std::string>& receipts)
+{
+    for (const auto& [roomId, eventId] : receipts)
+    {
+        json markers = {
+            {"m.fully_read", eventId},
+            {"m.read", eventId}
+        };
+
+        std::string response;
+        HttpRequest("POST", "/_matrix/client/v3/rooms/" + roomId + "/read_markers",
+                    markers.dump(), response);
+    }
+}
+
 /**
  * @brief Traite la réponse de synchronisation
  * 
  * Parse le JSON de réponse et met à jour les salons et messages
  */
-void MatrixClient::ProcessSyncResponse(const std::string& syncResponse)
+void MatrixClient::ProcessSyncResponse(const std::shared_ptr<const PayloadChunk>& payload)
 {
+    // Tous les temporaires du lot (DOM, index des corps) viennent de l'arène ;
+    // ils doivent être détruits avant la remise à zéro en fin de fonction
+    BatchArena::Scope arenaScope(m_syncArena);
+    size_t eventCount = 0;
+
     try
     {
-        json sync = json::parse(syncResponse);
+        SyncPayloadIndex index;
+        BatchJson sync = ParseSyncPayload(payload->data, index);
 
         // Mise à jour du token de sync pour la prochaine requête
-        if (sync.contains("next_batch"))
+        std::string_view nextBatch = StringField(sync, "next_batch");
+        if (!nextBatch.empty())
         {
-            m_syncToken = sync["next_batch"].get<std::string>();
+            m_syncToken.assign(nextBatch.data(), nextBatch.size());
         }
 
-        // Traitement des salons
+        // Traitement des salons : chaque événement est passé au traitement
+        // enregistré pour son type (voir SyncEvents) et devient une mise à
+        // jour appliquée plus tard par le thread de rendu (voir PumpEvents)
         if (sync.contains("rooms") && sync["rooms"].contains("join"))
         {
-            std::lock_guard<std::mutex> lock(m_roomsMutex);
-
-            for (auto& [roomId, roomData] : sync["rooms"]["join"].items())
+            for (auto& [roomKey, roomData] : sync["rooms"]["join"].items())
             {
-                // Recherche du salon existant ou création
-                Room* room = nullptr;
-                for (auto& r : m_rooms)
+                const std::string roomId(roomKey.data(), roomKey.size());
+                const BatchJson* timeline = SectionEvents(roomData, "timeline");
+
+                SyncRoomContext room{ roomId, payload, index, RoomDelta() };
+                room.batch.type = RoomDeltaType::Messages;
+                room.batch.roomId = roomId;
+                room.batch.payload = payload;
+                if (timeline)
+                    room.batch.messages.reserve(timeline->size());
+
+                eventCount += DispatchEvents(*this, room, SyncSection::State, SectionEvents(roomData, "state"));
+                eventCount += DispatchEvents(*this, room, SyncSection::Timeline, timeline);
+                SyncEventHandlers::FlushMessages(*this, room);
+
+                // Compteurs calculés par le serveur (tiennent compte des accusés
+                // envoyés depuis n'importe quel appareil)
+                std::string_view lastEventId;
+                if (timeline && !timeline->empty())
                 {
-                    if (r.id == roomId)
-                    {
-                        room = &r;
-                        break;
-                    }
-                }
-
-                if (!room)
-                {
-                    // Nouveau salon
-                    m_rooms.push_back({});
-                    room = &m_rooms.back();
-                    room->id = roomId;
-                    room->name = roomId; // Nom par défaut
-                    room->unreadCount = 0;
+                    lastEventId = StringField(timeline->back(), "event_id");
                 }
 
-                // Mise à jour du nom depuis l'état du salon
-                if (roomData.contains("state") && roomData["state"].contains("events"))
+                auto unread = roomData.find("unread_notifications");
+                if (unread != roomData.end() || !lastEventId.empty())
                 {
-                    for (const auto& event : roomData["state"]["events"])
+                    RoomDelta delta;
+                    delta.type = RoomDeltaType::Unread;
+                    delta.roomId = roomId;
+                    delta.value = lastEventId;
+                    if (unread != roomData.end())
                     {
-                        if (event.value("type", "") == "m.room.name")
-                        {
-                            room->name = event["content"].value("name", room->name);
-                        }
-                        else if (event.value("type", "") == "m.room.topic")
-                        {
-                            room->topic = event["content"].value("topic", "");
-                        }
+                        delta.notificationCount = unread->value("notification_count", 0);
+                        delta.highlightCount = unread->value("highlight_count", 0);
                     }
+                    QueueDelta(std::move(delta));
+                    room.announced = true;
                 }
 
-                // Traitement des événements de timeline (messages)
-                if (roomData.contains("timeline") && roomData["timeline"].contains("events"))
+                eventCount += DispatchEvents(*this, room, SyncSection::Ephemeral, SectionEvents(roomData, "ephemeral"));
+                eventCount += DispatchEvents(*this, room, SyncSection::AccountData, SectionEvents(roomData, "account_data"));
+
+                // Salon sans événement utile : il doit quand même apparaître
+                if (!room.announced && m_syncKnownRooms.find(roomId) == m_syncKnownRooms.end())
                 {
-                    for (const auto& event : roomData["timeline"]["events"])
-                    {
-                        std::string eventType = event.value("type", "");
-
-                        // Mise à jour du nom si présent dans la timeline
-                        if (eventType == "m.room.name")
-                        {
-                            room->name = event["content"].value("name", room->name);
-                        }
-                        // Traitement des messages
-                        else if (eventType == "m.room.message")
-                        {
-                            Message msg;
-                            msg.id = event.value("event_id", "");
-                            msg.sender = event.value("sender", "");
-                            msg.content = event["content"].value("body", "");
-                            msg.isOwn = (msg.sender == m_userId);
-
-                            // Extraction du nom d'affichage depuis le sender
-                            size_t colonPos = msg.sender.find(':');
-                            if (colonPos != std::string::npos && msg.sender[0] == '@')
-                            {
-                                msg.senderName = msg.sender.substr(1, colonPos - 1);
-                            }
-                            else
-                            {
-                                msg.senderName = msg.sender;
-                            }
-
-                            // Formatage du timestamp
-                            if (event.contains("origin_server_ts"))
-                            {
-                                long long ts = event["origin_server_ts"].get<long long>();
-                                time_t time = static_cast<time_t>(ts / 1000);
-                                struct tm* tm = localtime(&time);
-                                char buffer[32];
-                                strftime(buffer, sizeof(buffer), "%H:%M", tm);
-                                msg.timestamp = buffer;
-                            }
-
-                            room->messages.push_back(msg);
-
-                            // Incrémenter le compteur si ce n'est pas le salon actif
-                            if (room->id != m_selectedRoomId && !msg.isOwn)
-                            {
-                                room->unreadCount++;
-                            }
-                        }
-                    }
+                    RoomDelta delta;
+                    delta.type = RoomDeltaType::Join;
+                    delta.roomId = roomId;
+                    QueueDelta(std::move(delta));
                 }
+                m_syncKnownRooms.insert(roomId);
             }
         }
-
-        // Notification de mise à jour
-        if (m_updateCallback)
-        {
-            m_updateCallback();
-        }
     }
     catch (const json::exception& e)
     {
         m_lastError = std::string("Erreur de parsing sync: ") + e.what();
     }
+
+    // Toute réponse, même vide ou sans message, fait vieillir les réponses
+    // retenues : la marque passe après les mises à jour de ce lot
+    RoomDelta done;
+    done.type = RoomDeltaType::SyncDone;
+    done.serial = payload->serial;
+    QueueDelta(std::move(done));
+
+    // Le DOM est détruit : tout le lot est rendu d'un coup
+    m_lastSyncEvents = eventCount;
+    m_lastSyncArenaAllocations = m_syncArena.AllocationCount();
+    m_syncArena.Reset();
 }
 
 /**
- * @brief Effectue une requête HTTP vers l'API Matrix
+ * @brief Transmet les messages regroupés et commence un nouveau lot
+ */
+void SyncEventHandlers::FlushMessages(MatrixClient& client, SyncRoomContext& room)
+{
+    if (room.batch.messages.empty())
+        return;
+
+    client.QueueDelta(std::move(room.batch));
+    room.batch = RoomDelta();
+    room.batch.type = RoomDeltaType::Messages;
+    room.batch.roomId = room.roomId;
+    room.batch.payload = room.payload;
+    room.announced = true;
+}
+
+/**
+ * @brief m.room.name (état ou timeline) : nouveau nom du salon
+ */
+void SyncEventHandlers::RoomName(MatrixClient& client, SyncRoomContext& room, const BatchJson& event)
+{
+    // Les messages reçus avant le renommage sont appliqués d'abord
+    FlushMessages(client, room);
+
+    RoomDelta delta;
+    delta.type = RoomDeltaType::Name;
+    delta.roomId = room.roomId;
+    delta.value = StringField(EventContent(event), "name");
+    client.QueueDelta(std::move(delta));
+    room.announced = true;
+}
+
+/**
+ * @brief m.room.topic (état ou timeline) : nouveau sujet du salon
+ */
+void SyncEventHandlers::RoomTopic(MatrixClient& client, SyncRoomContext& room, const BatchJson& event)
+{
+    FlushMessages(client, room);
+
+    RoomDelta delta;
+    delta.type = RoomDeltaType::Topic;
+    delta.roomId = room.roomId;
+    delta.value = StringField(EventContent(event), "topic");
+    client.QueueDelta(std::move(delta));
+    room.announced = true;
+}
+
+/**
+ * @brief m.room.canonical_alias (état ou timeline) : alias principal du salon
+ */
+void SyncEventHandlers::RoomAlias(MatrixClient& client, SyncRoomContext& room, const BatchJson& event)
+{
+    FlushMessages(client, room);
+
+    RoomDelta delta;
+    delta.type = RoomDeltaType::Alias;
+    delta.roomId = room.roomId;
+    delta.value = StringField(EventContent(event), "alias");
+    client.QueueDelta(std::move(delta));
+    room.announced = true;
+}
+
+/**
+ * @brief m.room.message : ajouté au lot de messages en cours
+ */
+void SyncEventHandlers::RoomMessage(MatrixClient& client, SyncRoomContext& room, const BatchJson& event)
+{
+    // Construit directement dans le lot, sans objet intermédiaire
+    Message& msg = room.batch.messages.emplace_back();
+    msg.id = StringField(event, "event_id");
+    std::string_view sender = StringField(event, "sender");
+    msg.sender = sender;
+
+    // Corps : référence dans la réponse si possible, sinon copie
+    const BatchJson& content = EventContent(event);
+    auto body = content.find("body");
+    const BodySpan* span = body != content.end() ? room.index.bodies.Find(*body) : nullptr;
+    if (span)
+    {
+        msg.bodyOffset = span->offset;
+        msg.bodyLength = span->length;
+        msg.bodyInPayload = true;
+    }
+    else if (body != content.end() && body->is_string())
+    {
+        const BatchString& text = body->get_ref<const BatchString&>();
+        msg.content.assign(text.data(), text.size());
+    }
+    msg.isOwn = (sender == client.m_userId);
+
+    // Extraction du nom d'affichage depuis le sender
+    size_t colonPos = sender.find(':');
+    if (colonPos != std::string_view::npos && sender[0] == '@')
+    {
+        msg.senderName = sender.substr(1, colonPos - 1);
+    }
+    else
+    {
+        msg.senderName = sender;
+    }
+
+    // Horodatage brut, formaté seulement à l'affichage
+    auto timestamp = event.find("origin_server_ts");
+    if (timestamp != event.end() && timestamp->is_number())
+    {
+        msg.timestamp = timestamp->get<long long>();
+    }
+}
+
+/**
+ * @brief m.receipt : nos propres accusés de lecture (ex: posés depuis un autre client)
+ */
+void SyncEventHandlers::Receipt(MatrixClient& client, SyncRoomContext& room, const BatchJson& event)
+{
+    for (auto& [eventId, receiptTypes] : EventContent(event).items())
+    {
+        auto read = receiptTypes.find("m.read");
+        if (read != receiptTypes.end() && read->contains(std::string_view(client.m_userId)))
+        {
+            RoomDelta delta;
+            delta.type = RoomDeltaType::ReadReceipt;
+            delta.roomId = room.roomId;
+            delta.value.assign(eventId.data(), eventId.size());
+            client.QueueDelta(std::move(delta));
+        }
+    }
+}
+
+/**
+ * @brief m.fully_read : marqueur de lecture du compte, envoyé avec m.read
+ */
+void SyncEventHandlers::FullyRead(MatrixClient& client, SyncRoomContext& room, const BatchJson& event)
+{
+    std::string_view eventId = StringField(EventContent(event), "event_id");
+    if (eventId.empty())
+        return;
+
+    RoomDelta delta;
+    delta.type = RoomDeltaType::ReadReceipt;
+    delta.roomId = room.roomId;
+    delta.value = eventId;
+    client.QueueDelta(std::move(delta));
+}
+
+/**
+ * @brief m.tag : tags du salon (seul m.favourite est utilisé, pour le tri)
  * 
- * Cette fonction utilise WinHTTP (API Windows native) pour effectuer des requêtes HTTPS
- * vers le serveur Matrix. WinHTTP gère automatiquement :
- * - La validation des certificats SSL via le magasin Windows
- * - La négociation TLS (TLS 1.2+)
- * - La gestion des proxies système
+ * L'événement contient toujours la liste complète des tags du salon.
+ */
+void SyncEventHandlers::Tags(MatrixClient& client, SyncRoomContext& room, const BatchJson& event)
+{
+    const BatchJson& content = EventContent(event);
+    auto tags = content.find("tags");
+
+    RoomDelta delta;
+    delta.type = RoomDeltaType::Tags;
+    delta.roomId = room.roomId;
+    delta.favourite = tags != content.end() && tags->contains("m.favourite");
+    client.QueueDelta(std::move(delta));
+    room.announced = true;
+}
+
+/**
+ * @brief Transmet une mise à jour au thread de rendu
  * 
- * Sécurité : Toutes les communications sont chiffrées via HTTPS (TLS).
- * Le token d'accès est inclus dans le header Authorization si disponible.
+ * Tant que des mises à jour sont en attente, les suivantes passent aussi par
+ * l'attente pour conserver l'ordre. Quand l'UI est en retard, les ajouts de
+ * messages consécutifs d'un même salon sont fusionnés en un seul élément.
+ */
+void MatrixClient::QueueDelta(RoomDelta&& delta)
+{
+    if (m_pendingDeltas.empty() && m_deltaQueue.TryPush(std::move(delta)))
+        return;
+
+    if (!m_pendingDeltas.empty())
+    {
+        RoomDelta& last = m_pendingDeltas.back();
+        if (last.roomId == delta.roomId && last.type == delta.type)
+        {
+            if (delta.type == RoomDeltaType::SyncDone)
+            {
+                last.serial = delta.serial;
+                return;
+            }
+            if (delta.type == RoomDeltaType::Messages && last.payload == delta.payload)
+            {
+                last.messages.insert(last.messages.end(),
+                                     std::make_move_iterator(delta.messages.begin()),
+                                     std::make_move_iterator(delta.messages.end()));
+                return;
+            }
+            if (delta.type == RoomDeltaType::Messages)
+            {
+                // Réponses de sync différentes : on ne peut pas fusionner
+                m_pendingDeltas.push_back(std::move(delta));
+                return;
+            }
+            if (delta.type == RoomDeltaType::Unread)
+            {
+                last.notificationCount = delta.notificationCount;
+                last.highlightCount = delta.highlightCount;
+                if (!delta.value.empty())
+                    last.value = std::move(delta.value);
+                return;
+            }
+            if (delta.type != RoomDeltaType::Join)
+            {
+                // Seule la dernière valeur du nom/sujet/alias/accusé/tags compte
+                last.value = std::move(delta.value);
+                last.favourite = delta.favourite;
+            }
+            return;
+        }
+    }
+
+    m_pendingDeltas.push_back(std::move(delta));
+}
+
+/**
+ * @brief Pousse les mises à jour en attente dans la file
+ */
+bool MatrixClient::FlushPendingDeltas()
+{
+    while (!m_pendingDeltas.empty())
+    {
+        if (!m_deltaQueue.TryPush(std::move(m_pendingDeltas.front())))
+            return false;
+        m_pendingDeltas.pop_front();
+    }
+    return true;
+}
+
+/**
+ * @brief Applique les mises à jour de la synchronisation dans le budget imparti
  * 
- * @param method Méthode HTTP (GET, POST, PUT)
- * @param endpoint Point de terminaison de l'API (ex: /_matrix/client/v3/login)
- * @param body Corps de la requête (JSON pour POST/PUT)
- * @param response Réponse reçue du serveur (JSON)
- * @return true si la requête a réussi (code HTTP 2xx)
+ * Le temps n'est mesuré que toutes les quelques mises à jour pour que
+ * l'horloge ne coûte pas plus cher que le travail lui-même.
  */
-bool MatrixClient::HttpRequest(const std::string& method, const std::string& endpoint,
-                               const std::string& body, std::string& response)
+void MatrixClient::PumpEvents(double budgetMs)
+{
+    ProfileScope profile(ProfileSection::PumpEvents);
+    auto start = std::chrono::steady_clock::now();
+    RoomDelta delta;
+    int applied = 0;
+
+    while (m_deltaQueue.TryPop(delta))
+    {
+        ApplyDelta(delta);
+
+        if (++applied % 16 == 0)
+        {
+            double elapsed = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= budgetMs)
+                break;
+        }
+    }
+
+    if (applied > 0 && m_updateCallback)
+    {
+        m_updateCallback();
+    }
+
+    // Les lots trop anciens sont recopiés dans les arènes des salons pour
+    // libérer les réponses de synchronisation complètes
+    if (m_appliedPayloadSerial > RETAINED_SYNC_BATCHES)
+    {
+        uint32_t keepFrom = m_appliedPayloadSerial - RETAINED_SYNC_BATCHES + 1;
+        if (keepFrom != m_compactedBeforeSerial)
+        {
+            for (auto& room : m_rooms)
+            {
+                room.timeline.CompactChunksBefore(keepFrom);
+            }
+            m_compactedBeforeSerial = keepFrom;
+        }
+    }
+}
+
+/**
+ * @brief Applique une mise à jour aux salons (thread de rendu uniquement)
+ */
+void MatrixClient::ApplyDelta(RoomDelta& delta)
 {
+    // Fin d'une réponse de sync : toutes ses mises à jour sont appliquées
+    if (delta.type == RoomDeltaType::SyncDone)
+    {
+        if (delta.serial > m_appliedPayloadSerial)
+            m_appliedPayloadSerial = delta.serial;
+        return;
+    }
+
+    // Recherche du salon existant ou création
+    Room* room = FindRoom(delta.roomId);
+
+    if (!room)
+    {
+        // Nouveau salon
+        m_roomIndex.emplace(delta.roomId, static_cast<uint32_t>(m_rooms.size()));
+        m_rooms.push_back({});
+        room = &m_rooms.back();
+        room->id = delta.roomId;
+        room->name = delta.roomId; // Nom par défaut
+        room->unreadCount = 0;
+        room->highlightCount = 0;
+        room->lastActivity = 0;
+        room->isFavourite = false;
+        TouchRoom(*room);
+    }
+
+    switch (delta.type)
+    {
+    case RoomDeltaType::Join:
+        break;
+
+    case RoomDeltaType::Name:
+        if (!delta.value.empty())
+        {
+            room->name = std::move(delta.value);
+            TouchRoom(*room);
+        }
+        break;
+
+    case RoomDeltaType::Topic:
+        room->topic = std::move(delta.value);
+        break;
+
+    case RoomDeltaType::Alias:
+        room->alias = std::move(delta.value);
+        TouchRoom(*room);
+        break;
+
+    case RoomDeltaType::Messages:
+        for (const auto& msg : delta.messages)
+        {
+            if (msg.bodyInPayload && delta.payload)
+            {
+                room->timeline.AppendRetained(msg.id, msg.sender, msg.senderName,
+                                              delta.payload, msg.bodyOffset, msg.bodyLength,
+                                              msg.timestamp, msg.isOwn);
+            }
+            else
+            {
+                room->timeline.Append(msg.id, msg.sender, msg.senderName,
+                                      msg.content, msg.timestamp, msg.isOwn);
+            }
+            if (msg.timestamp > room->lastActivity)
+                room->lastActivity = msg.timestamp;
+        }
+        break;
+
+    case RoomDeltaType::Unread:
+        if (!delta.value.empty())
+            room->lastEventId = std::move(delta.value);
+
+        if (room->id == m_selectedRoomId)
+        {
+            // Salon affiché : tout ce qui arrive est lu
+            MarkRoomRead(room->id);
+        }
+        else if (room->unreadCount != delta.notificationCount ||
+                 room->highlightCount != delta.highlightCount)
+        {
+            room->unreadCount = delta.notificationCount;
+            room->highlightCount = delta.highlightCount;
+            TouchRoom(*room);
+        }
+        break;
+
+    case RoomDeltaType::ReadReceipt:
+        room->readEventId = std::move(delta.value);
+        break;
+
+    case RoomDeltaType::Tags:
+        if (room->isFavourite != delta.favourite)
+        {
+            room->isFavourite = delta.favourite;
+            TouchRoom(*room);
+        }
+        break;
+
+    case RoomDeltaType::SyncDone:
+        break;      // Traité avant la recherche du salon
+    }
+
+    UpdateRoomOrder(*room);
+}
+
+#ifdef _WIN32
+
+/**
+ * @brief Retourne la connexion partagée au serveur, ouverte au premier appel
+ * 
+ * Une seule session WinHTTP sert toutes les requêtes : WinHTTP y garde les
+ * connexions TCP/TLS ouvertes (keep-alive) et les réutilise, au lieu de
+ * refaire DNS + TCP + négociation TLS à chaque requête.
+ */
+void* MatrixClient::AcquireConnection()
+{
+    auto lock = ProfiledLock(m_httpMutex, ProfileSection::HttpLockWait);
+    if (m_httpConnect)
+        return m_httpConnect;
+
     // Analyse de l'URL du serveur pour extraire host, port et protocole
     std::string url = m_homeserver;
     bool useHttps = true;
@@ -743,32 +1789,68 @@ bool MatrixClient::HttpRequest(const std::string& method, const std::string& end
     std::wstring wHost(host.begin(), host.end());
     
     // Ouverture d'une session WinHTTP
-    HINTERNET hSession = WinHttpOpen(
-        L"KittyChat/1.0",
-        WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-        WINHTTP_NO_PROXY_NAME,
-        WINHTTP_NO_PROXY_BYPASS,
-        0
-    );
-
-    if (!hSession)
+    if (!m_httpSession)
     {
-        m_lastError = "Impossible d'ouvrir la session HTTP";
-        return false;
+        m_httpSession = WinHttpOpen(
+            L"KittyChat/1.0",
+            WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+            WINHTTP_NO_PROXY_NAME,
+            WINHTTP_NO_PROXY_BYPASS,
+            0
+        );
+
+        if (!m_httpSession)
+            return nullptr;
     }
 
     // Connexion au serveur avec le port approprié
-    HINTERNET hConnect = WinHttpConnect(
-        hSession,
+    m_httpConnect = WinHttpConnect(
+        static_cast<HINTERNET>(m_httpSession),
         wHost.c_str(),
         static_cast<INTERNET_PORT>(port),
         0
     );
+    m_httpsEnabled = useHttps;
+    return m_httpConnect;
+}
 
+/**
+ * @brief Effectue une requête HTTP vers l'API Matrix
+ * 
+ * Cette fonction utilise WinHTTP (API Windows native) pour effectuer des requêtes HTTPS
+ * vers le serveur Matrix. WinHTTP gère automatiquement :
+ * - La validation des certificats SSL via le magasin Windows
+ * - La négociation TLS (TLS 1.2+)
+ * - La gestion des proxies système
+ * 
+ * Sécurité : Toutes les communications sont chiffrées via HTTPS (TLS).
+ * Le token d'accès est inclus dans le header Authorization si disponible.
+ * 
+ * @param method Méthode HTTP (GET, POST, PUT)
+ * @param endpoint Point de terminaison de l'API (ex: /_matrix/client/v3/login)
+ * @param body Corps de la requête (JSON pour POST/PUT)
+ * @param response Réponse reçue du serveur (JSON)
+ * @param operation Authentification à laquelle rattacher la requête (annulable)
+ * @return true si la requête a réussi (code HTTP 2xx)
+ */
+bool MatrixClient::HttpRequest(const std::string& method, const std::string& endpoint,
+                               const std::string& body, std::string& response,
+                               AuthOperation* operation)
+{
+    // Une requête d'authentification tourne hors du thread de rendu :
+    // son erreur reste dans l'opération
+    auto reportError = [this, operation](const char* message)
+    {
+        if (operation)
+            operation->m_error = message;
+        else
+            m_lastError = message;
+    };
+
+    HINTERNET hConnect = static_cast<HINTERNET>(AcquireConnection());
     if (!hConnect)
     {
-        WinHttpCloseHandle(hSession);
-        m_lastError = "Impossible de se connecter au serveur";
+        reportError("Impossible de se connecter au serveur");
         return false;
     }
 
@@ -777,7 +1859,7 @@ bool MatrixClient::HttpRequest(const std::string& method, const std::string& end
     std::wstring wMethod(method.begin(), method.end());
 
     // Création de la requête (avec ou sans HTTPS)
-    DWORD flags = useHttps ? WINHTTP_FLAG_SECURE : 0;
+    DWORD flags = m_httpsEnabled ? WINHTTP_FLAG_SECURE : 0;
     HINTERNET hRequest = WinHttpOpenRequest(
         hConnect,
         wMethod.c_str(),
@@ -790,12 +1872,24 @@ bool MatrixClient::HttpRequest(const std::string& method, const std::string& end
 
     if (!hRequest)
     {
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        m_lastError = "Impossible de créer la requête";
+        reportError("Impossible de créer la requête");
         return false;
     }
 
+    // Rattachement à l'opération pour qu'une annulation interrompe la requête
+    if (operation && !operation->AttachRequest(hRequest))
+    {
+        WinHttpCloseHandle(hRequest);
+        return false;
+    }
+
+    // Fermeture du handle, sauf si une annulation l'a déjà fermé
+    auto closeRequest = [&]()
+    {
+        if (!operation || operation->DetachRequest())
+            WinHttpCloseHandle(hRequest);
+    };
+
     // Ajout des headers
     std::wstring headers = L"Content-Type: application/json\r\n";
     if (!m_accessToken.empty())
@@ -819,10 +1913,8 @@ bool MatrixClient::HttpRequest(const std::string& method, const std::string& end
 
     if (!bResults)
     {
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        m_lastError = "Erreur lors de l'envoi de la requête";
+        closeRequest();
+        reportError("Erreur lors de l'envoi de la requête");
         return false;
     }
 
@@ -831,10 +1923,8 @@ bool MatrixClient::HttpRequest(const std::string& method, const std::string& end
 
     if (!bResults)
     {
-        WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
-        m_lastError = "Erreur lors de la réception de la réponse";
+        closeRequest();
+        reportError("Erreur lors de la réception de la réponse");
         return false;
     }
 
@@ -852,23 +1942,54 @@ bool MatrixClient::HttpRequest(const std::string& method, const std::string& end
         if (dwSize == 0)
             break;
 
-        std::vector<char> buffer(dwSize + 1);
-        if (!WinHttpReadData(hRequest, buffer.data(), dwSize, &dwDownloaded))
+        // Lecture directe à la fin de la réponse, sans tampon intermédiaire
+        size_t previousSize = response.size();
+        response.resize(previousSize + dwSize);
+        if (!WinHttpReadData(hRequest, &response[previousSize], dwSize, &dwDownloaded))
+        {
+            response.resize(previousSize);
             break;
-
-        buffer[dwDownloaded] = '\0';
-        response += buffer.data();
+        }
+        response.resize(previousSize + dwDownloaded);
 
     } while (dwSize > 0);
 
-    // Nettoyage
-    WinHttpCloseHandle(hRequest);
-    WinHttpCloseHandle(hConnect);
-    WinHttpCloseHandle(hSession);
+    // Nettoyage (la connexion reste dans le pool de la session)
+    closeRequest();
 
     return true;
 }
 
+#else
+
+/**
+ * @brief Pas de transport HTTP hors Windows
+ * 
+ * Les autres plateformes ne servent qu'au pilote headless, alimenté par
+ * StartOfflineSession() : aucune requête ne doit partir.
+ */
+void* MatrixClient::AcquireConnection()
+{
+    return nullptr;
+}
+
+bool MatrixClient::HttpRequest(const std::string& method, const std::string& endpoint,
+                               const std::string& body, std::string& response,
+                               AuthOperation* operation)
+{
+    (void)method;
+    (void)endpoint;
+    (void)body;
+    (void)response;
+    if (operation)
+        operation->m_error = "Aucun transport HTTP sur cette plateforme";
+    else
+        m_lastError = "Aucun transport HTTP sur cette plateforme";
+    return false;
+}
+
+#endif // _WIN32
+
 /**
  * @brief Génère un identifiant de transaction unique
  * 
@@ -901,7 +2022,7 @@ std::string MatrixClient::GenerateTransactionId()
 /**
  * @brief Retourne l'état de connexion sous forme de texte
  */
-std::string MatrixClient::GetConnectionStatus() const
+const char* MatrixClient::GetConnectionStatus() const
 {
     if (!m_isLoggedIn)
         return "Endormi zzZ";
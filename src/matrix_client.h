@@ -22,19 +22,37 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <map>
+#include <condition_variable>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include "batch_arena.h"
+#include "room_list.h"
+#include "spsc_queue.h"
+#include "timeline_store.h"
 
 /**
  * @struct Message
  * @brief Représente un message dans un salon Matrix
+ * 
+ * Format de transport entre la synchronisation et le thread de rendu ;
+ * une fois dans un salon, le message est rangé dans le TimelineStore.
  */
 struct Message
 {
     std::string id;         // Identifiant unique du message
     std::string sender;     // Identifiant de l'expéditeur (@user:server)
     std::string senderName; // Nom d'affichage de l'expéditeur
-    std::string content;    // Contenu du message
-    std::string timestamp;  // Horodatage du message
-    bool isOwn;             // true si c'est notre propre message
+    std::string content;    // Contenu du message (si non référencé dans la réponse)
+    uint32_t bodyOffset = 0;    // Position du corps dans la réponse de sync
+    uint32_t bodyLength = 0;    // Longueur du corps dans la réponse de sync
+    bool bodyInPayload = false; // true si le corps est lu directement dans la réponse
+    long long timestamp = 0; // Horodatage serveur (ms depuis epoch)
+    bool isOwn = false;     // true si c'est notre propre message
 };
 
 /**
@@ -46,8 +64,134 @@ struct Room
     std::string id;         // Identifiant du salon (!xxx:server)
     std::string name;       // Nom du salon
     std::string topic;      // Sujet/description du salon
-    int unreadCount;        // Nombre de messages non lus
-    std::vector<Message> messages;  // Messages du salon
+    std::string alias;      // Alias canonique (#nom:server), peut être vide
+    int unreadCount;        // Nombre de notifications non lues (compté par le serveur)
+    int highlightCount;     // Nombre de mentions non lues (compté par le serveur)
+    std::string lastEventId;  // Dernier événement connu de la timeline
+    std::string readEventId;  // Dernier événement marqué comme lu (m.read)
+    long long lastActivity;   // Horodatage du dernier message (ms), pour le tri
+    bool isFavourite;         // Tag m.favourite
+    uint32_t revision;        // Incrémenté à chaque changement visible dans la liste
+    TimelineStore timeline; // Messages du salon (stockage en colonnes)
+};
+
+/**
+ * @enum RoomDeltaType
+ * @brief Nature d'une mise à jour produite par la synchronisation
+ */
+enum class RoomDeltaType
+{
+    Join,       // Salon découvert (sans autre événement)
+    Name,       // Changement de nom
+    Topic,      // Changement de sujet
+    Alias,      // Changement d'alias canonique
+    Messages,   // Nouveaux messages à ajouter à la fin
+    Unread,     // Compteurs unread_notifications et dernier événement
+    ReadReceipt, // Notre accusé de lecture m.read (venant d'un autre appareil ou de nous)
+    Tags,       // Tags du salon (m.tag dans les données de compte)
+    SyncDone    // Fin d'une réponse de sync, même sans message (sans salon)
+};
+
+/**
+ * @struct RoomDelta
+ * @brief Mise à jour d'un salon, transmise du thread de sync au thread UI
+ */
+struct RoomDelta
+{
+    RoomDeltaType type = RoomDeltaType::Join;
+    std::string roomId;             // Salon concerné
+    std::string value;              // Nouveau nom, sujet, alias ou identifiant d'événement
+    std::vector<Message> messages;  // Messages à ajouter (type Messages)
+    std::shared_ptr<const PayloadChunk> payload; // Réponse de sync d'origine des messages
+    int notificationCount = 0;      // Non lus (type Unread)
+    int highlightCount = 0;         // Mentions (type Unread)
+    bool favourite = false;         // Tag m.favourite présent (type Tags)
+    uint32_t serial = 0;            // Numéro de la réponse traitée (type SyncDone)
+};
+
+/**
+ * @enum AuthStage
+ * @brief Étape d'une connexion ou inscription en cours
+ */
+enum class AuthStage
+{
+    Connecting,     // Attente de la connexion préchauffée au serveur
+    Authenticating, // Requête de login/register envoyée
+    InteractiveAuth,// Deuxième étape de l'inscription (session du serveur)
+    StartingSync,   // Connecté, démarrage de la synchronisation
+    Done,           // Terminé avec succès
+    Failed,         // Terminé en erreur (voir AuthOperation::GetError)
+    Cancelled       // Annulé par l'utilisateur
+};
+
+/**
+ * @class AuthOperation
+ * @brief Suivi et annulation d'une connexion ou inscription asynchrone
+ * 
+ * Partagée entre le thread de rendu (qui lit l'étape et peut annuler) et
+ * le thread qui exécute les requêtes HTTP.
+ */
+class AuthOperation
+{
+public:
+    /**
+     * @brief Étape courante (lisible depuis n'importe quel thread)
+     */
+    AuthStage GetStage() const { return m_stage; }
+
+    /**
+     * @brief Annule l'opération et interrompt la requête HTTP en cours
+     * 
+     * Sans effet une fois la synchronisation démarrée.
+     */
+    void Cancel();
+
+    /**
+     * @brief Indique si l'annulation a été demandée
+     */
+    bool IsCancelled() const { return m_cancelled; }
+
+    /**
+     * @brief Message d'erreur (valide une fois le résultat disponible)
+     */
+    const std::string& GetError() const { return m_error; }
+
+private:
+    friend class MatrixClient;
+
+    std::atomic<AuthStage> m_stage{ AuthStage::Connecting };
+    std::atomic<bool> m_cancelled{ false };
+    std::mutex m_requestMutex;
+    void* m_activeRequest = nullptr;    // Requête WinHTTP en cours (HINTERNET)
+    std::string m_error;                // Écrit par le thread de l'opération uniquement
+
+    // Session obtenue, recopiée dans le client par MatrixClient::FinishAuth
+    // (thread de rendu) une fois le résultat de la tâche disponible
+    std::string m_accessToken;
+    std::string m_userId;
+    std::string m_deviceId;
+
+    /**
+     * @brief Enregistre la requête en cours pour pouvoir l'interrompre
+     * @return false si l'opération est déjà annulée
+     */
+    bool AttachRequest(void* request);
+
+    /**
+     * @brief Oublie la requête en cours
+     * @return false si Cancel() l'a déjà fermée
+     */
+    bool DetachRequest();
+};
+
+/**
+ * @struct AuthTask
+ * @brief Connexion ou inscription lancée en arrière-plan
+ */
+struct AuthTask
+{
+    std::future<bool> result;                   // true si l'utilisateur est connecté
+    std::shared_ptr<AuthOperation> operation;   // Progression et annulation
 };
 
 /**
@@ -77,20 +221,40 @@ public:
     // === Méthodes d'authentification ===
     
     /**
-     * @brief Tente de se connecter au serveur Matrix
+     * @brief Lance la connexion au serveur Matrix en arrière-plan
+     * 
+     * Le thread de rendu n'est jamais bloqué : il suit la progression via
+     * AuthTask::operation et récupère le résultat quand le future est prêt.
      * @param username Nom d'utilisateur (avec ou sans @user:server)
      * @param password Mot de passe
-     * @return true si la connexion a réussi
      */
-    bool Login(const std::string& username, const std::string& password);
+    AuthTask LoginAsync(const std::string& username, const std::string& password);
     
     /**
-     * @brief Crée un nouveau compte sur le serveur Matrix
+     * @brief Lance la création d'un compte en arrière-plan
      * @param username Nom d'utilisateur souhaité
      * @param password Mot de passe
-     * @return true si l'inscription a réussi
      */
-    bool Register(const std::string& username, const std::string& password);
+    AuthTask RegisterAsync(const std::string& username, const std::string& password);
+
+    /**
+     * @brief Ouvre la session obtenue par une connexion ou inscription réussie
+     * 
+     * À appeler depuis le thread de rendu quand AuthTask::result vaut true :
+     * le token et l'identifiant ne sont écrits qu'ici, jamais pendant que
+     * l'interface les lit. Démarre la synchronisation.
+     * @param operation Opération terminée avec succès
+     */
+    void FinishAuth(AuthOperation& operation);
+
+    /**
+     * @brief Ouvre la connexion au serveur (DNS, TCP, TLS) en arrière-plan
+     * 
+     * À appeler dès l'affichage de l'écran de connexion : la connexion reste
+     * dans le pool WinHTTP et la requête de login n'a plus qu'à l'utiliser.
+     * Les appels suivants sont sans effet.
+     */
+    void WarmUpConnection();
     
     /**
      * @brief Déconnecte l'utilisateur actuel
@@ -116,6 +280,21 @@ public:
      * @return Référence vers le vecteur de salons
      */
     const std::vector<Room>& GetRooms() const { return m_rooms; }
+
+    /**
+     * @brief Retourne l'ordre d'affichage des salons (index dans GetRooms())
+     * 
+     * Favoris, puis salons non lus, puis activité la plus récente ; mis à
+     * jour au fil des changements sans retrier toute la liste.
+     */
+    const RoomList& GetRoomOrder() const { return m_roomOrder; }
+
+    /**
+     * @brief Compteur qui change dès qu'un salon change de libellé ou de place
+     * 
+     * Permet à l'interface de ne reconstruire sa liste qu'après un changement.
+     */
+    uint64_t GetRoomsRevision() const { return m_roomsRevision; }
     
     /**
      * @brief Sélectionne un salon comme actif
@@ -123,6 +302,15 @@ public:
      */
     void SelectRoom(const std::string& roomId);
     
+    /**
+     * @brief Marque un salon comme lu jusqu'à son dernier événement
+     * 
+     * L'accusé m.read et le marqueur m.fully_read sont envoyés en arrière-plan,
+     * regroupés et différés pour ne pas émettre une requête par message.
+     * @param roomId Identifiant du salon
+     */
+    void MarkRoomRead(const std::string& roomId);
+    
     /**
      * @brief Retourne le salon actuellement sélectionné
      * @return Pointeur vers le salon ou nullptr
@@ -164,6 +352,26 @@ public:
      */
     void StopSync();
 
+    /**
+     * @brief Ouvre une session hors ligne qui rejoue des réponses /sync
+     * 
+     * Aucune requête réseau : chaque réponse suit le chemin d'une vraie
+     * synchronisation (analyse dans le thread de sync, file de deltas,
+     * PumpEvents). Sert au pilote headless qui mesure le rendu.
+     * @param userId Identifiant de l'utilisateur simulé
+     * @param syncResponses Corps JSON des réponses, dans l'ordre
+     */
+    void StartOfflineSession(const std::string& userId, std::vector<std::string> syncResponses);
+    
+    /**
+     * @brief Applique les mises à jour reçues par la synchronisation
+     * 
+     * À appeler une fois par frame depuis le thread de rendu : c'est le seul
+     * endroit où les salons sont modifiés par la synchronisation.
+     * @param budgetMs Temps maximum consacré à l'application (en ms)
+     */
+    void PumpEvents(double budgetMs);
+
     // === Callbacks pour les mises à jour ===
     
     /**
@@ -181,31 +389,76 @@ public:
     
     /**
      * @brief Retourne l'état de connexion sous forme de texte
+     * @return Chaîne constante (aucune allocation, appelée à chaque frame)
+     */
+    const char* GetConnectionStatus() const;
+
+    /**
+     * @brief Nombre d'événements du dernier lot de synchronisation traité
      */
-    std::string GetConnectionStatus() const;
+    size_t GetLastSyncEventCount() const { return m_lastSyncEvents; }
+
+    /**
+     * @brief Allocations temporaires servies par l'arène pour ce dernier lot
+     */
+    size_t GetLastSyncArenaAllocations() const { return m_lastSyncArenaAllocations; }
 
 private:
+    // Traitements des événements de sync (voir SyncEvents dans matrix_client.cpp)
+    friend struct SyncEventHandlers;
+
     // Configuration du serveur
     std::string m_homeserver;       // URL du serveur Matrix
     std::string m_accessToken;      // Token d'accès pour les requêtes
     std::string m_userId;           // Identifiant de l'utilisateur
     std::string m_deviceId;         // Identifiant de l'appareil
     
+    // Connexion HTTP partagée par toutes les requêtes (réutilisation des
+    // connexions TCP/TLS par WinHTTP)
+    std::mutex m_httpMutex;
+    void* m_httpSession = nullptr;  // HINTERNET de session
+    void* m_httpConnect = nullptr;  // HINTERNET de connexion au serveur
+    bool m_httpsEnabled = true;     // Serveur en HTTPS
+    std::thread m_warmUpThread;
+    std::atomic<bool> m_warmUpStarted{ false };
+    
     // État de connexion
     std::atomic<bool> m_isLoggedIn;
     std::atomic<bool> m_isSyncing;
     std::string m_lastError;
     std::string m_syncToken;        // Token pour la synchronisation incrémentale
     
-    // Données des salons
+    // Données des salons (modifiées uniquement par le thread de rendu)
     std::vector<Room> m_rooms;
+    std::unordered_map<std::string, uint32_t> m_roomIndex; // roomId -> index dans m_rooms
+    RoomList m_roomOrder;           // Ordre d'affichage des salons
+    uint64_t m_roomsRevision = 0;   // Voir GetRoomsRevision()
     std::string m_selectedRoomId;
-    mutable std::mutex m_roomsMutex;
+    
+    // Mises à jour en transit du thread de sync vers le thread de rendu
+    SpscQueue<RoomDelta> m_deltaQueue;
+    std::deque<RoomDelta> m_pendingDeltas;          // Débordement côté sync (file pleine)
+    std::unordered_set<std::string> m_syncKnownRooms; // Salons déjà annoncés par la sync
+    uint32_t m_payloadSerial = 0;       // Dernier lot reçu (thread de sync)
+    uint32_t m_appliedPayloadSerial = 0; // Dernier lot appliqué (thread de rendu)
+    uint32_t m_compactedBeforeSerial = 0; // Lots antérieurs déjà recopiés dans les arènes
+
+    // Objets temporaires d'un lot (DOM JSON...), libérés d'un coup après traitement
+    BatchArena m_syncArena;
+    std::atomic<size_t> m_lastSyncEvents{ 0 };
+    std::atomic<size_t> m_lastSyncArenaAllocations{ 0 };
     
     // Thread de synchronisation
     std::thread m_syncThread;
     std::atomic<bool> m_stopSync;
     
+    // Envoi différé des accusés de lecture (roomId -> eventId)
+    std::thread m_receiptThread;
+    std::mutex m_receiptMutex;
+    std::condition_variable m_receiptCv;
+    std::map<std::string, std::string> m_pendingReceipts;
+    std::chrono::steady_clock::time_point m_lastReceiptRequest;
+    
     // Callback pour notifier les mises à jour
     std::function<void()> m_updateCallback;
     
@@ -217,21 +470,96 @@ private:
      * @param endpoint Point de terminaison de l'API
      * @param body Corps de la requête (JSON)
      * @param response Réponse reçue
+     * @param operation Authentification à laquelle rattacher la requête (annulable)
      * @return true si la requête a réussi
      */
     bool HttpRequest(const std::string& method, const std::string& endpoint,
-                     const std::string& body, std::string& response);
+                     const std::string& body, std::string& response,
+                     AuthOperation* operation = nullptr);
+
+    /**
+     * @brief Retourne la connexion partagée au serveur, ouverte au premier appel
+     * @return Handle de connexion WinHTTP, nullptr en cas d'échec
+     */
+    void* AcquireConnection();
+
+    /**
+     * @brief Connexion (exécutée par LoginAsync dans un thread séparé)
+     */
+    bool RunLogin(const std::string& username, const std::string& password, AuthOperation& operation);
+
+    /**
+     * @brief Inscription (exécutée par RegisterAsync dans un thread séparé)
+     */
+    bool RunRegister(const std::string& username, const std::string& password, AuthOperation& operation);
+
+    /**
+     * @brief Termine une authentification réussie (voir FinishAuth)
+     */
+    bool CompleteAuth(const std::string& accessToken, const std::string& userId,
+                      const std::string& deviceId, AuthOperation& operation);
     
     /**
      * @brief Boucle de synchronisation exécutée dans un thread séparé
      */
     void SyncLoop();
+
+    /**
+     * @brief Boucle de synchronisation d'une session hors ligne
+     */
+    void ReplaySyncLoop(std::vector<std::string> syncResponses);
     
     /**
      * @brief Traite la réponse de synchronisation
-     * @param syncResponse Réponse JSON du serveur
+     * @param payload Réponse JSON du serveur, conservée tant que des messages y pointent
+     */
+    void ProcessSyncResponse(const std::shared_ptr<const PayloadChunk>& payload);
+    
+    /**
+     * @brief Boucle d'envoi des accusés de lecture en attente
+     */
+    void ReceiptLoop();
+    
+    /**
+     * @brief Envoie des accusés de lecture (un POST /read_markers par salon)
+     * @param receipts roomId -> eventId
+     */
+    void SendReadReceipts(const std::map<std::string, std::string>& receipts);
+    
+    /**
+     * @brief Transmet une mise à jour au thread de rendu (thread de sync)
+     * 
+     * Si la file est pleine, la mise à jour est gardée en attente et fusionnée
+     * avec la précédente quand il s'agit de messages du même salon.
+     */
+    void QueueDelta(RoomDelta&& delta);
+
+    /**
+     * @brief Retourne un salon par son identifiant (nullptr si inconnu)
+     */
+    Room* FindRoom(const std::string& roomId);
+    const Room* FindRoom(const std::string& roomId) const;
+
+    /**
+     * @brief Replace un salon dans l'ordre d'affichage après un changement
+     */
+    void UpdateRoomOrder(const Room& room);
+
+    /**
+     * @brief Signale un changement du libellé d'un salon (nom, alias, compteurs, tags)
+     */
+    void TouchRoom(Room& room);
+    
+    /**
+     * @brief Pousse les mises à jour en attente dans la file (thread de sync)
+     * @return true si plus rien n'est en attente
+     */
+    bool FlushPendingDeltas();
+    
+    /**
+     * @brief Applique une mise à jour aux salons (thread de rendu)
      */
-    void ProcessSyncResponse(const std::string& syncResponse);
+    void ApplyDelta(RoomDelta& delta);
     
     /**
      * @brief Génère un identifiant de transaction unique
@@ -0,0 +1,150 @@
+/**
+ * @file media_fetcher.cpp
+ * @brief Implémentation du chargement des médias Matrix
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "media_fetcher.h"
+#include <vector>
+
+/**
+ * @brief Caractère autorisé dans un identifiant de média : [A-Za-z0-9_-]
+ */
+static bool IsMediaIdChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+/**
+ * @brief Caractère autorisé dans un nom de serveur (nom DNS, IPv4,
+ * IPv6 entre crochets, port)
+ */
+static bool IsServerNameChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+        || c == '-' || c == '.' || c == ':' || c == '[' || c == ']';
+}
+
+/**
+ * @brief Constructeur
+ */
+MediaFetcher::MediaFetcher(TextureManager* textures)
+    : m_textures(textures)
+{
+}
+
+/**
+ * @brief Serveur de l'utilisateur et token d'accès
+ */
+void MediaFetcher::SetServer(const std::string& homeserver, const std::string& accessToken)
+{
+    m_homeserver = homeserver;
+    while (!m_homeserver.empty() && m_homeserver.back() == '/')
+        m_homeserver.pop_back();
+    m_authorization = accessToken.empty() ? std::string() : "Bearer " + accessToken;
+}
+
+/**
+ * @brief Découpe une URI mxc://
+ *
+ * Les caractères sont vérifiés : ils finissent dans le chemin de l'URL,
+ * un identifiant comme "../" ne doit pas pouvoir en sortir.
+ */
+bool MediaFetcher::ParseMxc(const std::string& mxcUri, std::string& serverName, std::string& mediaId)
+{
+    static const char PREFIX[] = "mxc://";
+    const size_t prefixLength = sizeof(PREFIX) - 1;
+    if (mxcUri.compare(0, prefixLength, PREFIX) != 0)
+        return false;
+
+    const size_t slash = mxcUri.find('/', prefixLength);
+    if (slash == std::string::npos || slash == prefixLength || slash + 1 == mxcUri.size())
+        return false;
+
+    for (size_t i = prefixLength; i < slash; ++i)
+    {
+        if (!IsServerNameChar(mxcUri[i]))
+            return false;
+    }
+    for (size_t i = slash + 1; i < mxcUri.size(); ++i)
+    {
+        if (!IsMediaIdChar(mxcUri[i]))
+            return false;
+    }
+
+    serverName.assign(mxcUri, prefixLength, slash - prefixLength);
+    mediaId.assign(mxcUri, slash + 1, std::string::npos);
+    return true;
+}
+
+/**
+ * @brief URL de la miniature d'un média
+ *
+ * animated=true : un GIF reste animé si le serveur sait le réduire.
+ */
+std::string MediaFetcher::ThumbnailUrl(const std::string& homeserver, const std::string& serverName,
+                                       const std::string& mediaId, int width, int height, ThumbnailMethod method)
+{
+    return homeserver + "/_matrix/client/v1/media/thumbnail/" + serverName + "/" + mediaId
+         + "?width=" + std::to_string(width) + "&height=" + std::to_string(height)
+         + (method == ThumbnailMethod::Crop ? "&method=crop" : "&method=scale")
+         + "&animated=true";
+}
+
+/**
+ * @brief URL du fichier d'origine d'un média
+ */
+std::string MediaFetcher::DownloadUrl(const std::string& homeserver, const std::string& serverName,
+                                      const std::string& mediaId)
+{
+    return homeserver + "/_matrix/client/v1/media/download/" + serverName + "/" + mediaId;
+}
+
+/**
+ * @brief Image d'un média à une taille donnée
+ *
+ * Le nom de l'image dans le TextureManager combine l'URI, la taille et la
+ * méthode : c'est la clé qui regroupe les demandes identiques.
+ */
+ImageHandle MediaFetcher::Request(const std::string& mxcUri, int width, int height, ThumbnailMethod method)
+{
+    ++m_stats.requests;
+
+    const bool original = width <= 0 || height <= 0;
+    std::string name = mxcUri;
+    if (!original)
+    {
+        name += "#" + std::to_string(width) + "x" + std::to_string(height);
+        if (method == ThumbnailMethod::Crop)
+            name += "-crop";
+    }
+
+    ImageHandle handle = m_textures->Find(name);
+    if (handle.IsValid())
+    {
+        ++m_stats.coalesced;
+        return handle;
+    }
+
+    std::string serverName;
+    std::string mediaId;
+    if (m_homeserver.empty() || !ParseMxc(mxcUri, serverName, mediaId))
+    {
+        ++m_stats.invalid;
+        return ImageHandle();
+    }
+
+    // Miniature à la taille du widget, puis fichier d'origine si le serveur
+    // ne sait pas la produire (format non pris en charge, miniatures désactivées)
+    std::vector<std::string> urls;
+    if (!original)
+        urls.push_back(ThumbnailUrl(m_homeserver, serverName, mediaId, width, height, method));
+    urls.push_back(DownloadUrl(m_homeserver, serverName, mediaId));
+
+    ++m_stats.downloads;
+    handle = m_textures->LoadImageFromUrls(urls, name, m_authorization);
+    if (!original)
+        m_textures->SetTargetSize(handle, width, height);
+    return handle;
+}
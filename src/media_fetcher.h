@@ -0,0 +1,117 @@
+/**
+ * @file media_fetcher.h
+ * @brief Chargement des médias Matrix (mxc://) à leur taille d'affichage
+ *
+ * Une URI mxc://serveur/identifiant est résolue auprès du serveur de
+ * l'utilisateur : la miniature est demandée à la taille exacte du widget
+ * (/_matrix/client/v1/media/thumbnail), avec repli sur le fichier d'origine
+ * (/_matrix/client/v1/media/download) si le serveur n'en fournit pas. Les
+ * deux points d'accès exigent le token d'accès (médias authentifiés).
+ *
+ * Les images passent par le TextureManager : une même URI demandée à la
+ * même taille par plusieurs widgets ne donne qu'un téléchargement, et
+ * l'image est rangée dans l'atlas au plus à cette taille, même quand le
+ * fichier d'origine remplace la miniature.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef MEDIA_FETCHER_H
+#define MEDIA_FETCHER_H
+
+#include "texture_manager.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum ThumbnailMethod
+ * @brief Façon dont le serveur ramène le média à la taille demandée
+ */
+enum class ThumbnailMethod
+{
+    Scale,      // Proportions gardées, dans la taille demandée (images des messages)
+    Crop        // Recadré pour remplir la taille demandée (avatars)
+};
+
+/**
+ * @class MediaFetcher
+ * @brief Résout les URI mxc:// et charge leurs miniatures dans le TextureManager
+ *
+ * S'utilise depuis le thread de rendu, comme le TextureManager.
+ */
+class MediaFetcher
+{
+public:
+    /**
+     * @struct Stats
+     * @brief Compteurs des demandes
+     */
+    struct Stats
+    {
+        uint64_t requests = 0;      // Appels à Request
+        uint64_t coalesced = 0;     // Demandes servies par une image déjà demandée
+        uint64_t downloads = 0;     // Téléchargements lancés
+        uint64_t invalid = 0;       // URI mxc:// mal formées, ou serveur non configuré
+    };
+
+    /**
+     * @brief Constructeur
+     * @param textures Gestionnaire qui télécharge et range les images
+     */
+    explicit MediaFetcher(TextureManager* textures);
+
+    /**
+     * @brief Serveur de l'utilisateur et token d'accès
+     * @param homeserver URL du serveur (https://exemple.org)
+     * @param accessToken Token d'accès de la session
+     *
+     * Les images déjà demandées ne sont pas rechargées.
+     */
+    void SetServer(const std::string& homeserver, const std::string& accessToken);
+
+    /**
+     * @brief Image d'un média à une taille donnée
+     * @param mxcUri URI du média (mxc://serveur/identifiant)
+     * @param width Largeur d'affichage en pixels (0 : fichier d'origine)
+     * @param height Hauteur d'affichage en pixels (0 : fichier d'origine)
+     * @param method Mise à l'échelle ou recadrage par le serveur
+     * @return Handle de l'image (invalide si l'URI est mal formée)
+     *
+     * Peut être appelée à chaque frame : seule la première demande d'une
+     * URI à une taille lance un téléchargement. Un média introuvable n'est
+     * pas redemandé.
+     */
+    ImageHandle Request(const std::string& mxcUri, int width, int height,
+                        ThumbnailMethod method = ThumbnailMethod::Scale);
+
+    /**
+     * @brief Compteurs des demandes
+     */
+    const Stats& GetStats() const { return m_stats; }
+
+    /**
+     * @brief Découpe une URI mxc:// en serveur d'origine et identifiant
+     * @return false si l'URI est mal formée (caractères hors de la norme)
+     */
+    static bool ParseMxc(const std::string& mxcUri, std::string& serverName, std::string& mediaId);
+
+    /**
+     * @brief URL de la miniature d'un média
+     */
+    static std::string ThumbnailUrl(const std::string& homeserver, const std::string& serverName,
+                                    const std::string& mediaId, int width, int height, ThumbnailMethod method);
+
+    /**
+     * @brief URL du fichier d'origine d'un média
+     */
+    static std::string DownloadUrl(const std::string& homeserver, const std::string& serverName,
+                                   const std::string& mediaId);
+
+private:
+    TextureManager* m_textures;
+    std::string m_homeserver;       // Sans '/' final
+    std::string m_authorization;    // "Bearer <token>"
+    Stats m_stats;
+};
+
+#endif // MEDIA_FETCHER_H
@@ -0,0 +1,352 @@
+/**
+ * @file particle_field.cpp
+ * @brief Implémentation du champ d'étoiles du fond animé
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "particle_field.h"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+// Une frame plus longue que ça (30 FPS) compte comme une surcharge
+static const float FRAME_PRESSURE_SECONDS = 1.0f / 30.0f;
+
+// Particules toujours gardées, même sous forte charge
+static const size_t MIN_ACTIVE_PARTICLES = 16;
+
+// Frames d'attente après une réduction avant de pouvoir remonter
+static const int GROW_COOLDOWN_FRAMES = 30;
+
+// Particules par lot de géométrie : 2 disques de 16 sommets au plus chacune,
+// soit moins de 65536 sommets (index 16 bits)
+static const size_t EMIT_CHUNK = 1024;
+static const int DISC_SEGMENTS = 8;
+static const int DISC_VERTICES = DISC_SEGMENTS * 2;                          // Anneau intérieur + frange
+static const int DISC_INDICES = (DISC_SEGMENTS - 2) * 3 + DISC_SEGMENTS * 6; // Éventail + frange
+
+static const float TWO_PI = 6.28318530718f;
+static const float INV_TWO_PI = 0.15915494309f;
+static const float HALF_PI = 1.57079632679f;
+
+/**
+ * @brief Arrondit au multiple de 4 supérieur (groupes SIMD complets)
+ */
+static size_t RoundUp4(size_t count)
+{
+    return (count + 3) & ~static_cast<size_t>(3);
+}
+
+/**
+ * @brief Sinus approché (erreur < 0.001), suffisant pour l'animation
+ *
+ * Réduction à [-pi, pi] puis approximation parabolique corrigée ; la
+ * version SSE2 fait exactement les mêmes opérations sur 4 valeurs.
+ */
+static float FastSin(float x)
+{
+    x -= TWO_PI * std::nearbyint(x * INV_TWO_PI);
+    const float b = 4.0f / 3.14159265359f;
+    const float c = -4.0f / (3.14159265359f * 3.14159265359f);
+    float y = b * x + c * x * std::fabs(x);
+    return 0.225f * (y * std::fabs(y) - y) + y;
+}
+
+#ifdef PARTICLES_SSE2
+static inline __m128 FastSin4(__m128 x)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 b = _mm_set1_ps(4.0f / 3.14159265359f);
+    const __m128 c = _mm_set1_ps(-4.0f / (3.14159265359f * 3.14159265359f));
+    const __m128 p = _mm_set1_ps(0.225f);
+
+    // Arrondi au plus proche (mode par défaut du MXCSR)
+    __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(INV_TWO_PI))));
+    x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(TWO_PI)));
+
+    __m128 y = _mm_add_ps(_mm_mul_ps(b, x), _mm_mul_ps(c, _mm_mul_ps(x, _mm_and_ps(x, absMask))));
+    __m128 refined = _mm_sub_ps(_mm_mul_ps(y, _mm_and_ps(y, absMask)), y);
+    return _mm_add_ps(_mm_mul_ps(p, refined), y);
+}
+
+/**
+ * @brief Ramène v dans [low, low + span] (une seule période suffit ici)
+ */
+static inline __m128 Wrap4(__m128 v, __m128 low, __m128 span)
+{
+    __m128 high = _mm_add_ps(low, span);
+    v = _mm_add_ps(v, _mm_and_ps(_mm_cmplt_ps(v, low), span));
+    return _mm_sub_ps(v, _mm_and_ps(_mm_cmpgt_ps(v, high), span));
+}
+#endif
+
+/**
+ * @brief Constructeur
+ */
+ParticleField::ParticleField(uint32_t seed, size_t count)
+    : m_rngState(seed ? seed : 0x9E3779B9u)
+    , m_target(0)
+    , m_active(0)
+    , m_budgetMs(1.0)
+    , m_lastCostMs(0.0)
+    , m_growCooldown(0)
+{
+    SetTargetCount(count);
+    m_active = m_target;
+}
+
+/**
+ * @brief Nombre pseudo-aléatoire dans [0, 1) (xorshift32)
+ */
+float ParticleField::NextRandom()
+{
+    m_rngState ^= m_rngState << 13;
+    m_rngState ^= m_rngState >> 17;
+    m_rngState ^= m_rngState << 5;
+    return static_cast<float>(m_rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Génère les attributs jusqu'à count particules
+ *
+ * Les particules déjà générées sont gardées : réduire puis remonter le
+ * nombre de particules redonne les mêmes étoiles.
+ */
+void ParticleField::Generate(size_t count)
+{
+    size_t padded = RoundUp4(count);
+    for (size_t i = m_baseX.size(); i < padded; ++i)
+    {
+        m_baseX.push_back(NextRandom());
+        m_baseY.push_back(NextRandom());
+        m_speed.push_back(0.2f + NextRandom() * 0.5f);
+        m_size.push_back(1.0f + NextRandom() * 3.0f);
+        m_alpha.push_back(0.3f + NextRandom() * 0.7f);
+        m_phase.push_back(static_cast<float>(i));
+    }
+    m_posX.resize(m_baseX.size());
+    m_posY.resize(m_baseX.size());
+    m_twinkle.resize(m_baseX.size());
+}
+
+/**
+ * @brief Change le nombre de particules souhaité
+ */
+void ParticleField::SetTargetCount(size_t count)
+{
+    Generate(count);
+    m_target = count;
+    m_active = std::min(m_active, m_target);
+}
+
+/**
+ * @brief Anime et dessine les particules
+ */
+void ParticleField::Render(ImDrawList* drawList, float x, float y, float width, float height,
+                           float time, float frameDelta)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    if (m_active > 0 && width > 0.0f && height > 0.0f)
+    {
+        Animate(x, y, width, height, time);
+        Emit(drawList);
+    }
+
+    m_lastCostMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Adapt(m_lastCostMs, frameDelta);
+}
+
+/**
+ * @brief Calcule positions et scintillement
+ *
+ * Oscillation douce autour de la position de base (±10 px en X, ±20 px en
+ * Y), repliée dans la zone, et scintillement propre à chaque étoile.
+ */
+void ParticleField::Animate(float x, float y, float width, float height, float time)
+{
+    const size_t count = RoundUp4(m_active);
+    size_t i = 0;
+
+#ifdef PARTICLES_SSE2
+    const __m128 originX = _mm_set1_ps(x);
+    const __m128 originY = _mm_set1_ps(y);
+    const __m128 spanX = _mm_set1_ps(width);
+    const __m128 spanY = _mm_set1_ps(height);
+    const __m128 t = _mm_set1_ps(time);
+    const __m128 halfT = _mm_set1_ps(time * 0.5f);
+    const __m128 twinkleT = _mm_set1_ps(time * 3.0f);
+    const __m128 halfPi = _mm_set1_ps(HALF_PI);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    for (; i < count; i += 4)
+    {
+        __m128 speed = _mm_loadu_ps(&m_speed[i]);
+        __m128 phase = _mm_loadu_ps(&m_phase[i]);
+
+        // cos(a) = sin(a + pi/2)
+        __m128 offsetX = _mm_mul_ps(FastSin4(_mm_add_ps(_mm_add_ps(_mm_mul_ps(halfT, speed), phase), halfPi)),
+                                    _mm_set1_ps(10.0f));
+        __m128 offsetY = _mm_mul_ps(FastSin4(_mm_add_ps(_mm_mul_ps(t, speed), phase)), _mm_set1_ps(20.0f));
+
+        __m128 px = _mm_add_ps(_mm_add_ps(originX, _mm_mul_ps(_mm_loadu_ps(&m_baseX[i]), spanX)), offsetX);
+        __m128 py = _mm_add_ps(_mm_add_ps(originY, _mm_mul_ps(_mm_loadu_ps(&m_baseY[i]), spanY)), offsetY);
+        _mm_storeu_ps(&m_posX[i], Wrap4(px, originX, spanX));
+        _mm_storeu_ps(&m_posY[i], Wrap4(py, originY, spanY));
+
+        __m128 twinkle = FastSin4(_mm_add_ps(twinkleT, _mm_mul_ps(phase, _mm_set1_ps(0.7f))));
+        _mm_storeu_ps(&m_twinkle[i], _mm_add_ps(half, _mm_mul_ps(half, twinkle)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        float offsetX = FastSin(time * 0.5f * m_speed[i] + m_phase[i] + HALF_PI) * 10.0f;
+        float offsetY = FastSin(time * m_speed[i] + m_phase[i]) * 20.0f;
+
+        float px = x + m_baseX[i] * width + offsetX;
+        float py = y + m_baseY[i] * height + offsetY;
+        if (px < x) px += width;
+        if (px > x + width) px -= width;
+        if (py < y) py += height;
+        if (py > y + height) py -= height;
+
+        m_posX[i] = px;
+        m_posY[i] = py;
+        m_twinkle[i] = 0.5f + 0.5f * FastSin(time * 3.0f + m_phase[i] * 0.7f);
+    }
+}
+
+/**
+ * @brief Écrit un disque antialiasé (8 segments + frange d'un pixel)
+ *
+ * Même principe qu'AddConvexPolyFilled : l'anneau intérieur porte la
+ * couleur, l'anneau extérieur est transparent.
+ */
+static void WriteDisc(ImDrawVert*& vtx, ImDrawIdx*& idx, unsigned int& base, ImVec2 uv,
+                      float cx, float cy, float radius, ImU32 color)
+{
+    static const float COS[DISC_SEGMENTS] = { 1.0f, 0.70710678f, 0.0f, -0.70710678f, -1.0f, -0.70710678f, 0.0f, 0.70710678f };
+    static const float SIN[DISC_SEGMENTS] = { 0.0f, 0.70710678f, 1.0f, 0.70710678f, 0.0f, -0.70710678f, -1.0f, -0.70710678f };
+
+    const ImU32 transparent = color & ~IM_COL32_A_MASK;
+    const float inner = std::max(radius - 0.5f, 0.0f);
+    const float outer = radius + 0.5f;
+
+    for (int k = 0; k < DISC_SEGMENTS; ++k)
+    {
+        vtx[k].pos = ImVec2(cx + COS[k] * inner, cy + SIN[k] * inner);
+        vtx[k].uv = uv;
+        vtx[k].col = color;
+        vtx[DISC_SEGMENTS + k].pos = ImVec2(cx + COS[k] * outer, cy + SIN[k] * outer);
+        vtx[DISC_SEGMENTS + k].uv = uv;
+        vtx[DISC_SEGMENTS + k].col = transparent;
+    }
+
+    // Intérieur en éventail
+    for (int k = 2; k < DISC_SEGMENTS; ++k)
+    {
+        *idx++ = static_cast<ImDrawIdx>(base);
+        *idx++ = static_cast<ImDrawIdx>(base + k - 1);
+        *idx++ = static_cast<ImDrawIdx>(base + k);
+    }
+
+    // Frange
+    for (int k = 0; k < DISC_SEGMENTS; ++k)
+    {
+        unsigned int j = (k + 1) % DISC_SEGMENTS;
+        *idx++ = static_cast<ImDrawIdx>(base + k);
+        *idx++ = static_cast<ImDrawIdx>(base + j);
+        *idx++ = static_cast<ImDrawIdx>(base + DISC_SEGMENTS + j);
+        *idx++ = static_cast<ImDrawIdx>(base + DISC_SEGMENTS + j);
+        *idx++ = static_cast<ImDrawIdx>(base + DISC_SEGMENTS + k);
+        *idx++ = static_cast<ImDrawIdx>(base + k);
+    }
+
+    vtx += DISC_VERTICES;
+    base += DISC_VERTICES;
+}
+
+/**
+ * @brief Écrit les disques dans la draw list, par lots
+ *
+ * Chaque lot réserve le pire cas (étoile + halo pour chaque particule) en
+ * un seul PrimReserve, puis rend ce qui n'a pas servi.
+ */
+void ParticleField::Emit(ImDrawList* drawList) const
+{
+    const ImVec2 uv = drawList->_Data->TexUvWhitePixel;
+
+    for (size_t begin = 0; begin < m_active; begin += EMIT_CHUNK)
+    {
+        const size_t end = std::min(begin + EMIT_CHUNK, m_active);
+        const int reserved = static_cast<int>(end - begin) * 2;
+        drawList->PrimReserve(reserved * DISC_INDICES, reserved * DISC_VERTICES);
+
+        ImDrawVert* vtx = drawList->_VtxWritePtr;
+        ImDrawIdx* idx = drawList->_IdxWritePtr;
+        unsigned int base = drawList->_VtxCurrentIdx;
+        int written = 0;
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const float twinkle = m_twinkle[i];
+            const int alpha = static_cast<int>(m_alpha[i] * twinkle * 255.0f);
+            if (alpha <= 0)
+                continue;
+
+            // Couleur dorée/orange pour les étoiles
+            const ImU32 starColor = IM_COL32(255, 180 + static_cast<int>(twinkle * 75.0f), 100, alpha);
+            WriteDisc(vtx, idx, base, uv, m_posX[i], m_posY[i], m_size[i], starColor);
+            ++written;
+
+            // Halo autour des grosses étoiles
+            if (m_size[i] > 2.5f)
+            {
+                WriteDisc(vtx, idx, base, uv, m_posX[i], m_posY[i], m_size[i] * 2.0f,
+                          IM_COL32(255, 200, 150, alpha / 4));
+                ++written;
+            }
+        }
+
+        drawList->_VtxWritePtr = vtx;
+        drawList->_IdxWritePtr = idx;
+        drawList->_VtxCurrentIdx = base;
+        drawList->PrimUnreserve((reserved - written) * DISC_INDICES, (reserved - written) * DISC_VERTICES);
+    }
+}
+
+/**
+ * @brief Ajuste le nombre de particules affichées
+ *
+ * Réduction rapide (-15 %) dès que le budget ou la frame déborde, remontée
+ * progressive (+10 %) après un délai, tant que le coût reste sous la
+ * moitié du budget.
+ */
+void ParticleField::Adapt(double costMs, float frameDelta)
+{
+    const size_t minimum = std::min(MIN_ACTIVE_PARTICLES, m_target);
+    const bool pressure = costMs > m_budgetMs || frameDelta > FRAME_PRESSURE_SECONDS;
+
+    if (pressure && m_active > minimum)
+    {
+        m_active = std::max(minimum, m_active - m_active * 15 / 100);
+        m_growCooldown = GROW_COOLDOWN_FRAMES;
+    }
+    else if (m_growCooldown > 0)
+    {
+        --m_growCooldown;
+    }
+    else if (m_active < m_target && costMs < m_budgetMs * 0.5)
+    {
+        m_active = std::min(m_target, m_active + std::max<size_t>(m_active / 10, MIN_ACTIVE_PARTICLES));
+    }
+}
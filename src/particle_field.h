@@ -0,0 +1,113 @@
+/**
+ * @file particle_field.h
+ * @brief Champ d'étoiles du fond animé
+ *
+ * Les particules sont stockées en structure-de-tableaux (une colonne par
+ * attribut) et animées quatre par quatre avec SSE2 quand il est disponible.
+ * La géométrie est écrite directement dans la draw list, par lots réservés
+ * d'un coup, au lieu d'un AddCircleFilled par étoile.
+ *
+ * Le nombre de particules se règle à l'exécution ; si le champ dépasse son
+ * budget de temps par frame (ou si la frame entière est trop lente), il
+ * réduit lui-même le nombre de particules affichées, puis remonte vers la
+ * cible quand la marge revient.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef PARTICLE_FIELD_H
+#define PARTICLE_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ImDrawList;
+
+/**
+ * @class ParticleField
+ * @brief Étoiles scintillantes animées, en SoA
+ */
+class ParticleField
+{
+public:
+    /**
+     * @brief Constructeur
+     * @param seed Graine du générateur (même graine = mêmes étoiles)
+     * @param count Nombre de particules souhaité
+     */
+    ParticleField(uint32_t seed, size_t count);
+
+    /**
+     * @brief Change le nombre de particules souhaité
+     */
+    void SetTargetCount(size_t count);
+
+    /**
+     * @brief Change le budget de temps par frame (ms)
+     */
+    void SetBudget(double budgetMs) { m_budgetMs = budgetMs; }
+
+    /**
+     * @brief Anime et dessine les particules
+     * @param drawList Draw list de destination
+     * @param x,y Coin haut-gauche de la zone
+     * @param width,height Taille de la zone
+     * @param time Temps d'animation (s)
+     * @param frameDelta Durée de la frame précédente (s), pour détecter la surcharge
+     */
+    void Render(ImDrawList* drawList, float x, float y, float width, float height,
+                float time, float frameDelta);
+
+    size_t GetTargetCount() const { return m_target; }
+    size_t GetActiveCount() const { return m_active; }
+    double GetLastCostMs() const { return m_lastCostMs; }
+
+private:
+    // Attributs (une colonne par champ, complétées à un multiple de 4)
+    std::vector<float> m_baseX;     // Position de base, normalisée (0-1)
+    std::vector<float> m_baseY;
+    std::vector<float> m_speed;     // Vitesse d'oscillation
+    std::vector<float> m_size;      // Rayon (px)
+    std::vector<float> m_alpha;     // Opacité maximale
+    std::vector<float> m_phase;     // Déphasage (index de la particule)
+
+    // Résultats de la frame (mêmes index)
+    std::vector<float> m_posX;
+    std::vector<float> m_posY;
+    std::vector<float> m_twinkle;   // Scintillement (0-1)
+
+    uint32_t m_rngState;            // xorshift32, propre à l'instance
+    size_t m_target;                // Nombre souhaité
+    size_t m_active;                // Nombre affiché (≤ m_target)
+    double m_budgetMs;
+    double m_lastCostMs;
+    int m_growCooldown;             // Frames avant de pouvoir remonter
+
+    /**
+     * @brief Nombre pseudo-aléatoire dans [0, 1)
+     */
+    float NextRandom();
+
+    /**
+     * @brief Génère les attributs jusqu'à count particules
+     */
+    void Generate(size_t count);
+
+    /**
+     * @brief Calcule positions et scintillement des m_active premières particules
+     */
+    void Animate(float x, float y, float width, float height, float time);
+
+    /**
+     * @brief Écrit les disques des particules dans la draw list
+     */
+    void Emit(ImDrawList* drawList) const;
+
+    /**
+     * @brief Ajuste m_active selon le coût mesuré et la durée de frame
+     */
+    void Adapt(double costMs, float frameDelta);
+};
+
+#endif // PARTICLE_FIELD_H
@@ -0,0 +1,493 @@
+/**
+ * @file png_decoder.cpp
+ * @brief Implémentation du décodage PNG
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "png_decoder.h"
+#include "inflate.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PNG_DECODER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Limite de taille des images acceptées (pixels)
+static const size_t MAX_PNG_PIXELS = 8192 * 8192;
+
+static const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+/**
+ * @struct Adam7Pass
+ * @brief Une passe de l'entrelacement Adam7
+ */
+struct Adam7Pass
+{
+    int x;
+    int y;
+    int stepX;
+    int stepY;
+};
+
+static const Adam7Pass ADAM7_PASSES[7] = {
+    { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 },
+    { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 }
+};
+
+/**
+ * @struct PngInfo
+ * @brief En-tête (IHDR) et tables de couleurs du fichier
+ */
+struct PngInfo
+{
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+    int colorType = 0;
+    bool interlaced = false;
+    int channels = 0;
+    uint32_t palette[256] = {};     // RGBA empaqueté (alpha issu de tRNS)
+    bool hasColorKey = false;       // tRNS des images sans palette
+    uint16_t colorKey[3] = {};
+};
+
+static uint32_t ReadU32(const uint8_t* data)
+{
+    return (static_cast<uint32_t>(data[0]) << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+/**
+ * @brief Vérifie la signature PNG
+ */
+bool IsPng(const uint8_t* data, size_t size)
+{
+    return data && size >= 8 && memcmp(data, PNG_SIGNATURE, 8) == 0;
+}
+
+/**
+ * @brief Octets d'une ligne de pixels (sans l'octet de filtre)
+ */
+static size_t RowBytes(const PngInfo& info, int width)
+{
+    return (static_cast<size_t>(width) * info.channels * info.depth + 7) / 8;
+}
+
+#if defined(PNG_DECODER_SSE2)
+
+static __m128i LoadPixel(const uint8_t* p, int bpp)
+{
+    uint32_t value = 0;
+    memcpy(&value, p, bpp);
+    return _mm_cvtsi32_si128(static_cast<int>(value));
+}
+
+static void StorePixel(uint8_t* p, __m128i pixel, int bpp)
+{
+    uint32_t value = static_cast<uint32_t>(_mm_cvtsi128_si32(pixel));
+    memcpy(p, &value, bpp);
+}
+
+/**
+ * @brief Filtres Sub, Average et Paeth pour des pixels de 3 ou 4 octets
+ *
+ * Chaque pixel dépend du précédent : le parallélisme est entre les
+ * canaux d'un même pixel, traités en une instruction.
+ */
+static void UnfilterPixelsSse2(int filter, uint8_t* row, const uint8_t* prior, size_t length, int bpp)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = zero;
+
+    if (filter == 1)
+    {
+        for (size_t i = 0; i + bpp <= length; i += bpp)
+        {
+            a = _mm_add_epi8(LoadPixel(row + i, bpp), a);
+            StorePixel(row + i, a, bpp);
+        }
+    }
+    else if (filter == 3)
+    {
+        // Moyenne arrondie vers le bas : pavgb arrondit vers le haut
+        const __m128i one = _mm_set1_epi8(1);
+        for (size_t i = 0; i + bpp <= length; i += bpp)
+        {
+            __m128i b = LoadPixel(prior + i, bpp);
+            __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+            a = _mm_add_epi8(LoadPixel(row + i, bpp), average);
+            StorePixel(row + i, a, bpp);
+        }
+    }
+    else
+    {
+        // Paeth en 16 bits : pa = |b - c|, pb = |a - c|, pc = |a + b - 2c|
+        const __m128i byteMask = _mm_set1_epi16(0xFF);
+        __m128i c = zero;
+        for (size_t i = 0; i + bpp <= length; i += bpp)
+        {
+            __m128i b = _mm_unpacklo_epi8(LoadPixel(prior + i, bpp), zero);
+            __m128i x = _mm_unpacklo_epi8(LoadPixel(row + i, bpp), zero);
+            __m128i bc = _mm_sub_epi16(b, c);
+            __m128i ac = _mm_sub_epi16(a, c);
+            __m128i abc = _mm_add_epi16(bc, ac);
+            __m128i pa = _mm_max_epi16(bc, _mm_sub_epi16(zero, bc));
+            __m128i pb = _mm_max_epi16(ac, _mm_sub_epi16(zero, ac));
+            __m128i pc = _mm_max_epi16(abc, _mm_sub_epi16(zero, abc));
+            __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+            __m128i useB = _mm_cmpeq_epi16(smallest, pb);
+            __m128i nearest = _mm_or_si128(_mm_and_si128(useB, b), _mm_andnot_si128(useB, c));
+            __m128i useA = _mm_cmpeq_epi16(smallest, pa);
+            nearest = _mm_or_si128(_mm_and_si128(useA, a), _mm_andnot_si128(useA, nearest));
+
+            a = _mm_and_si128(_mm_add_epi16(x, nearest), byteMask);
+            StorePixel(row + i, _mm_packus_epi16(a, a), bpp);
+            c = b;
+        }
+    }
+}
+
+#endif // PNG_DECODER_SSE2
+
+/**
+ * @brief Prédicteur de Paeth
+ */
+static uint8_t Paeth(int a, int b, int c)
+{
+    const int pa = std::abs(b - c);
+    const int pb = std::abs(a - c);
+    const int pc = std::abs(a + b - 2 * c);
+    if (pa <= pb && pa <= pc)
+        return static_cast<uint8_t>(a);
+    return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+/**
+ * @brief Défait le filtre d'une ligne, en place
+ * @param prior Ligne précédente déjà défiltrée (zéros pour la première)
+ * @param bpp Octets par pixel (1 au moins)
+ */
+static bool UnfilterRow(int filter, uint8_t* row, const uint8_t* prior, size_t length, int bpp)
+{
+    switch (filter)
+    {
+    case 0:
+        return true;
+
+    case 2:
+    {
+        size_t i = 0;
+#if defined(PNG_DECODER_SSE2)
+        for (; i + 16 <= length; i += 16)
+        {
+            __m128i sum = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(prior + i)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), sum);
+        }
+#endif
+        for (; i < length; ++i)
+        {
+            row[i] = static_cast<uint8_t>(row[i] + prior[i]);
+        }
+        return true;
+    }
+
+    case 1:
+    case 3:
+    case 4:
+#if defined(PNG_DECODER_SSE2)
+        if (bpp == 3 || bpp == 4)
+        {
+            UnfilterPixelsSse2(filter, row, prior, length, bpp);
+            return true;
+        }
+#endif
+        for (size_t i = 0; i < length; ++i)
+        {
+            const int a = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+            const int b = prior[i];
+            const int c = i >= static_cast<size_t>(bpp) ? prior[i - bpp] : 0;
+            if (filter == 1)
+                row[i] = static_cast<uint8_t>(row[i] + a);
+            else if (filter == 3)
+                row[i] = static_cast<uint8_t>(row[i] + ((a + b) >> 1));
+            else
+                row[i] = static_cast<uint8_t>(row[i] + Paeth(a, b, c));
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Échantillon x d'une ligne de profondeur inférieure à 8 bits
+ */
+static int PackedSample(const uint8_t* row, size_t index, int depth)
+{
+    const size_t bit = index * depth;
+    const int shift = 8 - depth - static_cast<int>(bit & 7);
+    return (row[bit >> 3] >> shift) & ((1 << depth) - 1);
+}
+
+/**
+ * @brief Convertit une ligne défiltrée en pixels RGBA
+ */
+static void ConvertRow(const PngInfo& info, const uint8_t* row, int width, uint8_t* out)
+{
+    const int depth = info.depth;
+
+    if (info.colorType == 3)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const int index = depth == 8 ? row[x] : PackedSample(row, x, depth);
+            memcpy(out + x * 4, &info.palette[index], 4);
+        }
+        return;
+    }
+
+    if (depth == 8 && info.colorType == 6)
+    {
+        memcpy(out, row, static_cast<size_t>(width) * 4);
+        return;
+    }
+
+    if (depth == 8 && info.colorType == 2)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const uint8_t* in = row + x * 3;
+            out[x * 4 + 0] = in[0];
+            out[x * 4 + 1] = in[1];
+            out[x * 4 + 2] = in[2];
+            out[x * 4 + 3] = info.hasColorKey && in[0] == info.colorKey[0] && in[1] == info.colorKey[1] &&
+                             in[2] == info.colorKey[2] ? 0 : 255;
+        }
+        return;
+    }
+
+    // Cas général : échantillons lus un à un, ramenés à 8 bits
+    const int channels = info.channels;
+    const int maxValue = (1 << std::min(depth, 8)) - 1;
+    for (int x = 0; x < width; ++x)
+    {
+        int samples[4];
+        bool keyMatch = info.hasColorKey;
+        for (int c = 0; c < channels; ++c)
+        {
+            const size_t index = static_cast<size_t>(x) * channels + c;
+            int value;
+            int sample8;
+            if (depth == 16)
+            {
+                value = (row[index * 2] << 8) | row[index * 2 + 1];
+                sample8 = value >> 8;
+            }
+            else if (depth == 8)
+            {
+                value = row[index];
+                sample8 = value;
+            }
+            else
+            {
+                value = PackedSample(row, index, depth);
+                sample8 = value * 255 / maxValue;
+            }
+            samples[c] = sample8;
+            if (c < 3 && (info.colorType == 0 || info.colorType == 2) && value != info.colorKey[c])
+                keyMatch = false;
+        }
+
+        uint8_t* pixel = out + x * 4;
+        if (info.colorType == 0 || info.colorType == 4)
+        {
+            pixel[0] = pixel[1] = pixel[2] = static_cast<uint8_t>(samples[0]);
+            pixel[3] = info.colorType == 4 ? static_cast<uint8_t>(samples[1]) : (keyMatch ? 0 : 255);
+        }
+        else
+        {
+            pixel[0] = static_cast<uint8_t>(samples[0]);
+            pixel[1] = static_cast<uint8_t>(samples[1]);
+            pixel[2] = static_cast<uint8_t>(samples[2]);
+            pixel[3] = info.colorType == 6 ? static_cast<uint8_t>(samples[3]) : (keyMatch ? 0 : 255);
+        }
+    }
+}
+
+/**
+ * @brief Lit IHDR, PLTE, tRNS et rassemble les IDAT
+ */
+static bool ReadChunks(const uint8_t* data, size_t size, PngInfo& info, std::vector<uint8_t>& compressed)
+{
+    bool hasHeader = false;
+    size_t pos = 8;
+    while (pos + 8 <= size)
+    {
+        const uint32_t length = ReadU32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        // Bloc tronqué : on garde ce qui est là (IDAT partiel)
+        const size_t available = std::min<size_t>(length, size - pos - 8);
+
+        if (memcmp(type, "IHDR", 4) == 0)
+        {
+            if (available < 13)
+                return false;
+            info.width = static_cast<int>(std::min<uint32_t>(ReadU32(body), 0x7FFFFFFF));
+            info.height = static_cast<int>(std::min<uint32_t>(ReadU32(body + 4), 0x7FFFFFFF));
+            info.depth = body[8];
+            info.colorType = body[9];
+            info.interlaced = body[12] == 1;
+            if (body[10] != 0 || body[11] != 0 || body[12] > 1)
+                return false;
+            hasHeader = true;
+        }
+        else if (memcmp(type, "PLTE", 4) == 0)
+        {
+            for (size_t i = 0; i < 256 && i * 3 + 2 < available; ++i)
+            {
+                const uint8_t rgba[4] = { body[i * 3], body[i * 3 + 1], body[i * 3 + 2], 255 };
+                memcpy(&info.palette[i], rgba, 4);
+            }
+        }
+        else if (memcmp(type, "tRNS", 4) == 0)
+        {
+            if (info.colorType == 3)
+            {
+                for (size_t i = 0; i < 256 && i < available; ++i)
+                {
+                    reinterpret_cast<uint8_t*>(&info.palette[i])[3] = body[i];
+                }
+            }
+            else if (info.colorType == 0 && available >= 2)
+            {
+                info.colorKey[0] = static_cast<uint16_t>((body[0] << 8) | body[1]);
+                info.hasColorKey = true;
+            }
+            else if (info.colorType == 2 && available >= 6)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    info.colorKey[c] = static_cast<uint16_t>((body[c * 2] << 8) | body[c * 2 + 1]);
+                }
+                info.hasColorKey = true;
+            }
+        }
+        else if (memcmp(type, "IDAT", 4) == 0)
+        {
+            compressed.insert(compressed.end(), body, body + available);
+        }
+        else if (memcmp(type, "IEND", 4) == 0)
+        {
+            break;
+        }
+
+        if (available < length)
+            break;
+        pos += 12 + static_cast<size_t>(length);
+    }
+    return hasHeader;
+}
+
+/**
+ * @brief Décode une image PNG
+ */
+bool DecodePng(const uint8_t* data, size_t size, std::vector<uint8_t>& rgba, int& width, int& height)
+{
+    if (!IsPng(data, size))
+        return false;
+
+    PngInfo info;
+    std::vector<uint8_t> compressed;
+    if (!ReadChunks(data, size, info, compressed))
+        return false;
+
+    switch (info.colorType)
+    {
+    case 0: info.channels = 1; break;
+    case 2: info.channels = 3; break;
+    case 3: info.channels = 1; break;
+    case 4: info.channels = 2; break;
+    case 6: info.channels = 4; break;
+    default: return false;
+    }
+    const int depth = info.depth;
+    const bool validDepth = info.colorType == 0 ? (depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16)
+                          : info.colorType == 3 ? (depth == 1 || depth == 2 || depth == 4 || depth == 8)
+                          : (depth == 8 || depth == 16);
+    if (!validDepth || info.width <= 0 || info.height <= 0 ||
+        static_cast<size_t>(info.width) * info.height > MAX_PNG_PIXELS)
+        return false;
+
+    // Passes à décoder : l'image entière, ou les sept passes Adam7
+    Adam7Pass single = { 0, 0, 1, 1 };
+    const Adam7Pass* passes = info.interlaced ? ADAM7_PASSES : &single;
+    const int passCount = info.interlaced ? 7 : 1;
+
+    size_t rawSize = 0;
+    for (int p = 0; p < passCount; ++p)
+    {
+        const int passWidth = (info.width - passes[p].x + passes[p].stepX - 1) / passes[p].stepX;
+        const int passHeight = (info.height - passes[p].y + passes[p].stepY - 1) / passes[p].stepY;
+        if (passWidth > 0 && passHeight > 0)
+            rawSize += static_cast<size_t>(passHeight) * (1 + RowBytes(info, passWidth));
+    }
+
+    std::vector<uint8_t> raw(rawSize);
+    size_t written = 0;
+    if (!ZlibInflate(compressed.data(), compressed.size(), raw.data(), raw.size(), written) || written == 0)
+        return false;
+
+    width = info.width;
+    height = info.height;
+    rgba.assign(static_cast<size_t>(width) * height * 4, 0);
+
+    const int bpp = std::max(1, info.channels * depth / 8);
+    std::vector<uint8_t> zeros(RowBytes(info, info.width));
+    std::vector<uint8_t> converted(static_cast<size_t>(info.width) * 4);
+    size_t offset = 0;
+
+    for (int p = 0; p < passCount; ++p)
+    {
+        const Adam7Pass& pass = passes[p];
+        const int passWidth = (info.width - pass.x + pass.stepX - 1) / pass.stepX;
+        const int passHeight = (info.height - pass.y + pass.stepY - 1) / pass.stepY;
+        if (passWidth <= 0 || passHeight <= 0)
+            continue;
+
+        const size_t rowBytes = RowBytes(info, passWidth);
+        const uint8_t* prior = zeros.data();
+        for (int y = 0; y < passHeight; ++y)
+        {
+            // Lignes absentes d'un fichier tronqué : on s'arrête là
+            if (offset + 1 + rowBytes > written)
+                return true;
+
+            uint8_t* row = raw.data() + offset + 1;
+            if (!UnfilterRow(raw[offset], row, prior, rowBytes, bpp))
+                return false;
+            prior = row;
+            offset += 1 + rowBytes;
+
+            const int outY = pass.y + y * pass.stepY;
+            if (pass.stepX == 1)
+            {
+                ConvertRow(info, row, passWidth, rgba.data() + static_cast<size_t>(outY) * width * 4);
+                continue;
+            }
+            ConvertRow(info, row, passWidth, converted.data());
+            for (int x = 0; x < passWidth; ++x)
+            {
+                memcpy(rgba.data() + (static_cast<size_t>(outY) * width + pass.x + x * pass.stepX) * 4,
+                       converted.data() + x * 4, 4);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file png_decoder.h
+ * @brief Décodage des images PNG en pixels RGBA
+ *
+ * Tous les types de couleur et profondeurs de la norme (palette, niveaux
+ * de gris, RGB, avec ou sans alpha, 1 à 16 bits), entrelacement Adam7 et
+ * transparence tRNS. Les filtres de lignes (Sub, Up, Average, Paeth) sont
+ * défaits en SSE2 pour les pixels de 3 et 4 octets, les plus courants.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef PNG_DECODER_H
+#define PNG_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Vérifie la signature PNG
+ */
+bool IsPng(const uint8_t* data, size_t size);
+
+/**
+ * @brief Décode une image PNG
+ * @param data Contenu du fichier
+ * @param size Taille des données
+ * @param rgba Pixels RGBA, ligne par ligne (sortie)
+ * @param width Largeur (sortie)
+ * @param height Hauteur (sortie)
+ * @return false si le fichier n'est pas un PNG lisible
+ *
+ * Un fichier tronqué garde les lignes déjà décodées (le reste est
+ * transparent). Les sommes de contrôle ne sont pas vérifiées.
+ */
+bool DecodePng(const uint8_t* data, size_t size, std::vector<uint8_t>& rgba, int& width, int& height);
+
+#endif // PNG_DECODER_H
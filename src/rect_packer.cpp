@@ -0,0 +1,314 @@
+/**
+ * @file rect_packer.cpp
+ * @brief Implémentation du rangement de rectangles
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "rect_packer.h"
+#include <algorithm>
+
+/**
+ * @brief Constructeur
+ */
+RectPacker::RectPacker(int width, int height)
+    : m_width(width)
+    , m_height(height)
+    , m_usedArea(0)
+{
+    Reset();
+}
+
+/**
+ * @brief Vide la page
+ */
+void RectPacker::Reset()
+{
+    m_skyline.clear();
+    m_skyline.push_back({ 0, 0, m_width });
+    m_freeRects.clear();
+    m_usedArea = 0;
+}
+
+/**
+ * @brief Hauteur où poser un rectangle à partir du segment index
+ *
+ * Le rectangle repose sur le plus haut des segments qu'il recouvre.
+ */
+int RectPacker::Fit(size_t index, int width, int height) const
+{
+    if (m_skyline[index].x + width > m_width)
+        return -1;
+
+    int y = 0;
+    int remaining = width;
+    for (size_t i = index; remaining > 0; ++i)
+    {
+        if (i >= m_skyline.size())
+            return -1;
+
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height)
+            return -1;
+        remaining -= m_skyline[i].width;
+    }
+    return y;
+}
+
+/**
+ * @brief Cherche une place pour un rectangle
+ *
+ * Parmi toutes les positions possibles, garde celle dont le bas du
+ * rectangle est le plus haut dans la page (le plus petit y + hauteur),
+ * puis, à égalité, celle du segment le plus étroit.
+ */
+bool RectPacker::Insert(int width, int height, int& x, int& y)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    // Place rendue d'abord : la ligne d'horizon ne monte que si aucune ne convient
+    if (InsertFree(width, height, x, y))
+        return true;
+
+    size_t bestIndex = m_skyline.size();
+    int bestBottom = m_height + 1;
+    int bestWidth = m_width + 1;
+    int bestY = 0;
+
+    for (size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        int fitY = Fit(i, width, height);
+        if (fitY < 0)
+            continue;
+
+        int bottom = fitY + height;
+        if (bottom < bestBottom || (bottom == bestBottom && m_skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestBottom = bottom;
+            bestWidth = m_skyline[i].width;
+            bestY = fitY;
+        }
+    }
+
+    if (bestIndex == m_skyline.size())
+        return false;
+
+    x = m_skyline[bestIndex].x;
+    y = bestY;
+
+    // Le rectangle repose sur le plus haut des segments qu'il couvre : le
+    // vide laissé au-dessus des plus bas devient un emplacement libre
+    for (size_t i = bestIndex; i < m_skyline.size() && m_skyline[i].x < x + width; ++i)
+    {
+        const Segment& segment = m_skyline[i];
+        if (segment.y < bestY)
+        {
+            const int right = std::min(segment.x + segment.width, x + width);
+            m_freeRects.push_back({ segment.x, segment.y, right - segment.x, bestY - segment.y });
+        }
+    }
+
+    // Nouveau segment au-dessus du rectangle
+    m_skyline.insert(m_skyline.begin() + bestIndex, { x, bestY + height, width });
+
+    // Raccourcit (ou supprime) les segments qu'il recouvre
+    for (size_t i = bestIndex + 1; i < m_skyline.size();)
+    {
+        const Segment& previous = m_skyline[i - 1];
+        int overlap = previous.x + previous.width - m_skyline[i].x;
+        if (overlap <= 0)
+            break;
+
+        m_skyline[i].x += overlap;
+        m_skyline[i].width -= overlap;
+        if (m_skyline[i].width > 0)
+            break;
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    MergeSkyline();
+
+    m_usedArea += static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    return true;
+}
+
+/**
+ * @brief Pose un rectangle dans le plus petit emplacement libre qui le contient
+ *
+ * Le reste de l'emplacement est coupé en deux (guillotine) le long de son
+ * axe le plus court, pour garder une grande chute d'un seul tenant.
+ */
+bool RectPacker::InsertFree(int width, int height, int& x, int& y)
+{
+    size_t best = m_freeRects.size();
+    uint64_t bestArea = UINT64_MAX;
+    for (size_t i = 0; i < m_freeRects.size(); ++i)
+    {
+        const Rect& free = m_freeRects[i];
+        if (free.width < width || free.height < height)
+            continue;
+
+        uint64_t area = static_cast<uint64_t>(free.width) * static_cast<uint64_t>(free.height);
+        if (area < bestArea)
+        {
+            best = i;
+            bestArea = area;
+        }
+    }
+    if (best == m_freeRects.size())
+        return false;
+
+    const Rect free = m_freeRects[best];
+    m_freeRects.erase(m_freeRects.begin() + best);
+    x = free.x;
+    y = free.y;
+
+    const int right = free.width - width;
+    const int bottom = free.height - height;
+    Rect rightPart = { free.x + width, free.y, right, height };
+    Rect bottomPart = { free.x, free.y + height, free.width, bottom };
+    if (right >= bottom)
+    {
+        rightPart.height = free.height;
+        bottomPart.width = width;
+    }
+    if (rightPart.width > 0 && rightPart.height > 0)
+        m_freeRects.push_back(rightPart);
+    if (bottomPart.width > 0 && bottomPart.height > 0)
+        m_freeRects.push_back(bottomPart);
+
+    m_usedArea += static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    return true;
+}
+
+/**
+ * @brief Rend la place d'un rectangle posé par Insert
+ *
+ * La place est d'abord fusionnée avec les emplacements libres qui la
+ * prolongent sur tout un côté. Si elle touche alors la ligne d'horizon,
+ * celle-ci redescend, ce qui peut à son tour libérer d'autres emplacements.
+ */
+void RectPacker::Remove(int x, int y, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    const uint64_t area = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    m_usedArea = m_usedArea > area ? m_usedArea - area : 0;
+
+    Rect rect = { x, y, width, height };
+    for (size_t i = 0; i < m_freeRects.size();)
+    {
+        const Rect& free = m_freeRects[i];
+        const bool column = free.x == rect.x && free.width == rect.width &&
+                            (free.y + free.height == rect.y || rect.y + rect.height == free.y);
+        const bool row = free.y == rect.y && free.height == rect.height &&
+                         (free.x + free.width == rect.x || rect.x + rect.width == free.x);
+        if (!column && !row)
+        {
+            ++i;
+            continue;
+        }
+
+        if (column)
+        {
+            rect.y = std::min(rect.y, free.y);
+            rect.height += free.height;
+        }
+        else
+        {
+            rect.x = std::min(rect.x, free.x);
+            rect.width += free.width;
+        }
+        m_freeRects.erase(m_freeRects.begin() + i);
+        i = 0;
+    }
+
+    if (!LowerSkyline(rect))
+    {
+        m_freeRects.push_back(rect);
+        return;
+    }
+
+    for (size_t i = 0; i < m_freeRects.size();)
+    {
+        if (LowerSkyline(m_freeRects[i]))
+        {
+            m_freeRects.erase(m_freeRects.begin() + i);
+            i = 0;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+/**
+ * @brief Redescend la ligne d'horizon sous un rectangle qui la touche
+ *
+ * Rien n'est posé au-dessus d'un segment : si tous ceux que le rectangle
+ * couvre sont exactement à son sommet, sa colonne redevient libre jusqu'à
+ * son bas.
+ */
+bool RectPacker::LowerSkyline(const Rect& rect)
+{
+    const int top = rect.y + rect.height;
+    const int right = rect.x + rect.width;
+    for (const Segment& segment : m_skyline)
+    {
+        if (segment.x + segment.width <= rect.x || segment.x >= right)
+            continue;
+        if (segment.y != top)
+            return false;
+    }
+
+    SplitSkyline(rect.x);
+    SplitSkyline(right);
+    for (Segment& segment : m_skyline)
+    {
+        if (segment.x >= rect.x && segment.x < right)
+            segment.y = rect.y;
+    }
+    MergeSkyline();
+    return true;
+}
+
+/**
+ * @brief Coupe le segment qui contient la colonne x
+ */
+void RectPacker::SplitSkyline(int x)
+{
+    for (size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        Segment& segment = m_skyline[i];
+        if (x > segment.x && x < segment.x + segment.width)
+        {
+            Segment tail = { x, segment.y, segment.x + segment.width - x };
+            segment.width = x - segment.x;
+            m_skyline.insert(m_skyline.begin() + i + 1, tail);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Fusionne les segments voisins de même hauteur
+ */
+void RectPacker::MergeSkyline()
+{
+    for (size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if (m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
@@ -0,0 +1,132 @@
+/**
+ * @file rect_packer.h
+ * @brief Rangement de rectangles dans une page (algorithme "skyline")
+ *
+ * La page est décrite par sa ligne d'horizon : une suite de segments
+ * horizontaux, chacun à la hauteur du plus haut rectangle posé dessous.
+ * Un nouveau rectangle se pose là où son bas est le plus bas possible
+ * (bottom-left), ce qui remplit bien les pages de frames de même taille.
+ *
+ * Les vides laissés sous la ligne d'horizon (un rectangle posé sur le plus
+ * haut de plusieurs segments) et les rectangles rendus par Remove forment
+ * une liste d'emplacements libres, essayée avant la ligne d'horizon par les
+ * Insert suivants. Un emplacement libre qui touche la ligne d'horizon la
+ * fait redescendre : une page vidée par Remove redevient entièrement libre.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef RECT_PACKER_H
+#define RECT_PACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RectPacker
+ * @brief Place des rectangles sans recouvrement dans une page fixe
+ *
+ * Les rectangles peuvent être rendus un à un (Remove) ou tous d'un coup
+ * (Reset).
+ */
+class RectPacker
+{
+public:
+    /**
+     * @brief Constructeur
+     * @param width Largeur de la page
+     * @param height Hauteur de la page
+     */
+    RectPacker(int width, int height);
+
+    /**
+     * @brief Cherche une place pour un rectangle
+     * @param width Largeur du rectangle
+     * @param height Hauteur du rectangle
+     * @param x Position X (sortie)
+     * @param y Position Y (sortie)
+     * @return false si la page est trop pleine
+     */
+    bool Insert(int width, int height, int& x, int& y);
+
+    /**
+     * @brief Rend la place d'un rectangle posé par Insert
+     * @param x,y Position renvoyée par Insert
+     * @param width,height Taille passée à Insert
+     */
+    void Remove(int x, int y, int width, int height);
+
+    /**
+     * @brief Vide la page
+     */
+    void Reset();
+
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+
+    /**
+     * @brief Surface occupée par les rectangles posés (pixels)
+     */
+    uint64_t GetUsedArea() const { return m_usedArea; }
+
+private:
+    /**
+     * @struct Segment
+     * @brief Segment de la ligne d'horizon
+     */
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    /**
+     * @struct Rect
+     * @brief Emplacement libre sous la ligne d'horizon
+     */
+    struct Rect
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    int m_width;
+    int m_height;
+    uint64_t m_usedArea;
+    std::vector<Segment> m_skyline;     // Triée par x, couvre toute la largeur
+    std::vector<Rect> m_freeRects;      // Vides et places rendues, sans recouvrement
+
+    /**
+     * @brief Pose un rectangle dans le plus petit emplacement libre qui le contient
+     * @return false si aucun emplacement libre ne convient
+     */
+    bool InsertFree(int width, int height, int& x, int& y);
+
+    /**
+     * @brief Redescend la ligne d'horizon sous un rectangle qui la touche
+     * @return false si le rectangle n'est pas au sommet sur toute sa largeur
+     */
+    bool LowerSkyline(const Rect& rect);
+
+    /**
+     * @brief Coupe le segment qui contient la colonne x (sans effet sur un bord)
+     */
+    void SplitSkyline(int x);
+
+    /**
+     * @brief Fusionne les segments voisins de même hauteur
+     */
+    void MergeSkyline();
+
+    /**
+     * @brief Hauteur où poser un rectangle à partir du segment index
+     * @return -1 si le rectangle dépasse de la page
+     */
+    int Fit(size_t index, int width, int height) const;
+};
+
+#endif // RECT_PACKER_H
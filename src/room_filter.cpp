@@ -0,0 +1,128 @@
+/**
+ * @file room_filter.cpp
+ * @brief Implémentation de l'index de recherche des salons
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "room_filter.h"
+
+/**
+ * @brief Minuscule ASCII (les octets UTF-8 sont laissés tels quels)
+ */
+static char ToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Bit représentant un caractère dans un masque de présence
+ *
+ * Lettres et chiffres ont chacun leur bit, les autres caractères partagent
+ * le dernier : le masque ne sert qu'à écarter vite les salons impossibles.
+ */
+static uint64_t CharBit(char c)
+{
+    if (c >= 'a' && c <= 'z')
+        return 1ull << (c - 'a');
+    if (c >= '0' && c <= '9')
+        return 1ull << (26 + c - '0');
+    return 1ull << 63;
+}
+
+/**
+ * @brief Indexe (ou ré-indexe) un salon
+ */
+void RoomFilter::UpdateRoom(uint32_t index, std::string_view name, std::string_view alias)
+{
+    if (index >= m_entries.size())
+        m_entries.resize(index + 1);
+
+    Entry& entry = m_entries[index];
+    entry.text.clear();
+    entry.text.reserve(name.size() + alias.size() + 1);
+    entry.mask = 0;
+
+    for (char c : name)
+        entry.text.push_back(ToLower(c));
+    entry.text.push_back('\n');
+    for (char c : alias)
+        entry.text.push_back(ToLower(c));
+
+    for (char c : entry.text)
+    {
+        if (c != '\n')
+            entry.mask |= CharBit(c);
+    }
+
+    entry.match = Test(entry);
+}
+
+/**
+ * @brief Change la requête
+ *
+ * Si la nouvelle requête prolonge l'ancienne, un salon qui ne correspondait
+ * pas ne peut pas correspondre maintenant : seuls les salons retenus sont
+ * re-testés.
+ */
+bool RoomFilter::SetQuery(std::string_view query)
+{
+    std::string lowered;
+    lowered.reserve(query.size());
+    for (char c : query)
+        lowered.push_back(ToLower(c));
+
+    if (lowered == m_query)
+        return false;
+
+    const bool narrowing = lowered.compare(0, m_query.size(), m_query) == 0;
+    m_query = std::move(lowered);
+    m_queryMask = 0;
+    for (char c : m_query)
+        m_queryMask |= CharBit(c);
+
+    for (Entry& entry : m_entries)
+    {
+        if (narrowing && !entry.match)
+            continue;
+        entry.match = Test(entry);
+    }
+    return true;
+}
+
+/**
+ * @brief Teste une entrée contre la requête courante
+ *
+ * Correspondance en sous-séquence, séparément dans le nom et dans l'alias.
+ */
+bool RoomFilter::Test(const Entry& entry) const
+{
+    if (m_query.empty())
+        return true;
+    if ((entry.mask & m_queryMask) != m_queryMask)
+        return false;
+
+    size_t q = 0;
+    for (char c : entry.text)
+    {
+        if (c == '\n')
+        {
+            // Début de l'alias : la requête doit correspondre à un seul des deux textes
+            q = 0;
+            continue;
+        }
+        if (c == m_query[q] && ++q == m_query.size())
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Vide l'index et la requête
+ */
+void RoomFilter::Clear()
+{
+    m_entries.clear();
+    m_query.clear();
+    m_queryMask = 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file room_filter.h
+ * @brief Index de recherche approximative sur les noms et alias des salons
+ *
+ * Une requête correspond à un salon si ses caractères apparaissent dans
+ * l'ordre (pas forcément consécutifs) dans le nom ou l'alias, sans tenir
+ * compte de la casse : "gnrl" trouve "#general:serveur".
+ *
+ * L'index est incrémental : quand la requête s'allonge (frappe au clavier),
+ * seuls les salons qui correspondaient déjà sont re-testés, et un salon
+ * renommé est ré-indexé seul.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef ROOM_FILTER_H
+#define ROOM_FILTER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class RoomFilter
+ * @brief Filtre approximatif des salons, indexé par index de salon
+ */
+class RoomFilter
+{
+public:
+    /**
+     * @brief Indexe (ou ré-indexe) un salon
+     * @param index Index du salon dans MatrixClient::GetRooms()
+     * @param name Nom du salon
+     * @param alias Alias canonique du salon (peut être vide)
+     */
+    void UpdateRoom(uint32_t index, std::string_view name, std::string_view alias);
+
+    /**
+     * @brief Change la requête
+     * @return true si l'ensemble des salons correspondants a pu changer
+     */
+    bool SetQuery(std::string_view query);
+
+    /**
+     * @brief Indique si un salon correspond à la requête courante
+     */
+    bool Matches(uint32_t index) const
+    {
+        return index >= m_entries.size() || m_entries[index].match;
+    }
+
+    /**
+     * @brief Indique si une requête est active
+     */
+    bool IsActive() const { return !m_query.empty(); }
+
+    /**
+     * @brief Vide l'index et la requête
+     */
+    void Clear();
+
+private:
+    /**
+     * @struct Entry
+     * @brief Texte indexé d'un salon
+     */
+    struct Entry
+    {
+        std::string text;       // Nom et alias en minuscules, séparés par '\n'
+        uint64_t mask = 0;      // Caractères présents (rejet rapide)
+        bool match = true;      // Correspond à la requête courante
+    };
+
+    std::vector<Entry> m_entries;
+    std::string m_query;        // Requête courante, en minuscules
+    uint64_t m_queryMask = 0;
+
+    /**
+     * @brief Teste une entrée contre la requête courante
+     */
+    bool Test(const Entry& entry) const;
+};
+
+#endif // ROOM_FILTER_H
@@ -0,0 +1,64 @@
+/**
+ * @file room_list.cpp
+ * @brief Implémentation de l'ordre d'affichage des salons
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "room_list.h"
+
+/**
+ * @brief Ordre d'affichage : favoris, non lus, puis plus récents d'abord
+ */
+bool RoomList::Key::operator<(const Key& other) const
+{
+    if (favourite != other.favourite)
+        return favourite;
+    if (unread != other.unread)
+        return unread;
+    if (lastActivity != other.lastActivity)
+        return lastActivity > other.lastActivity;
+    return index < other.index;
+}
+
+bool RoomList::Key::operator==(const Key& other) const
+{
+    return favourite == other.favourite && unread == other.unread &&
+           lastActivity == other.lastActivity && index == other.index;
+}
+
+/**
+ * @brief Ajoute un salon ou met à jour sa position
+ *
+ * Seule l'entrée du salon est retirée puis réinsérée : O(log n).
+ */
+bool RoomList::Update(const Key& key)
+{
+    if (key.index >= m_keys.size())
+    {
+        m_keys.resize(key.index + 1);
+        m_present.resize(key.index + 1, false);
+    }
+
+    if (m_present[key.index])
+    {
+        if (m_keys[key.index] == key)
+            return false;
+        m_order.erase(m_keys[key.index]);
+    }
+
+    m_order.insert(key);
+    m_keys[key.index] = key;
+    m_present[key.index] = true;
+    return true;
+}
+
+/**
+ * @brief Vide la liste
+ */
+void RoomList::Clear()
+{
+    m_order.clear();
+    m_keys.clear();
+    m_present.clear();
+}
@@ -0,0 +1,86 @@
+/**
+ * @file room_list.h
+ * @brief Ordre d'affichage des salons, maintenu de façon incrémentale
+ *
+ * Les salons sont triés par favoris, puis non lus, puis activité la plus
+ * récente. Chaque changement d'un salon ne déplace que son entrée dans un
+ * arbre équilibré (O(log n)) : la liste n'est jamais retriée en entier.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef ROOM_LIST_H
+#define ROOM_LIST_H
+
+#include <cstdint>
+#include <cstddef>
+#include <set>
+#include <vector>
+
+/**
+ * @class RoomList
+ * @brief Ensemble ordonné d'index de salons
+ *
+ * Les salons sont désignés par leur index dans le stockage de MatrixClient ;
+ * le parcours (for (uint32_t index : list)) les rend dans l'ordre d'affichage.
+ */
+class RoomList
+{
+public:
+    /**
+     * @struct Key
+     * @brief Critères de tri d'un salon
+     */
+    struct Key
+    {
+        bool favourite = false;     // Tag m.favourite
+        bool unread = false;        // Notifications ou mentions non lues
+        long long lastActivity = 0; // Horodatage du dernier message (ms)
+        uint32_t index = 0;         // Index du salon (départage stable)
+
+        bool operator<(const Key& other) const;
+        bool operator==(const Key& other) const;
+    };
+
+    /**
+     * @class Iterator
+     * @brief Parcourt les index de salons dans l'ordre d'affichage
+     */
+    class Iterator
+    {
+    public:
+        explicit Iterator(std::set<Key>::const_iterator it) : m_it(it) {}
+        uint32_t operator*() const { return m_it->index; }
+        Iterator& operator++() { ++m_it; return *this; }
+        bool operator!=(const Iterator& other) const { return m_it != other.m_it; }
+
+    private:
+        std::set<Key>::const_iterator m_it;
+    };
+
+    /**
+     * @brief Ajoute un salon ou met à jour sa position
+     * @return true si la position du salon a changé
+     */
+    bool Update(const Key& key);
+
+    /**
+     * @brief Vide la liste
+     */
+    void Clear();
+
+    /**
+     * @brief Nombre de salons
+     */
+    size_t Size() const { return m_order.size(); }
+
+    Iterator begin() const { return Iterator(m_order.begin()); }
+    Iterator end() const { return Iterator(m_order.end()); }
+
+private:
+    std::set<Key> m_order;      // Salons dans l'ordre d'affichage
+    std::vector<Key> m_keys;    // Clé courante de chaque salon (par index)
+    std::vector<bool> m_present; // Salon déjà présent dans m_order
+};
+
+#endif // ROOM_LIST_H
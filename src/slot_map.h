@@ -0,0 +1,152 @@
+/**
+ * @file slot_map.h
+ * @brief Tableau d'emplacements réutilisables adressés par handles générationnels
+ *
+ * Un handle est un index d'emplacement accompagné d'une génération. Libérer
+ * un emplacement incrémente sa génération : un ancien handle devient
+ * invalide au lieu de désigner le nouvel occupant. L'accès est un simple
+ * index dans un tableau, sans hachage ni comparaison de chaînes.
+ *
+ * Pas de synchronisation : la table appartient à un seul thread.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct SlotHandle
+ * @brief Référence vers un emplacement d'une SlotMap
+ *
+ * La génération 0 n'est jamais attribuée : un handle par défaut est invalide.
+ */
+struct SlotHandle
+{
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return generation != 0; }
+    bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * @class SlotMap
+ * @brief Éléments rangés dans des emplacements réutilisés, en O(1)
+ */
+template <typename T>
+class SlotMap
+{
+public:
+    /**
+     * @brief Range un élément dans un emplacement libre
+     *
+     * Peut déplacer les éléments : les pointeurs renvoyés par Get ne
+     * survivent pas à un Insert.
+     */
+    SlotHandle Insert(T value)
+    {
+        uint32_t index;
+        if (!m_freeList.empty())
+        {
+            index = m_freeList.back();
+            m_freeList.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        Slot& slot = m_slots[index];
+        slot.value = std::move(value);
+        slot.occupied = true;
+        ++m_size;
+        return { index, slot.generation };
+    }
+
+    /**
+     * @brief Élément désigné par le handle
+     * @return nullptr si le handle est invalide ou périmé
+     */
+    T* Get(SlotHandle handle)
+    {
+        if (handle.index >= m_slots.size())
+            return nullptr;
+        Slot& slot = m_slots[handle.index];
+        return slot.occupied && slot.generation == handle.generation ? &slot.value : nullptr;
+    }
+
+    const T* Get(SlotHandle handle) const
+    {
+        return const_cast<SlotMap*>(this)->Get(handle);
+    }
+
+    /**
+     * @brief Libère l'emplacement (l'élément est détruit)
+     * @return false si le handle est invalide ou périmé
+     */
+    bool Remove(SlotHandle handle)
+    {
+        if (!Get(handle))
+            return false;
+
+        Slot& slot = m_slots[handle.index];
+        slot.value = T();
+        slot.occupied = false;
+        if (++slot.generation == 0)
+            slot.generation = 1;
+        m_freeList.push_back(handle.index);
+        --m_size;
+        return true;
+    }
+
+    /**
+     * @brief Appelle function(handle, élément) pour chaque emplacement occupé
+     */
+    template <typename Function>
+    void ForEach(Function&& function)
+    {
+        for (uint32_t i = 0; i < m_slots.size(); ++i)
+        {
+            if (m_slots[i].occupied)
+                function(SlotHandle{ i, m_slots[i].generation }, m_slots[i].value);
+        }
+    }
+
+    template <typename Function>
+    void ForEach(Function&& function) const
+    {
+        for (uint32_t i = 0; i < m_slots.size(); ++i)
+        {
+            if (m_slots[i].occupied)
+                function(SlotHandle{ i, m_slots[i].generation }, static_cast<const T&>(m_slots[i].value));
+        }
+    }
+
+    size_t Size() const { return m_size; }
+
+private:
+    /**
+     * @struct Slot
+     * @brief Un emplacement et sa génération courante
+     */
+    struct Slot
+    {
+        T value;
+        uint32_t generation = 1;
+        bool occupied = false;
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeList;   // Emplacements libérés, réutilisés en premier
+    size_t m_size = 0;
+};
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,100 @@
+/**
+ * @file spsc_queue.h
+ * @brief File circulaire lock-free mono-producteur / mono-consommateur
+ *
+ * Utilisée pour transmettre les mises à jour du thread de synchronisation
+ * vers le thread de rendu sans prendre de mutex à chaque frame.
+ * Un seul thread peut appeler TryPush, un seul autre thread TryPop.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscQueue
+ * @brief File bornée sans verrou pour un producteur et un consommateur
+ *
+ * Les indices de lecture et d'écriture sont sur des lignes de cache
+ * séparées pour éviter le faux partage entre les deux threads.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    /**
+     * @brief Constructeur
+     * @param capacity Capacité minimale (arrondie à la puissance de 2 supérieure)
+     */
+    explicit SpscQueue(size_t capacity)
+        : m_head(0)
+        , m_tail(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Ajoute un élément (thread producteur uniquement)
+     * @return false si la file est pleine (l'élément n'est pas consommé)
+     */
+    bool TryPush(T&& item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+            return false;
+
+        m_slots[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Retire un élément (thread consommateur uniquement)
+     * @return false si la file est vide
+     */
+    bool TryPop(T& item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        item = std::move(m_slots[head & m_mask]);
+        m_slots[head & m_mask] = T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Indique si la file est vide (approximatif vu de l'autre thread)
+     */
+    bool IsEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Nombre d'emplacements de la file
+     */
+    size_t Capacity() const { return m_mask + 1; }
+
+private:
+    std::vector<T> m_slots;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_head;   // Prochain élément à lire (consommateur)
+    alignas(64) std::atomic<size_t> m_tail;   // Prochain emplacement libre (producteur)
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,249 @@
+/**
+ * @file texture_atlas.cpp
+ * @brief Implémentation de l'atlas de textures
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "texture_atlas.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Crée une texture en mémoire (transparente)
+ */
+TextureHandle CpuTextureBackend::CreateTexture(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return nullptr;
+
+    Texture* texture = new Texture();
+    texture->width = width;
+    texture->height = height;
+    texture->pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+    ++m_liveTextures;
+    return texture;
+}
+
+/**
+ * @brief Copie une zone de pixels dans la texture
+ */
+void CpuTextureBackend::UpdateTexture(TextureHandle handle, int x, int y, int width, int height,
+                                      const unsigned char* rgba)
+{
+    Texture* texture = static_cast<Texture*>(handle);
+    if (!texture || x < 0 || y < 0 || x + width > texture->width || y + height > texture->height)
+        return;
+
+    for (int row = 0; row < height; ++row)
+    {
+        memcpy(&texture->pixels[(static_cast<size_t>(y + row) * texture->width + x) * 4],
+               rgba + static_cast<size_t>(row) * width * 4,
+               static_cast<size_t>(width) * 4);
+    }
+}
+
+/**
+ * @brief Libère une texture
+ */
+void CpuTextureBackend::DestroyTexture(TextureHandle handle)
+{
+    if (!handle)
+        return;
+
+    delete static_cast<Texture*>(handle);
+    --m_liveTextures;
+}
+
+/**
+ * @brief Constructeur
+ */
+TextureAtlas::TextureAtlas(TextureBackend* backend, int pageSize)
+    : m_backend(backend)
+    , m_pageSize(pageSize)
+{
+}
+
+/**
+ * @brief Destructeur - libère toutes les pages
+ */
+TextureAtlas::~TextureAtlas()
+{
+    for (Page& page : m_pages)
+    {
+        m_backend->DestroyTexture(page.texture);
+    }
+}
+
+/**
+ * @brief Ajoute une page de la taille donnée
+ */
+TextureAtlas::Page* TextureAtlas::AddPage(int width, int height)
+{
+    TextureHandle texture = m_backend->CreateTexture(width, height);
+    if (!texture)
+        return nullptr;
+
+    m_pages.push_back({ texture, RectPacker(width, height), 0 });
+    return &m_pages.back();
+}
+
+/**
+ * @brief Range une image et l'envoie dans sa page
+ *
+ * Première page où l'image trouve sa place, sinon une nouvelle page.
+ */
+bool TextureAtlas::Add(const unsigned char* rgba, int width, int height, TextureRegion& region)
+{
+    if (!rgba || width <= 0 || height <= 0)
+        return false;
+
+    const int paddedWidth = width + 2 * PADDING;
+    const int paddedHeight = height + 2 * PADDING;
+
+    // Trop grande pour une page : texture dédiée, sans bordure
+    if (paddedWidth > m_pageSize || paddedHeight > m_pageSize)
+    {
+        Page* page = AddPage(width, height);
+        if (!page)
+            return false;
+
+        int x = 0;
+        int y = 0;
+        page->packer.Insert(width, height, x, y);
+        page->regions = 1;
+        m_backend->UpdateTexture(page->texture, 0, 0, width, height, rgba);
+        region = TextureRegion();
+        region.texture = page->texture;
+        region.width = width;
+        region.height = height;
+        return true;
+    }
+
+    Page* target = nullptr;
+    int x = 0;
+    int y = 0;
+    for (Page& page : m_pages)
+    {
+        if (page.packer.Insert(paddedWidth, paddedHeight, x, y))
+        {
+            target = &page;
+            break;
+        }
+    }
+
+    if (!target)
+    {
+        target = AddPage(m_pageSize, m_pageSize);
+        if (!target || !target->packer.Insert(paddedWidth, paddedHeight, x, y))
+            return false;
+    }
+
+    UploadPadded(target->texture, x + PADDING, y + PADDING, rgba, width, height, width * 4,
+                 PADDING, PADDING, PADDING, PADDING);
+    ++target->regions;
+
+    const float pageWidth = static_cast<float>(target->packer.GetWidth());
+    const float pageHeight = static_cast<float>(target->packer.GetHeight());
+    region.texture = target->texture;
+    region.u0 = (x + PADDING) / pageWidth;
+    region.v0 = (y + PADDING) / pageHeight;
+    region.u1 = (x + PADDING + width) / pageWidth;
+    region.v1 = (y + PADDING + height) / pageHeight;
+    region.x = x + PADDING;
+    region.y = y + PADDING;
+    region.width = width;
+    region.height = height;
+    return true;
+}
+
+/**
+ * @brief Envoie des pixels en recopiant leurs bords dans la bordure
+ *
+ * Chaque pixel de bord est recopié dans la bordure, pour que le filtrage
+ * bilinéaire ne mélange pas deux images voisines.
+ */
+void TextureAtlas::UploadPadded(TextureHandle texture, int x, int y, const unsigned char* rgba, int width, int height,
+                                int pitch, int left, int top, int right, int bottom)
+{
+    const int paddedWidth = left + width + right;
+    const int paddedHeight = top + height + bottom;
+    m_scratch.resize(static_cast<size_t>(paddedWidth) * paddedHeight * 4);
+    for (int row = 0; row < paddedHeight; ++row)
+    {
+        int sourceRow = std::min(std::max(row - top, 0), height - 1);
+        const unsigned char* source = rgba + static_cast<size_t>(sourceRow) * pitch;
+        unsigned char* destination = &m_scratch[static_cast<size_t>(row) * paddedWidth * 4];
+
+        for (int column = 0; column < left; ++column)
+        {
+            memcpy(destination + column * 4, source, 4);
+        }
+        memcpy(destination + left * 4, source, static_cast<size_t>(width) * 4);
+        for (int column = 0; column < right; ++column)
+        {
+            memcpy(destination + (left + width + column) * 4, source + (width - 1) * 4, 4);
+        }
+    }
+    m_backend->UpdateTexture(texture, x - left, y - top, paddedWidth, paddedHeight, m_scratch.data());
+}
+
+/**
+ * @brief Remplace une zone d'une image déjà rangée
+ */
+void TextureAtlas::Update(const TextureRegion& region, int x, int y, int width, int height,
+                          const unsigned char* rgba, int pitch)
+{
+    if (!region.texture || !rgba || width <= 0 || height <= 0 || x < 0 || y < 0 ||
+        x + width > region.width || y + height > region.height)
+        return;
+
+    // Même règle que Add : une image sur sa propre texture n'a pas de bordure
+    const bool padded = region.width + 2 * PADDING <= m_pageSize && region.height + 2 * PADDING <= m_pageSize;
+    const int border = padded ? PADDING : 0;
+    UploadPadded(region.texture, region.x + x, region.y + y, rgba, width, height, pitch,
+                 x == 0 ? border : 0, y == 0 ? border : 0,
+                 x + width == region.width ? border : 0, y + height == region.height ? border : 0);
+}
+
+/**
+ * @brief Rend la place d'une image
+ */
+void TextureAtlas::Remove(const TextureRegion& region)
+{
+    for (size_t i = 0; i < m_pages.size(); ++i)
+    {
+        Page& page = m_pages[i];
+        if (page.texture != region.texture)
+            continue;
+
+        if (page.regions > 0)
+            --page.regions;
+        if (page.regions == 0)
+        {
+            m_backend->DestroyTexture(page.texture);
+            m_pages.erase(m_pages.begin() + i);
+            return;
+        }
+
+        page.packer.Remove(region.x - PADDING, region.y - PADDING,
+                           region.width + 2 * PADDING, region.height + 2 * PADDING);
+        return;
+    }
+}
+
+/**
+ * @brief Occupation de l'atlas
+ */
+TextureAtlas::Stats TextureAtlas::GetStats() const
+{
+    Stats stats;
+    stats.textures = m_pages.size();
+    for (const Page& page : m_pages)
+    {
+        stats.regions += page.regions;
+        stats.usedPixels += page.packer.GetUsedArea();
+        stats.totalPixels += static_cast<uint64_t>(page.packer.GetWidth()) * page.packer.GetHeight();
+    }
+    return stats;
+}
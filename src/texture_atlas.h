@@ -0,0 +1,216 @@
+/**
+ * @file texture_atlas.h
+ * @brief Pages de textures partagées par les frames de GIFs et les images
+ *
+ * Au lieu d'une texture GPU par image, les images sont rangées dans de
+ * grandes pages (RectPacker). Un GIF animé n'y occupe qu'une zone, dont
+ * seul le rectangle modifié par chaque frame est renvoyé (Update).
+ *
+ * Le stockage des pages passe par un TextureBackend : Direct3D 11 dans
+ * l'application, mémoire CPU pour le pilote headless et les essais sous
+ * Linux.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "rect_packer.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Texture d'un backend (même représentation que ImTextureID)
+ */
+typedef void* TextureHandle;
+
+/**
+ * @struct TextureRegion
+ * @brief Zone d'une page : texture à lier et coordonnées UV
+ */
+struct TextureRegion
+{
+    TextureHandle texture = nullptr;
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+    int x = 0;              // Position dans la page (pixels, hors bordure)
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * @class TextureBackend
+ * @brief Création et mise à jour des textures des pages
+ *
+ * Toutes les méthodes sont appelées depuis le thread de rendu.
+ */
+class TextureBackend
+{
+public:
+    virtual ~TextureBackend() {}
+
+    /**
+     * @brief Crée une texture RGBA vide
+     * @return nullptr en cas d'échec
+     */
+    virtual TextureHandle CreateTexture(int width, int height) = 0;
+
+    /**
+     * @brief Remplace une zone de la texture (pixels RGBA contigus)
+     */
+    virtual void UpdateTexture(TextureHandle texture, int x, int y, int width, int height,
+                               const unsigned char* rgba) = 0;
+
+    /**
+     * @brief Libère une texture
+     */
+    virtual void DestroyTexture(TextureHandle texture) = 0;
+};
+
+/**
+ * @class CpuTextureBackend
+ * @brief Textures en mémoire vive (pilote headless, essais sous Linux)
+ */
+class CpuTextureBackend : public TextureBackend
+{
+public:
+    /**
+     * @struct Texture
+     * @brief Pixels d'une texture (le handle pointe dessus)
+     */
+    struct Texture
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;
+    };
+
+    TextureHandle CreateTexture(int width, int height) override;
+    void UpdateTexture(TextureHandle texture, int x, int y, int width, int height,
+                       const unsigned char* rgba) override;
+    void DestroyTexture(TextureHandle texture) override;
+
+    /**
+     * @brief Textures créées et pas encore libérées
+     */
+    size_t GetLiveTextures() const { return m_liveTextures; }
+
+private:
+    size_t m_liveTextures = 0;
+};
+
+/**
+ * @class TextureAtlas
+ * @brief Range des images RGBA dans des pages partagées
+ *
+ * Chaque image est entourée d'une bordure d'un pixel recopiée depuis ses
+ * bords, pour que le filtrage bilinéaire ne mélange pas deux images
+ * voisines. Une image plus grande qu'une page reçoit sa propre texture.
+ */
+class TextureAtlas
+{
+public:
+    static constexpr int PAGE_SIZE = 2048;
+    static constexpr int PADDING = 1;
+
+    /**
+     * @struct Stats
+     * @brief Occupation de l'atlas
+     */
+    struct Stats
+    {
+        size_t textures = 0;        // Objets GPU (pages)
+        size_t regions = 0;         // Images rangées
+        uint64_t usedPixels = 0;    // Pixels occupés, bordures comprises
+        uint64_t totalPixels = 0;   // Pixels de toutes les pages
+    };
+
+    /**
+     * @brief Constructeur
+     * @param backend Backend des pages (non possédé, doit survivre à l'atlas)
+     * @param pageSize Côté des pages
+     */
+    explicit TextureAtlas(TextureBackend* backend, int pageSize = PAGE_SIZE);
+
+    /**
+     * @brief Destructeur - libère toutes les pages
+     */
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    /**
+     * @brief Range une image et l'envoie dans sa page
+     * @param rgba Pixels RGBA contigus
+     * @param width Largeur
+     * @param height Hauteur
+     * @param region Texture et UV de l'image (sortie)
+     * @return false si le backend n'a pas pu créer de page
+     */
+    bool Add(const unsigned char* rgba, int width, int height, TextureRegion& region);
+
+    /**
+     * @brief Remplace une zone d'une image déjà rangée
+     * @param region Image renvoyée par Add
+     * @param x,y,width,height Zone dans l'image
+     * @param rgba Pixels de la zone
+     * @param pitch Octets entre deux lignes de rgba
+     *
+     * Seule la zone est envoyée, avec la bordure des côtés qu'elle touche.
+     */
+    void Update(const TextureRegion& region, int x, int y, int width, int height,
+                const unsigned char* rgba, int pitch);
+
+    /**
+     * @brief Rend la place d'une image
+     *
+     * La place (bordure comprise) est rendue au rangement de la page et
+     * resservira aux images suivantes ; la texture de la page est libérée
+     * quand sa dernière image part.
+     */
+    void Remove(const TextureRegion& region);
+
+    /**
+     * @brief Occupation de l'atlas
+     */
+    Stats GetStats() const;
+
+private:
+    /**
+     * @struct Page
+     * @brief Texture d'une page et son rangement
+     */
+    struct Page
+    {
+        TextureHandle texture;
+        RectPacker packer;
+        size_t regions;
+    };
+
+    TextureBackend* m_backend;
+    int m_pageSize;
+    std::vector<Page> m_pages;
+    std::vector<unsigned char> m_scratch;   // Image bordée avant envoi
+
+    /**
+     * @brief Ajoute une page de la taille donnée
+     * @return nullptr si le backend a échoué
+     */
+    Page* AddPage(int width, int height);
+
+    /**
+     * @brief Envoie des pixels en recopiant leurs bords dans la bordure
+     * @param x,y Position du premier pixel de rgba dans la page
+     * @param left,top,right,bottom Épaisseur de bordure de chaque côté
+     */
+    void UploadPadded(TextureHandle texture, int x, int y, const unsigned char* rgba, int width, int height,
+                      int pitch, int left, int top, int right, int bottom);
+};
+
+#endif // TEXTURE_ATLAS_H
@@ -7,57 +7,145 @@
  * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie 
  */
 
+#ifdef _WIN32
 #include <windows.h>
 #include <winhttp.h>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#endif
 
 #include "texture_manager.h"
+#include "frame_profiler.h"
+#include "image_resampler.h"
+#include "jpeg_decoder.h"
+#include "png_decoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <thread>
-#include <mutex>
 
-static std::mutex g_textureMutex;
+#ifdef _WIN32
+
+/**
+ * @class D3D11TextureBackend
+ * @brief Pages de l'atlas en textures Direct3D 11
+ *
+ * Le handle est la shader resource view, qui garde la texture vivante.
+ */
+class D3D11TextureBackend : public TextureBackend
+{
+public:
+    explicit D3D11TextureBackend(ID3D11Device* device)
+        : m_device(device)
+        , m_context(nullptr)
+    {
+        m_device->GetImmediateContext(&m_context);
+    }
+
+    ~D3D11TextureBackend() override
+    {
+        if (m_context)
+            m_context->Release();
+    }
+
+    TextureHandle CreateTexture(int width, int height) override;
+    void UpdateTexture(TextureHandle texture, int x, int y, int width, int height,
+                       const unsigned char* rgba) override;
+    void DestroyTexture(TextureHandle texture) override;
+
+private:
+    ID3D11Device* m_device;
+    ID3D11DeviceContext* m_context;
+};
+
+#endif // _WIN32
+
+// Threads de décodage : un cœur reste au rendu, quatre au plus
+static const unsigned MAX_DECODE_WORKERS = 4;
+
+// Téléchargements simultanés (les autres attendent leur tour)
+static const unsigned DOWNLOAD_WORKERS = 4;
 
 /**
  * @brief Constructeur
+ * 
+ * Sans device (pilote headless), les pages restent en mémoire CPU.
  */
 TextureManager::TextureManager(ID3D11Device* device)
     : m_device(device)
+    , m_published(nullptr)
+    , m_uploadedBytes(0)
+    , m_fullFrameBytes(0)
+    , m_downloader(&TextureManager::DownloadFile)
+    , m_stopWorkers(false)
+    , m_frame(0)
+    , m_cpuBudget(DEFAULT_CPU_BUDGET)
+    , m_gpuBudget(DEFAULT_GPU_BUDGET)
+    , m_uploadBytesBudget(DEFAULT_UPLOAD_BYTES)
+    , m_uploadMsBudget(DEFAULT_UPLOAD_MS)
+    , m_frameUploadBytes(0)
+    , m_frameUploadMs(0.0)
+    , m_frameUploaded(false)
+    , m_frameDeferred(false)
 {
+#ifdef _WIN32
+    if (m_device)
+        m_backend.reset(new D3D11TextureBackend(m_device));
+#endif
+    if (!m_backend)
+        m_backend.reset(new CpuTextureBackend());
+    m_atlas.reset(new TextureAtlas(m_backend.get()));
+
+    const unsigned cores = std::thread::hardware_concurrency();
+    const unsigned workers = std::max(1u, std::min(MAX_DECODE_WORKERS, cores > 1 ? cores - 1 : 1u));
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        m_workers.emplace_back(&TextureManager::WorkerLoop, this, &m_decodeJobs);
+    }
+    for (unsigned i = 0; i < DOWNLOAD_WORKERS; ++i)
+    {
+        m_workers.emplace_back(&TextureManager::WorkerLoop, this, &m_downloadJobs);
+    }
 }
 
 /**
  * @brief Destructeur - libère toutes les textures
+ * 
+ * Les pages appartiennent à l'atlas, libéré avec le gestionnaire. Les
+ * décodages et téléchargements pas encore commencés sont abandonnés ; ceux
+ * en cours se terminent (un téléchargement n'essaie pas l'URL suivante)
+ * avant la libération des résultats publiés mais jamais rangés.
  */
 TextureManager::~TextureManager()
 {
-    for (auto& pair : m_gifs)
     {
-        for (auto& frame : pair.second.frames)
-        {
-            if (frame.texture)
-            {
-                frame.texture->Release();
-            }
-        }
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_stopWorkers = true;
+        m_decodeJobs.jobs.clear();
+        m_downloadJobs.jobs.clear();
     }
-    
-    for (auto& pair : m_staticImages)
+    m_decodeJobs.cv.notify_all();
+    m_downloadJobs.cv.notify_all();
+    for (std::thread& worker : m_workers)
     {
-        if (pair.second)
-        {
-            pair.second->Release();
-        }
+        worker.join();
+    }
+
+    PendingImage* node = m_published.exchange(nullptr, std::memory_order_acquire);
+    while (node)
+    {
+        PendingImage* next = node->next;
+        delete node;
+        node = next;
     }
 }
 
+#ifdef _WIN32
+
 /**
- * @brief Crée une texture DirectX11 depuis des données RGBA
+ * @brief Crée une page vide (mise à jour ensuite par UpdateSubresource)
  */
-ID3D11ShaderResourceView* TextureManager::CreateTexture(const unsigned char* data, int width, int height)
+TextureHandle D3D11TextureBackend::CreateTexture(int width, int height)
 {
-    if (!m_device || !data || width <= 0 || height <= 0)
+    if (!m_device || width <= 0 || height <= 0)
         return nullptr;
 
     // Description de la texture
@@ -73,15 +161,9 @@ ID3D11ShaderResourceView* TextureManager::CreateTexture(const unsigned char* dat
     desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
     desc.CPUAccessFlags = 0;
 
-    // Données initiales
-    D3D11_SUBRESOURCE_DATA initData;
-    ZeroMemory(&initData, sizeof(initData));
-    initData.pSysMem = data;
-    initData.SysMemPitch = width * 4;
-
     // Création de la texture
     ID3D11Texture2D* texture = nullptr;
-    HRESULT hr = m_device->CreateTexture2D(&desc, &initData, &texture);
+    HRESULT hr = m_device->CreateTexture2D(&desc, nullptr, &texture);
     if (FAILED(hr))
         return nullptr;
 
@@ -103,10 +185,46 @@ ID3D11ShaderResourceView* TextureManager::CreateTexture(const unsigned char* dat
     return srv;
 }
 
+/**
+ * @brief Envoie une zone de pixels dans la page
+ */
+void D3D11TextureBackend::UpdateTexture(TextureHandle texture, int x, int y, int width, int height,
+                                        const unsigned char* rgba)
+{
+    ID3D11ShaderResourceView* srv = static_cast<ID3D11ShaderResourceView*>(texture);
+    if (!srv || !m_context)
+        return;
+
+    ID3D11Resource* resource = nullptr;
+    srv->GetResource(&resource);
+
+    D3D11_BOX box;
+    box.left = x;
+    box.top = y;
+    box.front = 0;
+    box.right = x + width;
+    box.bottom = y + height;
+    box.back = 1;
+    m_context->UpdateSubresource(resource, 0, &box, rgba, width * 4, 0);
+    resource->Release();
+}
+
+/**
+ * @brief Libère une page
+ */
+void D3D11TextureBackend::DestroyTexture(TextureHandle texture)
+{
+    if (texture)
+        static_cast<ID3D11ShaderResourceView*>(texture)->Release();
+}
+
 /**
  * @brief Télécharge un fichier depuis internet via WinHTTP
+ *
+ * Le port de l'URL (hôte:port) est respecté, comme pour les requêtes du
+ * MatrixClient : un serveur sur un port non standard sert aussi les médias.
  */
-std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url)
+std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url, const std::string& authorization)
 {
     std::vector<unsigned char> result;
 
@@ -138,6 +256,22 @@ std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url)
         host = url.substr(start);
     }
 
+    // Port explicite (serveur local sur :8008, fédération sur :8448...)
+    INTERNET_PORT port = useHttps ? INTERNET_DEFAULT_HTTPS_PORT : INTERNET_DEFAULT_HTTP_PORT;
+    size_t colonPos = host.rfind(':');
+    size_t bracketPos = host.rfind(']');
+    if (colonPos != std::string::npos && (bracketPos == std::string::npos || colonPos > bracketPos))
+    {
+        const std::string digits = host.substr(colonPos + 1);
+        if (digits.empty() || digits.size() > 5 || digits.find_first_not_of("0123456789") != std::string::npos)
+            return result;
+        const unsigned long value = std::stoul(digits);
+        if (value == 0 || value > 65535)
+            return result;
+        port = static_cast<INTERNET_PORT>(value);
+        host.resize(colonPos);
+    }
+
     // Conversion en wide string
     std::wstring wHost(host.begin(), host.end());
     std::wstring wPath(path.begin(), path.end());
@@ -155,7 +289,6 @@ std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url)
         return result;
 
     // Connexion
-    INTERNET_PORT port = useHttps ? INTERNET_DEFAULT_HTTPS_PORT : INTERNET_DEFAULT_HTTP_PORT;
     HINTERNET hConnect = WinHttpConnect(hSession, wHost.c_str(), port, 0);
     if (!hConnect)
     {
@@ -182,6 +315,14 @@ std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url)
         return result;
     }
 
+    // En-tête d'authentification (médias Matrix)
+    if (!authorization.empty())
+    {
+        std::string header = "Authorization: " + authorization;
+        std::wstring wHeader(header.begin(), header.end());
+        WinHttpAddRequestHeaders(hRequest, wHeader.c_str(), static_cast<DWORD>(-1), WINHTTP_ADDREQ_FLAG_ADD);
+    }
+
     // Envoyer la requête
     BOOL bResults = WinHttpSendRequest(
         hRequest,
@@ -198,6 +339,17 @@ std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url)
         bResults = WinHttpReceiveResponse(hRequest, NULL);
     }
 
+    // Une réponse d'erreur (JSON du serveur) n'est pas un fichier
+    if (bResults)
+    {
+        DWORD statusCode = 0;
+        DWORD statusSize = sizeof(statusCode);
+        bResults = WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                                       WINHTTP_HEADER_NAME_BY_INDEX, &statusCode, &statusSize,
+                                       WINHTTP_NO_HEADER_INDEX)
+                   && statusCode >= 200 && statusCode < 300;
+    }
+
     // Lire les données
     if (bResults)
     {
@@ -229,176 +381,1002 @@ std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url)
     return result;
 }
 
+#else
+
 /**
- * @brief Décode un GIF et crée les textures pour chaque frame
+ * @brief Sans WinHTTP (pilote headless) : aucun téléchargement
  */
-bool TextureManager::DecodeGif(const std::vector<unsigned char>& data, AnimatedGif& gif)
+std::vector<unsigned char> TextureManager::DownloadFile(const std::string& url, const std::string& authorization)
 {
-    if (data.empty())
-        return false;
+    (void)url;
+    (void)authorization;
+    return {};
+}
 
-    int* delays = nullptr;
-    int width, height, frames, comp;
-
-    unsigned char* pixels = stbi_load_gif_from_memory(
-        data.data(),
-        static_cast<int>(data.size()),
-        &delays,
-        &width,
-        &height,
-        &frames,
-        &comp,
-        4
-    );
+#endif // _WIN32
 
-    if (!pixels)
-        return false;
+/**
+ * @brief Handle de l'image de ce nom, créée au besoin
+ */
+ImageHandle TextureManager::Acquire(const std::string& name)
+{
+    auto it = m_names.find(name);
+    if (it != m_names.end() && m_images.Get(it->second))
+        return it->second;
+
+    CachedImage image;
+    image.name = name;
+    ImageHandle handle = m_images.Insert(std::move(image));
+    m_names[name] = handle;
+    return handle;
+}
+
+/**
+ * @brief Handle d'une image déjà demandée
+ */
+ImageHandle TextureManager::Find(const std::string& name) const
+{
+    auto it = m_names.find(name);
+    return it != m_names.end() ? it->second : ImageHandle();
+}
+
+/**
+ * @brief Oublie une image
+ *
+ * Un chargement encore en cours sera ignoré : sa génération ne
+ * correspond plus.
+ */
+void TextureManager::Unload(ImageHandle handle)
+{
+    CachedImage* image = m_images.Get(handle);
+    if (!image)
+        return;
+
+    if (image->loaded)
+        m_atlas->Remove(image->region);
+    m_names.erase(image->name);
+    m_images.Remove(handle);
+}
 
-    gif.width = width;
-    gif.height = height;
-    gif.frames.reserve(frames);
+/**
+ * @brief Lance le téléchargement d'un GIF en arrière-plan
+ */
+ImageHandle TextureManager::LoadGifFromUrl(const std::string& url, const std::string& name)
+{
+    return LoadImageFromUrls(std::vector<std::string>(1, url), name);
+}
+
+/**
+ * @brief Lance le téléchargement d'une image en arrière-plan
+ *
+ * Le thread de téléchargement décode aussitôt chaque réponse : un fichier
+ * illisible (erreur du serveur, format inconnu) fait passer à l'URL
+ * suivante.
+ */
+ImageHandle TextureManager::LoadImageFromUrls(const std::vector<std::string>& urls, const std::string& name,
+                                              const std::string& authorization)
+{
+    ImageHandle handle = Acquire(name);
+    CachedImage& image = *m_images.Get(handle);
 
-    int stride = width * height * 4;
+    // Déjà chargé (même évincé) ou en cours de chargement
+    if (image.loaded || image.loading || image.compressed)
+        return handle;
 
-    for (int i = 0; i < frames; ++i)
+    // Marquer comme en cours de chargement
+    image.loading = true;
+
+    // Télécharger et décoder sur un thread de téléchargement
+    Submit(m_downloadJobs, [this, downloader = m_downloader, urls, authorization, handle]()
+    {
+        for (const std::string& url : urls)
+        {
+            if (StopRequested())
+                return;
+
+            std::unique_ptr<PendingImage> decoded =
+                Decode(handle, std::make_shared<const std::vector<unsigned char>>(downloader(url, authorization)));
+            if (decoded)
+            {
+                Publish(std::move(decoded));
+                return;
+            }
+        }
+        DecodeAndPublish(handle, nullptr);
+    });
+
+    return handle;
+}
+
+/**
+ * @brief Remplace la fonction de téléchargement
+ */
+void TextureManager::SetDownloader(Downloader downloader)
+{
+    m_downloader = std::move(downloader);
+}
+
+/**
+ * @brief Publie un résultat de chargement
+ *
+ * Empile le résultat (CAS) : aucun verrou, le thread de rendu n'attend
+ * jamais un thread de chargement.
+ */
+void TextureManager::Publish(std::unique_ptr<PendingImage> image)
+{
+    PendingImage* node = image.release();
+    node->next = m_published.load(std::memory_order_relaxed);
+    while (!m_published.compare_exchange_weak(node->next, node,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed))
     {
-        GifFrame frame;
-        frame.texture = CreateTexture(pixels + (i * stride), width, height);
-        frame.delay = delays ? delays[i] : 100;
-        
-        if (frame.delay < 20)
-            frame.delay = 100; // Minimum 20ms
-            
-        gif.frames.push_back(frame);
     }
+}
 
-    if (delays)
-        free(delays);
-    stbi_image_free(pixels);
+/**
+ * @brief Décode un fichier, sans le publier
+ *
+ * Le format est reconnu à sa signature : PNG et JPEG donnent des pixels
+ * RGBA, le reste est lu comme un GIF.
+ */
+std::unique_ptr<TextureManager::PendingImage> TextureManager::Decode(
+    ImageHandle handle, std::shared_ptr<const std::vector<unsigned char>> data)
+{
+    if (!data || data->empty())
+        return nullptr;
 
-    gif.loaded = true;
-    gif.loading = false;
-    gif.lastFrameTime = std::chrono::steady_clock::now();
+    std::unique_ptr<PendingImage> image(new PendingImage());
+    image->handle = handle;
 
-    return true;
+    const unsigned char* bytes = data->data();
+    const size_t size = data->size();
+    bool decoded = false;
+    if (IsPng(bytes, size))
+        decoded = DecodePng(bytes, size, image->pixels, image->width, image->height);
+    else if (IsJpeg(bytes, size))
+        decoded = DecodeJpeg(bytes, size, image->pixels, image->width, image->height);
+    else
+        decoded = DecodeIndexedGif(bytes, size, image->gif);
+
+    if (!decoded)
+        return nullptr;
+    image->compressed = std::move(data);
+    return image;
 }
 
 /**
- * @brief Lance le téléchargement d'un GIF en arrière-plan
+ * @brief Décode un fichier et publie le résultat
+ *
+ * Un échec publie un résultat vide, pour que l'image ne reste pas
+ * indéfiniment en chargement.
  */
-bool TextureManager::LoadGifFromUrl(const std::string& url, const std::string& name)
+bool TextureManager::DecodeAndPublish(ImageHandle handle, std::shared_ptr<const std::vector<unsigned char>> data)
 {
-    std::lock_guard<std::mutex> lock(g_textureMutex);
-    
-    // Vérifie si déjà en cours de chargement
-    auto it = m_gifs.find(name);
-    if (it != m_gifs.end())
+    std::unique_ptr<PendingImage> image = Decode(handle, std::move(data));
+    const bool decoded = image != nullptr;
+    if (!decoded)
     {
-        if (it->second.loaded || it->second.loading)
-            return true;
+        image.reset(new PendingImage());
+        image->handle = handle;
     }
 
-    // Marquer comme en cours de chargement
-    m_gifs[name].loading = true;
+    Publish(std::move(image));
+    return decoded;
+}
+
+/**
+ * @brief Confie un travail à un groupe de threads
+ */
+void TextureManager::Submit(JobQueue& queue, std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queue.cv.notify_one();
+}
 
-    // Télécharger et décoder dans un thread séparé
-    std::thread([this, url, name]()
+/**
+ * @brief Boucle d'un thread de décodage ou de téléchargement
+ *
+ * Le verrou ne protège que la file : le travail se fait sans lui.
+ */
+void TextureManager::WorkerLoop(JobQueue* queue)
+{
+    for (;;)
     {
-        auto data = DownloadFile(url);
-        
-        if (!data.empty())
+        std::function<void()> job;
         {
-            AnimatedGif gif;
-            if (DecodeGif(data, gif))
-            {
-                std::lock_guard<std::mutex> lock(g_textureMutex);
-                m_gifs[name] = std::move(gif);
-            }
+            std::unique_lock<std::mutex> lock(m_jobMutex);
+            queue->cv.wait(lock, [this, queue] { return m_stopWorkers || !queue->jobs.empty(); });
+            if (m_stopWorkers)
+                return;
+            job = std::move(queue->jobs.front());
+            queue->jobs.pop_front();
         }
-        else
+        job();
+    }
+}
+
+/**
+ * @brief Le destructeur a demandé l'arrêt des threads
+ */
+bool TextureManager::StopRequested()
+{
+    std::lock_guard<std::mutex> lock(m_jobMutex);
+    return m_stopWorkers;
+}
+
+/**
+ * @brief Début de frame : évince ce qui dépasse les budgets
+ */
+void TextureManager::BeginFrame()
+{
+    ++m_frame;
+    ResetUploadBudget();
+    EnforceBudgets();
+}
+
+/**
+ * @brief Budgets mémoire du cache
+ */
+void TextureManager::SetBudgets(size_t cpuBytes, size_t gpuBytes)
+{
+    m_cpuBudget = cpuBytes;
+    m_gpuBudget = gpuBytes;
+}
+
+/**
+ * @brief Budget d'envoi vers l'atlas, par frame
+ */
+void TextureManager::SetUploadBudget(size_t bytesPerFrame, double msPerFrame)
+{
+    m_uploadBytesBudget = bytesPerFrame;
+    m_uploadMsBudget = msPerFrame;
+}
+
+/**
+ * @brief Indique si la frame peut encore envoyer une image
+ *
+ * La taille de l'image compte : une image qui ferait dépasser le budget
+ * d'octets attend la frame suivante, sauf si rien n'a encore été envoyé.
+ * Le temps, lui, ne se prévoit pas et n'est vérifié qu'après coup.
+ */
+bool TextureManager::UploadBudgetLeft(size_t bytes)
+{
+    if (!m_frameUploaded)
+        return true;
+    if (m_uploadBytesBudget > 0 && m_frameUploadBytes + bytes > m_uploadBytesBudget)
+        return false;
+    return m_uploadMsBudget <= 0.0 || m_frameUploadMs < m_uploadMsBudget;
+}
+
+/**
+ * @brief Nouvelle frame pour le budget d'envoi
+ */
+void TextureManager::ResetUploadBudget()
+{
+    m_frameUploadBytes = 0;
+    m_frameUploadMs = 0.0;
+    m_frameUploaded = false;
+    m_frameDeferred = false;
+}
+
+/**
+ * @brief Compte un envoi dans le budget de la frame
+ */
+void TextureManager::ChargeUpload(size_t bytes, std::chrono::steady_clock::time_point start)
+{
+    m_frameUploadBytes += bytes;
+    m_frameUploadMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_frameUploaded = true;
+    ++m_uploadStats.uploads;
+    m_uploadStats.maxFrameBytes = std::max(m_uploadStats.maxFrameBytes, m_frameUploadBytes);
+    m_uploadStats.maxFrameMs = std::max(m_uploadStats.maxFrameMs, m_frameUploadMs);
+}
+
+/**
+ * @brief Taille à laquelle une image est affichée
+ *
+ * Un GIF déjà rangé change de zone tout de suite, sans revenir à sa
+ * première frame.
+ */
+void TextureManager::SetTargetSize(ImageHandle handle, int maxWidth, int maxHeight)
+{
+    CachedImage* image = m_images.Get(handle);
+    if (!image || (image->targetWidth == maxWidth && image->targetHeight == maxHeight))
+        return;
+
+    image->targetWidth = maxWidth;
+    image->targetHeight = maxHeight;
+    if (!image->loaded)
+        return;
+
+    int width, height;
+    DisplaySize(*image, image->width, image->height, width, height);
+    if (width == image->region.width && height == image->region.height)
+        return;
+
+    if (image->source.frames.empty())
+    {
+        // Image statique : redécodée à la nouvelle taille au prochain dessin
+        if (!image->pinned)
         {
-            std::lock_guard<std::mutex> lock(g_textureMutex);
-            m_gifs[name].loading = false;
+            m_atlas->Remove(image->region);
+            image->region = TextureRegion();
+            image->loaded = false;
         }
-    }).detach();
+        return;
+    }
 
-    return true;
+    m_atlas->Remove(image->region);
+    image->loaded = PlaceCanvas(*image);
+    if (!image->loaded)
+        image->region = TextureRegion();
 }
 
 /**
  * @brief Met à jour les animations
+ *
+ * Le coût ne dépend que des GIFs redemandés et des animations dues : les
+ * GIFs hors écran ne sont pas parcourus.
  */
 void TextureManager::Update()
 {
-    std::lock_guard<std::mutex> lock(g_textureMutex);
-    
+    ProfileScope profile(ProfileSection::TextureUpdate);
+
+    // Sans BeginFrame, rien ne marque les frames : chaque appel en est une
+    if (m_frame == 0)
+        ResetUploadBudget();
+
+    FlushPendingImages();
+
+    // Évincés puis redemandés (GetCurrentFrame) : retour dans l'atlas. Les
+    // GIFs dont les frames sont encore en mémoire sont rangés tout de suite,
+    // sur le budget d'envoi ; les autres sont redécodés.
+    size_t waiting = 0;
+    for (ImageHandle handle : m_restoreQueue)
+    {
+        CachedImage* image = m_images.Get(handle);
+        if (!image)
+            continue;
+        if (image->loaded || image->loading)
+        {
+            image->restoreQueued = false;
+            continue;
+        }
+
+        if (!image->source.frames.empty())
+        {
+            int width, height;
+            DisplaySize(*image, image->width, image->height, width, height);
+            if (!UploadBudgetLeft(static_cast<size_t>(width) * height * 4))
+            {
+                m_restoreQueue[waiting++] = handle;
+                continue;
+            }
+            image->restoreQueued = false;
+            auto start = std::chrono::steady_clock::now();
+            UploadGif(handle, *image);
+            ChargeUpload(static_cast<size_t>(width) * height * 4, start);
+            continue;
+        }
+
+        image->restoreQueued = false;
+        if (image->compressed)
+        {
+            image->loading = true;
+            ++m_cacheStats.redecodes;
+            Submit(m_decodeJobs, [this, handle, data = image->compressed]()
+            {
+                DecodeAndPublish(handle, data);
+            });
+        }
+    }
+    m_restoreQueue.resize(waiting);
+
+    auto later = [](const ScheduledFrame& a, const ScheduledFrame& b) { return a.deadline > b.deadline; };
     auto now = std::chrono::steady_clock::now();
 
-    for (auto& pair : m_gifs)
+    while (!m_schedule.empty() && m_schedule.front().deadline <= now)
     {
-        AnimatedGif& gif = pair.second;
-        if (!gif.loaded || gif.frames.empty())
+        std::pop_heap(m_schedule.begin(), m_schedule.end(), later);
+        ScheduledFrame due = m_schedule.back();
+        m_schedule.pop_back();
+
+        CachedImage* image = m_images.Get(due.handle);
+        if (!image || image->scheduleTicket != due.ticket)
             continue;
+        image->scheduled = false;
 
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - gif.lastFrameTime
-        ).count();
+        // Pas dessiné à la frame précédente : en sommeil jusqu'au prochain GetCurrentFrame
+        if (!image->loaded || image->lastUsedFrame + 1 < m_frame)
+            continue;
 
-        if (elapsed >= gif.frames[gif.currentFrame].delay)
+        AdvanceFrames(*image, now);
+        Schedule(due.handle, *image);
+    }
+}
+
+/**
+ * @brief Inscrit la prochaine frame d'un GIF dans l'ordonnanceur
+ */
+void TextureManager::Schedule(ImageHandle handle, CachedImage& image)
+{
+    image.scheduled = true;
+    m_schedule.push_back({ image.nextFrameTime, handle, ++image.scheduleTicket });
+    std::push_heap(m_schedule.begin(), m_schedule.end(),
+                   [](const ScheduledFrame& a, const ScheduledFrame& b) { return a.deadline > b.deadline; });
+}
+
+/**
+ * @brief Passe les frames dues et envoie le rectangle modifié
+ *
+ * L'échéance avance du délai de chaque frame, pas depuis l'instant
+ * présent : un Update() en retard ne décale pas la suite de l'animation.
+ * Au-delà de MAX_CATCH_UP_FRAMES frames de retard (fenêtre figée, longue
+ * pause), on repart de maintenant au lieu de tout rattraper.
+ */
+void TextureManager::AdvanceFrames(CachedImage& image, std::chrono::steady_clock::time_point now)
+{
+    static constexpr int MAX_CATCH_UP_FRAMES = 4;
+
+    const size_t frameCount = image.source.frames.size();
+    GifRect dirty;
+    int steps = 0;
+    while (image.nextFrameTime <= now)
+    {
+        if (steps == MAX_CATCH_UP_FRAMES)
         {
-            gif.currentFrame = (gif.currentFrame + 1) % gif.frames.size();
-            gif.lastFrameTime = now;
+            image.nextFrameTime = now + std::chrono::milliseconds(image.source.frames[image.currentFrame].delay);
+            break;
         }
+
+        image.currentFrame = static_cast<int>((image.currentFrame + 1) % frameCount);
+        dirty = dirty.Union(image.canvas.Apply(image.source, image.currentFrame));
+        image.nextFrameTime += std::chrono::milliseconds(image.source.frames[image.currentFrame].delay);
+        m_fullFrameBytes += static_cast<uint64_t>(image.width) * image.height * 4;
+        ++steps;
     }
+
+    // Seul le rectangle modifié part vers la texture
+    if (!dirty.Empty())
+        UploadRect(image, dirty);
 }
 
 /**
- * @brief Récupère la texture de la frame actuelle
+ * @brief Envoie une zone modifiée de la toile
+ *
+ * À taille réduite, la zone envoyée couvre les pixels réduits dont la
+ * boîte source touche le rectangle modifié.
  */
-ID3D11ShaderResourceView* TextureManager::GetCurrentFrame(const std::string& name)
+void TextureManager::UploadRect(CachedImage& image, const GifRect& dirty)
 {
-    std::lock_guard<std::mutex> lock(g_textureMutex);
-    
-    auto it = m_gifs.find(name);
-    if (it == m_gifs.end() || !it->second.loaded || it->second.frames.empty())
-        return nullptr;
+    const int pitch = image.canvas.GetPitch();
+    const int width = image.region.width;
+    const int height = image.region.height;
+    if (width == image.width && height == image.height)
+    {
+        m_atlas->Update(image.region, dirty.x, dirty.y, dirty.width, dirty.height,
+                        image.canvas.GetPixels() + static_cast<size_t>(dirty.y) * pitch + dirty.x * 4, pitch);
+        m_uploadedBytes += static_cast<uint64_t>(dirty.width) * dirty.height * 4;
+        return;
+    }
+
+    const int x0 = static_cast<int>(static_cast<int64_t>(dirty.x) * width / image.width);
+    const int y0 = static_cast<int>(static_cast<int64_t>(dirty.y) * height / image.height);
+    const int x1 = static_cast<int>((static_cast<int64_t>(dirty.x + dirty.width) * width + image.width - 1) / image.width);
+    const int y1 = static_cast<int>((static_cast<int64_t>(dirty.y + dirty.height) * height + image.height - 1) / image.height);
+
+    m_scaled.resize(static_cast<size_t>(x1 - x0) * (y1 - y0) * 4);
+    DownscaleBox(image.canvas.GetPixels(), image.width, image.height, pitch, width, height,
+                 x0, y0, x1 - x0, y1 - y0, m_scaled.data(), (x1 - x0) * 4);
+    m_atlas->Update(image.region, x0, y0, x1 - x0, y1 - y0, m_scaled.data(), (x1 - x0) * 4);
+    m_uploadedBytes += m_scaled.size();
+}
+
+/**
+ * @brief Range les résultats publiés dans l'atlas
+ *
+ * Appelée par Update(), depuis le thread de rendu. La pile est vidée d'un
+ * coup puis remise dans l'ordre de publication ; les résultats d'une image
+ * déchargée entre-temps sont jetés.
+ */
+void TextureManager::FlushPendingImages()
+{
+    // Pile des résultats publiés -> file d'envoi, dans l'ordre d'arrivée
+    PendingImage* node = m_published.exchange(nullptr, std::memory_order_acquire);
+    PendingImage* ordered = nullptr;
+    while (node)
+    {
+        PendingImage* next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+
+    while (ordered)
+    {
+        std::unique_ptr<PendingImage> pending(ordered);
+        ordered = ordered->next;
+        pending->next = nullptr;
+
+        CachedImage* image = m_images.Get(pending->handle);
+        if (!image)
+            continue;
+
+        if (pending->pixels.empty() && pending->gif.frames.empty())
+        {
+            // Échec du téléchargement ou du décodage : rien à envoyer
+            image->loading = false;
+            continue;
+        }
+        m_uploadQueue.push_back(std::move(pending));
+    }
+
+    if (m_uploadQueue.empty())
+        return;
+
+    // Images dessinées à cette frame ou à la précédente d'abord (une image
+    // jamais dessinée a lastUsedFrame à 0)
+    std::stable_partition(m_uploadQueue.begin(), m_uploadQueue.end(),
+                          [this](const std::unique_ptr<PendingImage>& pending)
+                          {
+                              const CachedImage* image = m_images.Get(pending->handle);
+                              return image && image->lastUsedFrame > 0 && image->lastUsedFrame + 1 >= m_frame;
+                          });
+
+    size_t sent = 0;
+    while (sent < m_uploadQueue.size() && UploadBudgetLeft(PendingUploadBytes(*m_uploadQueue[sent])))
+    {
+        std::unique_ptr<PendingImage> pending = std::move(m_uploadQueue[sent++]);
+        if (!m_images.Get(pending->handle))
+            continue;
+
+        auto start = std::chrono::steady_clock::now();
+        ChargeUpload(UploadPending(*pending), start);
+    }
+    m_uploadQueue.erase(m_uploadQueue.begin(), m_uploadQueue.begin() + sent);
+
+    if (!m_uploadQueue.empty() && !m_frameDeferred)
+    {
+        m_frameDeferred = true;
+        ++m_uploadStats.deferredFrames;
+    }
+}
+
+/**
+ * @brief Range un résultat de chargement dans l'atlas
+ */
+size_t TextureManager::UploadPending(PendingImage& pending)
+{
+    CachedImage* image = m_images.Get(pending.handle);
+
+    if (!pending.pixels.empty())
+    {
+        // Image statique (remplace la précédente de même nom). Décodée
+        // depuis un fichier, elle peut être évincée : les pixels ne sont
+        // pas gardés, le fichier suffit pour la redécoder.
+        if (image->loaded)
+            m_atlas->Remove(image->region);
+        image->pinned = !pending.compressed;
+        if (pending.compressed)
+            image->compressed = std::move(pending.compressed);
+        image->width = pending.width;
+        image->height = pending.height;
+        image->loading = false;
+        image->lastUsedFrame = std::max(image->lastUsedFrame, m_frame);
+
+        int width, height;
+        DisplaySize(*image, image->width, image->height, width, height);
+        const unsigned char* pixels = pending.pixels.data();
+        if (width != image->width || height != image->height)
+        {
+            m_scaled.resize(static_cast<size_t>(width) * height * 4);
+            DownscaleBox(pixels, image->width, image->height, image->width * 4, width, height,
+                         0, 0, width, height, m_scaled.data(), width * 4);
+            pixels = m_scaled.data();
+        }
+        image->loaded = m_atlas->Add(pixels, width, height, image->region);
+        return static_cast<size_t>(width) * height * 4;
+    }
+
+    // Nouveau GIF, rechargement ou redécodage après éviction
+    if (image->loaded)
+        EvictGpu(*image);
+    image->source = std::move(pending.gif);
+    if (pending.compressed)
+        image->compressed = std::move(pending.compressed);
+    image->width = image->source.width;
+    image->height = image->source.height;
+    for (IndexedFrame& frame : image->source.frames)
+    {
+        if (frame.delay < 20)
+            frame.delay = 100; // Minimum 20ms
+    }
+    image->loading = false;
+    image->lastUsedFrame = std::max(image->lastUsedFrame, m_frame);
+    UploadGif(pending.handle, *image);
+
+    int width, height;
+    DisplaySize(*image, image->width, image->height, width, height);
+    return static_cast<size_t>(width) * height * 4;
+}
+
+/**
+ * @brief Taille d'un résultat en attente, une fois rangé dans l'atlas
+ */
+size_t TextureManager::PendingUploadBytes(const PendingImage& pending) const
+{
+    const CachedImage* image = m_images.Get(pending.handle);
+    if (!image)
+        return 0;
+
+    int width, height;
+    if (!pending.pixels.empty())
+        DisplaySize(*image, pending.width, pending.height, width, height);
+    else
+        DisplaySize(*image, pending.gif.width, pending.gif.height, width, height);
+    return static_cast<size_t>(width) * height * 4;
+}
+
+/**
+ * @brief Compose la première frame, réserve la zone du GIF dans l'atlas
+ * et lance son animation
+ */
+void TextureManager::UploadGif(ImageHandle handle, CachedImage& image)
+{
+    image.canvas.Reset(image.width, image.height);
+    image.canvas.Apply(image.source, 0);
+    image.currentFrame = 0;
+    image.nextFrameTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(image.source.frames[0].delay);
+    image.loaded = PlaceCanvas(image);
+    if (image.loaded && image.source.frames.size() >= 2)
+        Schedule(handle, image);
+}
+
+/**
+ * @brief Range la toile courante dans l'atlas, à la taille d'affichage
+ */
+bool TextureManager::PlaceCanvas(CachedImage& image)
+{
+    int width, height;
+    DisplaySize(image, image.width, image.height, width, height);
+    if (width == image.width && height == image.height)
+        return m_atlas->Add(image.canvas.GetPixels(), width, height, image.region);
+
+    m_scaled.resize(static_cast<size_t>(width) * height * 4);
+    DownscaleBox(image.canvas.GetPixels(), image.width, image.height, image.canvas.GetPitch(), width, height,
+                 0, 0, width, height, m_scaled.data(), width * 4);
+    return m_atlas->Add(m_scaled.data(), width, height, image.region);
+}
+
+/**
+ * @brief Taille d'affichage : proportions gardées, jamais plus grande que le fichier
+ */
+void TextureManager::DisplaySize(const CachedImage& image, int width, int height, int& displayWidth, int& displayHeight)
+{
+    displayWidth = width;
+    displayHeight = height;
+    if (image.targetWidth <= 0 || image.targetHeight <= 0)
+        return;
+
+    const double scale = std::min(static_cast<double>(image.targetWidth) / width,
+                                  static_cast<double>(image.targetHeight) / height);
+    if (scale >= 1.0)
+        return;
+    displayWidth = std::max(1, static_cast<int>(std::lround(width * scale)));
+    displayHeight = std::max(1, static_cast<int>(std::lround(height * scale)));
+}
+
+/**
+ * @brief Libère la zone d'une image dans l'atlas (et sa toile)
+ */
+void TextureManager::EvictGpu(CachedImage& image)
+{
+    m_atlas->Remove(image.region);
+    image.region = TextureRegion();
+    image.canvas = GifCanvas();
+    image.loaded = false;
+    ++m_cacheStats.gpuEvictions;
+}
+
+/**
+ * @brief Libère les frames décodées d'un GIF (et sa zone dans l'atlas)
+ */
+void TextureManager::EvictCpu(CachedImage& image)
+{
+    if (image.loaded)
+        EvictGpu(image);
+    image.source = IndexedGif();
+    ++m_cacheStats.cpuEvictions;
+}
+
+/**
+ * @brief Mémoire CPU occupée par les images du cache
+ */
+size_t TextureManager::GetCpuBytes() const
+{
+    size_t bytes = 0;
+    m_images.ForEach([&bytes](ImageHandle, const CachedImage& image)
+    {
+        bytes += image.source.BytesUsed() + image.canvas.BytesUsed();
+        if (image.compressed)
+            bytes += image.compressed->capacity();
+    });
+    return bytes;
+}
+
+/**
+ * @brief Évince les GIFs les moins récemment dessinés jusqu'à respecter les budgets
+ *
+ * Budget CPU : les frames décodées des GIFs qui ont un fichier compressé à
+ * redécoder. Budget GPU : une page de l'atlas ne rend sa mémoire que quand
+ * elle est vide, donc on évince page par page, en commençant par celle
+ * dont le dernier dessin est le plus ancien. Les pages qui portent une
+ * image statique ne sont jamais libérées.
+ */
+void TextureManager::EnforceBudgets()
+{
+    // Dessiné à la frame précédente (ou à celle-ci) : visible, on garde
+    const uint64_t oldest = m_frame > 0 ? m_frame - 1 : 0;
+
+    size_t cpuBytes = GetCpuBytes();
+    if (cpuBytes > m_cpuBudget)
+    {
+        std::vector<std::pair<uint64_t, CachedImage*>> candidates;
+        m_images.ForEach([&](ImageHandle, CachedImage& image)
+        {
+            if (image.compressed && !image.source.frames.empty() && image.lastUsedFrame < oldest)
+                candidates.emplace_back(image.lastUsedFrame, &image);
+        });
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (const auto& candidate : candidates)
+        {
+            if (cpuBytes <= m_cpuBudget)
+                break;
+            CachedImage& image = *candidate.second;
+            cpuBytes -= std::min(cpuBytes, image.source.BytesUsed() + image.canvas.BytesUsed());
+            EvictCpu(image);
+        }
+    }
+
+    while (m_atlas->GetStats().totalPixels * 4 > m_gpuBudget)
+    {
+        // Dernier dessin de chaque page
+        std::map<TextureHandle, uint64_t> pageUse;
+        m_images.ForEach([&pageUse](ImageHandle, const CachedImage& image)
+        {
+            if (!image.loaded)
+                return;
+            uint64_t& use = pageUse[image.region.texture];
+            use = image.pinned ? UINT64_MAX : std::max(use, image.lastUsedFrame);
+        });
+
+        TextureHandle victim = nullptr;
+        uint64_t victimUse = oldest;
+        for (const auto& page : pageUse)
+        {
+            if (page.second < victimUse)
+            {
+                victim = page.first;
+                victimUse = page.second;
+            }
+        }
+        if (!victim)
+            break;
 
-    return it->second.frames[it->second.currentFrame].texture;
+        m_images.ForEach([&](ImageHandle, CachedImage& image)
+        {
+            if (image.loaded && image.region.texture == victim)
+                EvictGpu(image);
+        });
+    }
+}
+
+/**
+ * @brief Récupère la frame actuelle
+ *
+ * Accès direct à l'emplacement du handle : ni chaîne, ni verrou.
+ */
+TextureRegion TextureManager::GetCurrentFrame(ImageHandle handle)
+{
+    CachedImage* image = m_images.Get(handle);
+    if (!image)
+        return TextureRegion();
+
+    // Un GIF évincé revient au prochain Update()
+    image->lastUsedFrame = m_frame;
+    if (!image->loaded)
+    {
+        if (!image->loading && !image->restoreQueued)
+        {
+            image->restoreQueued = true;
+            m_restoreQueue.push_back(handle);
+        }
+        ++m_cacheStats.misses;
+        return TextureRegion();
+    }
+
+    // De retour à l'écran : l'animation reprend là où elle s'était endormie
+    if (!image->scheduled && image->source.frames.size() >= 2)
+    {
+        image->nextFrameTime = std::max(image->nextFrameTime, std::chrono::steady_clock::now());
+        Schedule(handle, *image);
+    }
+
+    ++m_cacheStats.hits;
+    return image->region;
 }
 
 /**
  * @brief Récupère les dimensions d'un GIF
  */
-bool TextureManager::GetGifSize(const std::string& name, int& width, int& height)
+bool TextureManager::GetGifSize(ImageHandle handle, int& width, int& height) const
 {
-    std::lock_guard<std::mutex> lock(g_textureMutex);
-    
-    auto it = m_gifs.find(name);
-    if (it == m_gifs.end() || !it->second.loaded)
+    const CachedImage* image = m_images.Get(handle);
+    if (!image || image->width <= 0)
         return false;
 
-    width = it->second.width;
-    height = it->second.height;
+    width = image->width;
+    height = image->height;
     return true;
 }
 
 /**
  * @brief Vérifie si un GIF est chargé
  */
-bool TextureManager::IsLoaded(const std::string& name)
+bool TextureManager::IsLoaded(ImageHandle handle) const
 {
-    std::lock_guard<std::mutex> lock(g_textureMutex);
-    
-    auto it = m_gifs.find(name);
-    return it != m_gifs.end() && it->second.loaded;
+    const CachedImage* image = m_images.Get(handle);
+    return image && image->loaded;
 }
 
 /**
- * @brief Charge une image statique depuis la mémoire
+ * @brief Charge une image depuis la mémoire
+ *
+ * Seule la signature est vérifiée ici : le décodage se fait sur un thread
+ * de travail, jamais sur le thread de rendu.
  */
-bool TextureManager::LoadImageFromMemory(const unsigned char* data, int size, const std::string& name)
+ImageHandle TextureManager::LoadImageFromMemory(const unsigned char* data, int size, const std::string& name)
 {
-    // Utilise stbi pour décoder l'image
-    // Pour l'instant, on ne supporte que les GIFs animés
-    return false;
+    if (!data || size <= 0)
+        return ImageHandle();
+
+    const size_t length = static_cast<size_t>(size);
+    const bool isGif = length >= 4 && memcmp(data, "GIF8", 4) == 0;
+    if (!IsPng(data, length) && !IsJpeg(data, length) && !isGif)
+        return ImageHandle();
+
+    ImageHandle handle = Acquire(name);
+    m_images.Get(handle)->loading = true;
+
+    // Copie gardée pour redécoder l'image après une éviction
+    auto compressed = std::make_shared<const std::vector<unsigned char>>(data, data + length);
+    Submit(m_decodeJobs, [this, handle, compressed]()
+    {
+        DecodeAndPublish(handle, compressed);
+    });
+    return handle;
+}
+
+/**
+ * @brief Décode un GIF depuis la mémoire
+ */
+ImageHandle TextureManager::LoadGifFromMemory(const unsigned char* data, size_t size, const std::string& name)
+{
+    if (!data || size == 0)
+        return ImageHandle();
+
+    std::unique_ptr<PendingImage> image(new PendingImage());
+    if (!DecodeIndexedGif(data, size, image->gif))
+        return ImageHandle();
+
+    // Copie gardée pour redécoder le GIF après une éviction
+    image->compressed = std::make_shared<const std::vector<unsigned char>>(data, data + size);
+    image->handle = Acquire(name);
+    m_images.Get(image->handle)->loading = true;
+
+    ImageHandle handle = image->handle;
+    Publish(std::move(image));
+    return handle;
+}
+
+/**
+ * @brief Ajoute un GIF déjà décodé en frames indexées
+ */
+ImageHandle TextureManager::LoadDecodedGif(const std::string& name, IndexedGif gif)
+{
+    if (gif.width <= 0 || gif.height <= 0 || gif.frames.empty())
+        return ImageHandle();
+
+    std::unique_ptr<PendingImage> image(new PendingImage());
+    image->gif = std::move(gif);
+    image->handle = Acquire(name);
+    m_images.Get(image->handle)->loading = true;
+
+    ImageHandle handle = image->handle;
+    Publish(std::move(image));
+    return handle;
+}
+
+/**
+ * @brief Ajoute une image statique déjà décodée
+ */
+ImageHandle TextureManager::LoadImageFromPixels(const std::string& name, std::vector<unsigned char> pixels,
+                                                int width, int height)
+{
+    if (width <= 0 || height <= 0 || pixels.size() < static_cast<size_t>(width) * height * 4)
+        return ImageHandle();
+
+    std::unique_ptr<PendingImage> image(new PendingImage());
+    image->pixels = std::move(pixels);
+    image->width = width;
+    image->height = height;
+    image->handle = Acquire(name);
+    m_images.Get(image->handle)->loading = true;
+
+    ImageHandle handle = image->handle;
+    Publish(std::move(image));
+    return handle;
+}
+
+/**
+ * @brief Occupation de l'atlas
+ */
+TextureAtlas::Stats TextureManager::GetAtlasStats() const
+{
+    return m_atlas->GetStats();
+}
+
+/**
+ * @brief Statistiques des GIFs chargés
+ */
+TextureManager::GifStats TextureManager::GetGifStats() const
+{
+    GifStats stats;
+    m_images.ForEach([&stats](ImageHandle, const CachedImage& image)
+    {
+        stats.canvasBytes += image.canvas.BytesUsed();
+        if (image.scheduled)
+            ++stats.animating;
+        if (image.source.frames.empty())
+            return;
+        ++stats.gifs;
+        stats.frames += image.source.frames.size();
+        stats.indexedBytes += image.source.BytesUsed();
+        stats.rgbaBytes += image.source.RgbaBytes();
+    });
+    stats.uploadedBytes = m_uploadedBytes;
+    stats.fullFrameBytes = m_fullFrameBytes;
+    return stats;
+}
+
+/**
+ * @brief Compteurs et occupation du cache
+ */
+TextureManager::CacheStats TextureManager::GetCacheStats() const
+{
+    CacheStats stats = m_cacheStats;
+    stats.cpuBytes = GetCpuBytes();
+    stats.gpuBytes = static_cast<size_t>(m_atlas->GetStats().totalPixels * 4);
+    stats.cpuBudget = m_cpuBudget;
+    stats.gpuBudget = m_gpuBudget;
+    return stats;
+}
+
+/**
+ * @brief Compteurs de la file d'envoi
+ */
+TextureManager::UploadStats TextureManager::GetUploadStats() const
+{
+    UploadStats stats = m_uploadStats;
+    stats.queued = m_uploadQueue.size();
+    for (const std::unique_ptr<PendingImage>& pending : m_uploadQueue)
+    {
+        stats.queuedBytes += PendingUploadBytes(*pending);
+    }
+    return stats;
 }
@@ -5,42 +5,105 @@
  * Ce fichier gère le téléchargement, le décodage et l'animation
  * de GIFs de chats depuis internet.
  * 
+ * Les frames décodées sont rangées dans les pages partagées d'un
+ * TextureAtlas par le thread de rendu (Update), seul à toucher au GPU.
+ * Côté CPU, les GIFs restent en index + palette (IndexedGif), avec les
+ * rectangles propres à chaque frame. Chaque GIF a une seule zone dans
+ * l'atlas : à chaque frame, seul le rectangle modifié de sa toile
+ * (GifCanvas) est renvoyé.
+ * 
+ * La mémoire est bornée par deux budgets (CPU et GPU). Au-delà, les GIFs
+ * les moins récemment dessinés sont évincés : zone de l'atlas libérée
+ * (budget GPU, par pages entières), puis frames décodées (budget CPU). Le
+ * fichier compressé est gardé pour redécoder un GIF évincé s'il est de
+ * nouveau dessiné.
+ * 
+ * Les images sont désignées par des ImageHandle (index + génération dans
+ * une SlotMap) : une recherche est un accès direct au tableau, sans chaîne
+ * ni verrou. Toute l'API s'utilise depuis le thread de rendu ; les threads
+ * de téléchargement et de décodage ne font que publier leurs résultats
+ * dans une pile sans verrou, vidée par Update().
+ * 
+ * Les animations sont ordonnancées par échéance de leur prochaine frame
+ * (tas min) : Update() ne traite que les GIFs dus, et un GIF qui n'a pas
+ * été dessiné à la frame précédente s'endort jusqu'à son prochain dessin.
+ * Les échéances s'accumulent (échéance += délai) : pas de dérive.
+ * 
+ * Avec une taille d'affichage (SetTargetSize), la zone de l'atlas est à
+ * cette taille : la toile est réduite (DownscaleBox) avant chaque envoi.
+ * 
+ * Les images PNG et JPEG (LoadImageFromMemory) sont décodées par un petit
+ * groupe de threads de travail, qui publient leurs pixels comme les GIFs.
+ * Une fois dans l'atlas, seul le fichier compressé reste en mémoire CPU :
+ * une image évincée est redécodée au prochain dessin.
+ * 
+ * Les résultats publiés attendent dans une file d'envoi, que le thread de
+ * rendu vide avec un budget par frame (octets et temps) : les images
+ * dessinées à la frame précédente d'abord, puis dans l'ordre d'arrivée.
+ * Une rafale d'images ne fait plus un pic de frame.
+ * 
+ * Les téléchargements (LoadImageFromUrls) passent par un Downloader,
+ * WinHTTP par défaut, remplaçable par un serveur simulé (pilote headless).
+ * Ils se font sur quelques threads dédiés, joints par le destructeur comme
+ * ceux de décodage.
+ * 
  * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie 
  */
 
 #ifndef TEXTURE_MANAGER_H
 #define TEXTURE_MANAGER_H
 
+#ifdef _WIN32
 #include <d3d11.h>
+#else
+// Pilote headless : pas de Direct3D, les textures restent nulles
+struct ID3D11Device;
+struct ID3D11ShaderResourceView;
+#endif
+#include "texture_atlas.h"
+#include "gif_decoder.h"
+#include "slot_map.h"
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 
 /**
- * @struct GifFrame
- * @brief Une frame d'un GIF animé
+ * @brief Référence vers une image du TextureManager
  */
-struct GifFrame
-{
-    ID3D11ShaderResourceView* texture = nullptr;
-    int delay = 100; // Délai en ms
-};
+typedef SlotHandle ImageHandle;
 
 /**
- * @struct AnimatedGif
- * @brief Un GIF animé complet avec toutes ses frames
+ * @struct CachedImage
+ * @brief Une image du cache : GIF animé, ou image statique
  */
-struct AnimatedGif
+struct CachedImage
 {
-    std::vector<GifFrame> frames;
+    std::string name;
+    IndexedGif source;      // Frames du GIF (vides pour une image statique, ou si évincées)
+    GifCanvas canvas;       // Frame courante composée
+    TextureRegion region;   // Zone de la toile dans l'atlas (texture nulle si évincée)
+    std::shared_ptr<const std::vector<unsigned char>> compressed; // Fichier d'origine (redécodage)
+    uint64_t lastUsedFrame = 0;     // Dernière frame où le GIF a été dessiné
     int currentFrame = 0;
-    std::chrono::steady_clock::time_point lastFrameTime;
+    std::chrono::steady_clock::time_point nextFrameTime;    // Échéance de la frame suivante
+    uint32_t scheduleTicket = 0;    // Identifie l'entrée valide de l'ordonnanceur
     int width = 0;
     int height = 0;
-    bool loaded = false;
-    bool loading = false;
+    int targetWidth = 0;    // Taille d'affichage maximale (0 : taille du fichier)
+    int targetHeight = 0;
+    bool pinned = false;    // Image statique sans fichier : rien pour la recharger, jamais évincée
+    bool loaded = false;    // Zone présente dans l'atlas
+    bool loading = false;   // Décodage en cours
+    bool scheduled = false; // Animation active (présente dans l'ordonnanceur)
+    bool restoreQueued = false;     // Évincée puis redemandée, à recharger au prochain Update()
 };
 
 /**
@@ -50,6 +113,21 @@ struct AnimatedGif
 class TextureManager
 {
 public:
+    static constexpr size_t DEFAULT_CPU_BUDGET = 256 * 1024 * 1024;
+    static constexpr size_t DEFAULT_GPU_BUDGET = 256 * 1024 * 1024;
+    static constexpr size_t DEFAULT_UPLOAD_BYTES = 4 * 1024 * 1024;   // Par frame
+    static constexpr double DEFAULT_UPLOAD_MS = 2.0;                   // Par frame
+
+    /**
+     * @brief Téléchargement d'un fichier (appelé depuis un thread de téléchargement)
+     * 
+     * Paramètres : URL, valeur de l'en-tête Authorization (vide : aucun).
+     * Retourne le corps de la réponse, vide si la requête a échoué ou si le
+     * statut HTTP n'est pas 2xx.
+     */
+    typedef std::function<std::vector<unsigned char>(const std::string& url,
+                                                     const std::string& authorization)> Downloader;
+
     /**
      * @brief Constructeur
      * @param device Device DirectX11
@@ -65,66 +143,446 @@ public:
      * @brief Télécharge un GIF depuis internet
      * @param url URL du GIF
      * @param name Nom pour identifier le GIF
-     * @return true si le téléchargement a démarré
+     * @return Handle du GIF (le même si ce nom est déjà chargé ou en cours)
+     */
+    ImageHandle LoadGifFromUrl(const std::string& url, const std::string& name);
+
+    /**
+     * @brief Télécharge une image (GIF, PNG ou JPEG), avec des URL de repli
+     * @param urls URL essayées dans l'ordre, jusqu'à un fichier lisible
+     * @param name Nom pour identifier l'image
+     * @param authorization Valeur de l'en-tête Authorization (vide : aucun)
+     * @return Handle de l'image (le même si ce nom est déjà chargé ou en cours)
+     * 
+     * Un seul téléchargement par nom : les demandes suivantes, pendant ou
+     * après le chargement, reçoivent le même handle. Si aucune URL ne donne
+     * d'image, l'image reste vide (IsLoaded reste faux) et un nouvel appel
+     * relance le téléchargement. Au-delà de quelques téléchargements
+     * simultanés, les suivants attendent leur tour.
+     */
+    ImageHandle LoadImageFromUrls(const std::vector<std::string>& urls, const std::string& name,
+                                  const std::string& authorization = std::string());
+
+    /**
+     * @brief Remplace la fonction de téléchargement (WinHTTP par défaut)
+     * 
+     * À appeler avant le premier téléchargement : les téléchargements déjà
+     * lancés gardent la fonction précédente.
+     */
+    void SetDownloader(Downloader downloader);
+
+    /**
+     * @brief Handle d'une image déjà demandée
+     * @return Handle invalide si le nom est inconnu
      */
-    bool LoadGifFromUrl(const std::string& url, const std::string& name);
+    ImageHandle Find(const std::string& name) const;
+
+    /**
+     * @brief Oublie une image (sa zone de l'atlas est libérée)
+     * 
+     * Le handle et ses copies deviennent invalides.
+     */
+    void Unload(ImageHandle handle);
     
+    /**
+     * @brief Début de frame : évince ce qui dépasse les budgets
+     * 
+     * À appeler une fois par frame, depuis le thread de rendu. Les GIFs
+     * dessinés à la frame précédente ne sont jamais évincés. Remet aussi à
+     * zéro le budget d'envoi (SetUploadBudget).
+     */
+    void BeginFrame();
+
     /**
      * @brief Met à jour les animations (appeler chaque frame)
+     * 
+     * Seuls les GIFs dont la frame suivante est due, et qui ont été dessinés
+     * à la frame précédente, avancent. Range aussi dans l'atlas les images
+     * arrivées et les GIFs évincés qui viennent d'être redemandés, dans la
+     * limite du budget d'envoi de la frame (SetUploadBudget) : le reste
+     * attend les frames suivantes. Peut être appelée plusieurs fois par
+     * frame, le budget est partagé. Si BeginFrame n'a jamais été appelée,
+     * chaque appel compte comme une frame et dispose du budget entier.
      */
     void Update();
+
+    /**
+     * @brief Budgets mémoire du cache
+     * @param cpuBytes Frames décodées, toiles et fichiers compressés
+     * @param gpuBytes Pages de l'atlas
+     */
+    void SetBudgets(size_t cpuBytes, size_t gpuBytes);
+
+    /**
+     * @brief Budget d'envoi vers l'atlas, par frame
+     * @param bytesPerFrame Octets RGBA rangés au plus par frame (0 : sans limite)
+     * @param msPerFrame Temps passé au plus à ranger par frame (0 : sans limite)
+     * 
+     * Une image est toujours rangée dès que la frame n'a encore rien envoyé,
+     * même plus grosse que le budget : elle n'attend pas indéfiniment. Les
+     * suivantes ne partent que si elles tiennent dans le reste du budget
+     * d'octets.
+     */
+    void SetUploadBudget(size_t bytesPerFrame, double msPerFrame);
+
+    /**
+     * @brief Taille à laquelle une image est affichée
+     * @param handle Handle de l'image
+     * @param maxWidth Largeur maximale (0 : taille du fichier)
+     * @param maxHeight Hauteur maximale (0 : taille du fichier)
+     * 
+     * L'image est rangée dans l'atlas réduite à cette taille (proportions
+     * gardées, jamais agrandie). Un GIF déjà rangé est ré-envoyé à la
+     * nouvelle taille ; une image statique déjà rangée est redécodée à son
+     * prochain dessin, ou garde sa taille si son fichier n'est pas connu.
+     */
+    void SetTargetSize(ImageHandle handle, int maxWidth, int maxHeight);
     
     /**
-     * @brief Récupère la texture actuelle d'un GIF
-     * @param name Nom du GIF
-     * @return Texture ou nullptr si pas trouvé
+     * @brief Récupère la frame actuelle d'un GIF (le marque comme dessiné)
+     * @param handle Handle du GIF
+     * @return Page de l'atlas et UV (texture nulle si inconnu ou évincé)
      */
-    ID3D11ShaderResourceView* GetCurrentFrame(const std::string& name);
+    TextureRegion GetCurrentFrame(ImageHandle handle);
+
+    /**
+     * @brief Récupère une image statique (la marque comme dessinée)
+     * @param handle Handle de l'image
+     * @return Page de l'atlas et UV (texture nulle si inconnue)
+     */
+    TextureRegion GetImage(ImageHandle handle) { return GetCurrentFrame(handle); }
     
     /**
-     * @brief Récupère les dimensions d'un GIF
-     * @param name Nom du GIF
+     * @brief Récupère les dimensions d'un GIF (celles du fichier)
+     * @param handle Handle du GIF
      * @param width Largeur (sortie)
      * @param height Hauteur (sortie)
-     * @return true si trouvé
+     * @return true si décodé au moins une fois
      */
-    bool GetGifSize(const std::string& name, int& width, int& height);
+    bool GetGifSize(ImageHandle handle, int& width, int& height) const;
     
     /**
      * @brief Vérifie si un GIF est chargé
-     * @param name Nom du GIF
-     * @return true si chargé
+     * @param handle Handle du GIF
+     * @return true si présent dans l'atlas
      */
-    bool IsLoaded(const std::string& name);
+    bool IsLoaded(ImageHandle handle) const;
     
     /**
      * @brief Charge une image PNG/JPG depuis des données en mémoire
-     * @param data Données de l'image
+     * @param data Données de l'image (PNG, JPEG, ou GIF)
      * @param size Taille des données
      * @param name Nom pour identifier l'image
-     * @return true si succès
+     * @return Handle de l'image (invalide si le format n'est pas reconnu)
+     * 
+     * Les données sont copiées, puis décodées par un thread de travail ;
+     * l'image rejoint l'atlas au prochain Update() qui suit. Un fichier
+     * illisible laisse l'image vide (IsLoaded reste faux).
+     */
+    ImageHandle LoadImageFromMemory(const unsigned char* data, int size, const std::string& name);
+
+    /**
+     * @brief Décode un GIF depuis des données en mémoire
+     * @param data Contenu du fichier GIF
+     * @param size Taille des données
+     * @param name Nom pour identifier le GIF
+     * @return Handle du GIF (invalide si aucune frame n'a pu être décodée)
+     * 
+     * Le décodage se fait sur le thread appelant ; les frames rejoignent
+     * l'atlas au prochain Update().
+     */
+    ImageHandle LoadGifFromMemory(const unsigned char* data, size_t size, const std::string& name);
+
+    /**
+     * @brief Ajoute un GIF déjà décodé en frames indexées
+     * 
+     * Les frames rejoignent l'atlas au prochain Update().
+     */
+    ImageHandle LoadDecodedGif(const std::string& name, IndexedGif gif);
+
+    /**
+     * @brief Ajoute une image statique déjà décodée (RGBA)
+     * 
+     * L'image rejoint l'atlas au prochain Update().
+     */
+    ImageHandle LoadImageFromPixels(const std::string& name, std::vector<unsigned char> pixels,
+                                    int width, int height);
+
+    /**
+     * @brief Occupation de l'atlas (nombre d'objets GPU, images rangées)
+     */
+    TextureAtlas::Stats GetAtlasStats() const;
+
+    /**
+     * @struct GifStats
+     * @brief Mémoire CPU des GIFs décodés et volume envoyé au GPU
+     */
+    struct GifStats
+    {
+        size_t gifs = 0;
+        size_t frames = 0;
+        size_t indexedBytes = 0;        // Index et palettes
+        size_t canvasBytes = 0;         // Toiles de composition
+        size_t rgbaBytes = 0;           // Mêmes frames composées en RGBA
+        size_t animating = 0;           // GIFs actifs dans l'ordonnanceur
+        uint64_t uploadedBytes = 0;     // Rectangles envoyés depuis le début
+        uint64_t fullFrameBytes = 0;    // Même nombre de frames envoyées entières
+    };
+
+    /**
+     * @brief Statistiques des GIFs chargés ou en attente d'envoi
      */
-    bool LoadImageFromMemory(const unsigned char* data, int size, const std::string& name);
+    GifStats GetGifStats() const;
+
+    /**
+     * @struct CacheStats
+     * @brief Compteurs du cache de textures
+     */
+    struct CacheStats
+    {
+        uint64_t hits = 0;              // GetCurrentFrame sur un GIF présent dans l'atlas
+        uint64_t misses = 0;            // GetCurrentFrame sur un GIF évincé ou en chargement
+        uint64_t gpuEvictions = 0;      // Zones de l'atlas libérées
+        uint64_t cpuEvictions = 0;      // Frames décodées libérées
+        uint64_t redecodes = 0;         // Décodages relancés depuis le fichier compressé
+        size_t cpuBytes = 0;
+        size_t gpuBytes = 0;
+        size_t cpuBudget = 0;
+        size_t gpuBudget = 0;
+    };
+
+    /**
+     * @brief Compteurs et occupation du cache
+     */
+    CacheStats GetCacheStats() const;
+
+    /**
+     * @struct UploadStats
+     * @brief File d'envoi vers l'atlas
+     */
+    struct UploadStats
+    {
+        size_t queued = 0;              // Images en attente d'envoi
+        size_t queuedBytes = 0;         // Leur taille une fois rangées
+        uint64_t uploads = 0;           // Images rangées depuis le début
+        uint64_t deferredFrames = 0;    // Frames terminées avec des images en attente (budget atteint)
+        size_t maxFrameBytes = 0;       // Plus gros volume rangé en une frame
+        double maxFrameMs = 0.0;        // Plus long temps de rangement en une frame
+    };
+
+    /**
+     * @brief Compteurs de la file d'envoi
+     */
+    UploadStats GetUploadStats() const;
 
 private:
+    /**
+     * @struct ScheduledFrame
+     * @brief Prochaine frame d'une animation, dans le tas de l'ordonnanceur
+     */
+    struct ScheduledFrame
+    {
+        std::chrono::steady_clock::time_point deadline;
+        ImageHandle handle;
+        uint32_t ticket;                    // Périmée si différent de CachedImage::scheduleTicket
+    };
+
+    /**
+     * @struct PendingImage
+     * @brief Résultat d'un chargement, en attente de rangement dans l'atlas
+     * 
+     * Sans frames ni pixels, le chargement a échoué.
+     */
+    struct PendingImage
+    {
+        ImageHandle handle;
+        IndexedGif gif;                     // Frames d'un GIF (vide pour une image statique)
+        std::shared_ptr<const std::vector<unsigned char>> compressed; // Fichier d'origine, s'il est connu
+        std::vector<unsigned char> pixels;  // Image statique RGBA
+        int width = 0;
+        int height = 0;
+        PendingImage* next = nullptr;       // Pile des résultats publiés
+    };
+
     ID3D11Device* m_device;
-    std::map<std::string, AnimatedGif> m_gifs;
-    std::map<std::string, ID3D11ShaderResourceView*> m_staticImages;
-    
+    std::unique_ptr<TextureBackend> m_backend;  // Direct3D 11, ou mémoire CPU sans device
+    std::unique_ptr<TextureAtlas> m_atlas;      // Détruit avant le backend
+    SlotMap<CachedImage> m_images;              // Thread de rendu uniquement
+    std::map<std::string, ImageHandle> m_names; // Nom -> handle (au chargement seulement)
+    std::atomic<PendingImage*> m_published;     // Résultats des threads de chargement (pile sans verrou)
+    uint64_t m_uploadedBytes;                   // Octets de frames envoyés
+    uint64_t m_fullFrameBytes;                  // Octets si chaque frame était envoyée entière
+    std::vector<ScheduledFrame> m_schedule;     // Tas min sur l'échéance
+    std::vector<ImageHandle> m_restoreQueue;    // GIFs évincés redemandés, pas encore rechargés
+    std::vector<std::unique_ptr<PendingImage>> m_uploadQueue; // Résultats en attente d'envoi, par ordre d'arrivée
+    std::vector<unsigned char> m_scaled;        // Zone réduite en cours d'envoi
+    Downloader m_downloader;                    // Copiée par chaque téléchargement lancé
+
     /**
-     * @brief Crée une texture DirectX11 depuis des données RGBA
+     * @struct JobQueue
+     * @brief File de travaux d'un groupe de threads (protégée par m_jobMutex)
      */
-    ID3D11ShaderResourceView* CreateTexture(const unsigned char* data, int width, int height);
+    struct JobQueue
+    {
+        std::condition_variable cv;
+        std::deque<std::function<void()>> jobs;
+    };
+
+    // Threads de décodage (PNG, JPEG, redécodages après éviction) et de
+    // téléchargement, tous joints par le destructeur
+    std::vector<std::thread> m_workers;
+    std::mutex m_jobMutex;
+    JobQueue m_decodeJobs;
+    JobQueue m_downloadJobs;                    // Requêtes bloquantes : à part des décodages
+    bool m_stopWorkers;
+
+    // Cache
+    uint64_t m_frame;                           // Numéro de frame (BeginFrame)
+    size_t m_cpuBudget;
+    size_t m_gpuBudget;
+    CacheStats m_cacheStats;                    // Compteurs (les champs d'occupation sont calculés à la demande)
+
+    // Budget d'envoi de la frame en cours
+    size_t m_uploadBytesBudget;
+    double m_uploadMsBudget;
+    size_t m_frameUploadBytes;
+    double m_frameUploadMs;
+    bool m_frameUploaded;                       // Au moins une image rangée dans la frame
+    bool m_frameDeferred;                       // Budget atteint dans la frame (compté une fois)
+    UploadStats m_uploadStats;                  // Champs de la file calculés à la demande
     
     /**
-     * @brief Télécharge un fichier depuis internet
+     * @brief Handle de l'image de ce nom, créée au besoin
+     */
+    ImageHandle Acquire(const std::string& name);
+
+    /**
+     * @brief Publie un résultat de chargement (n'importe quel thread)
+     */
+    void Publish(std::unique_ptr<PendingImage> image);
+
+    /**
+     * @brief Décode un fichier (GIF, PNG ou JPEG), sans le publier (n'importe quel thread)
+     * @return nullptr si le fichier n'a pas pu être décodé
+     */
+    std::unique_ptr<PendingImage> Decode(ImageHandle handle, std::shared_ptr<const std::vector<unsigned char>> data);
+
+    /**
+     * @brief Décode un fichier (GIF, PNG ou JPEG) et publie le résultat,
+     * même en cas d'échec (n'importe quel thread)
+     * @return false si le fichier n'a pas pu être décodé
+     */
+    bool DecodeAndPublish(ImageHandle handle, std::shared_ptr<const std::vector<unsigned char>> data);
+
+    /**
+     * @brief Confie un travail à un groupe de threads
+     */
+    void Submit(JobQueue& queue, std::function<void()> job);
+
+    /**
+     * @brief Boucle d'un thread de décodage ou de téléchargement
+     */
+    void WorkerLoop(JobQueue* queue);
+
+    /**
+     * @brief Le destructeur a demandé l'arrêt des threads (n'importe quel thread)
+     */
+    bool StopRequested();
+
+    /**
+     * @brief Passe les résultats publiés dans la file d'envoi, puis range
+     * dans l'atlas ce que permet le budget de la frame
+     */
+    void FlushPendingImages();
+
+    /**
+     * @brief Range un résultat de chargement dans l'atlas
+     * @return Octets envoyés
+     */
+    size_t UploadPending(PendingImage& pending);
+
+    /**
+     * @brief Indique si la frame peut encore envoyer une image
+     * @param bytes Taille de l'image une fois rangée
+     */
+    bool UploadBudgetLeft(size_t bytes);
+
+    /**
+     * @brief Nouvelle frame pour le budget d'envoi
+     */
+    void ResetUploadBudget();
+
+    /**
+     * @brief Compte un envoi dans le budget de la frame
+     */
+    void ChargeUpload(size_t bytes, std::chrono::steady_clock::time_point start);
+
+    /**
+     * @brief Taille d'un résultat en attente, une fois rangé dans l'atlas
+     */
+    size_t PendingUploadBytes(const PendingImage& pending) const;
+
+    /**
+     * @brief Compose la première frame, réserve la zone du GIF dans l'atlas
+     * et lance son animation
+     */
+    void UploadGif(ImageHandle handle, CachedImage& image);
+
+    /**
+     * @brief Range la toile courante dans l'atlas, à la taille d'affichage
+     * @return false si l'atlas n'a pas pu la ranger
+     */
+    bool PlaceCanvas(CachedImage& image);
+
+    /**
+     * @brief Envoie une zone modifiée de la toile (réduite au besoin)
+     */
+    void UploadRect(CachedImage& image, const GifRect& dirty);
+
+    /**
+     * @brief Taille d'affichage d'une image (taille du fichier bornée par la cible)
+     */
+    static void DisplaySize(const CachedImage& image, int width, int height, int& displayWidth, int& displayHeight);
+
+    /**
+     * @brief Inscrit la prochaine frame d'un GIF dans l'ordonnanceur
+     * 
+     * Une éventuelle entrée précédente du même GIF devient périmée.
+     */
+    void Schedule(ImageHandle handle, CachedImage& image);
+
+    /**
+     * @brief Passe les frames dues et envoie le rectangle modifié
+     */
+    void AdvanceFrames(CachedImage& image, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Libère la zone d'une image dans l'atlas (et sa toile)
+     */
+    void EvictGpu(CachedImage& image);
+
+    /**
+     * @brief Libère les frames décodées d'un GIF (et sa zone dans l'atlas)
+     */
+    void EvictCpu(CachedImage& image);
+
+    /**
+     * @brief Évince les GIFs les moins récemment dessinés jusqu'à respecter les budgets
+     */
+    void EnforceBudgets();
+
+    /**
+     * @brief Mémoire CPU occupée par les images du cache
      */
-    std::vector<unsigned char> DownloadFile(const std::string& url);
+    size_t GetCpuBytes() const;
     
     /**
-     * @brief Décode un GIF et crée les textures
+     * @brief Télécharge un fichier depuis internet (Downloader par défaut)
+     * @param url URL du fichier
+     * @param authorization Valeur de l'en-tête Authorization (vide : aucun)
+     * @return Corps de la réponse, vide en cas d'échec ou de statut autre que 2xx
      */
-    bool DecodeGif(const std::vector<unsigned char>& data, AnimatedGif& gif);
+    static std::vector<unsigned char> DownloadFile(const std::string& url, const std::string& authorization);
 };
 
 #endif // TEXTURE_MANAGER_H
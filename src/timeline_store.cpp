@@ -0,0 +1,231 @@
+/**
+ * @file timeline_store.cpp
+ * @brief Implémentation du stockage en colonnes des messages
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#include "timeline_store.h"
+
+/**
+ * @brief Ajoute un message à la fin de la timeline
+ *
+ * Les textes sont copiés une seule fois, à la suite dans les arènes.
+ */
+void TimelineStore::Append(std::string_view id, std::string_view sender, std::string_view senderName,
+                           std::string_view content, long long timestamp, bool isOwn)
+{
+    AppendCommon(id, sender, senderName, timestamp, isOwn);
+
+    m_bodyOffsets.push_back(static_cast<uint32_t>(m_bodies.size()));
+    m_bodyLengths.push_back(static_cast<uint32_t>(content.size()));
+    m_bodySources.push_back(BODY_IN_ARENA);
+    m_bodies.insert(m_bodies.end(), content.begin(), content.end());
+}
+
+/**
+ * @brief Ajoute un message dont le corps reste dans la réponse de sync
+ */
+void TimelineStore::AppendRetained(std::string_view id, std::string_view sender, std::string_view senderName,
+                                   const std::shared_ptr<const PayloadChunk>& chunk,
+                                   uint32_t bodyOffset, uint32_t bodyLength,
+                                   long long timestamp, bool isOwn)
+{
+    if (m_retained.empty() || m_retained.back().chunk->serial != chunk->serial)
+    {
+        m_retained.push_back({ chunk, Size() });
+    }
+
+    AppendCommon(id, sender, senderName, timestamp, isOwn);
+
+    m_bodyOffsets.push_back(bodyOffset);
+    m_bodyLengths.push_back(bodyLength);
+    m_bodySources.push_back(chunk->serial);
+}
+
+/**
+ * @brief Recopie dans l'arène les corps des lots plus anciens que serial
+ *
+ * Les messages d'un lot sont contigus à partir de firstIndex : seule cette
+ * plage est parcourue pour chaque bloc libéré.
+ */
+void TimelineStore::CompactChunksBefore(uint32_t serial)
+{
+    while (!m_retained.empty() && m_retained.front().chunk->serial < serial)
+    {
+        const RetainedChunk& retained = m_retained.front();
+        const uint32_t chunkSerial = retained.chunk->serial;
+        const char* data = retained.chunk->data.data();
+        size_t end = m_retained.size() > 1 ? m_retained[1].firstIndex : Size();
+
+        for (size_t i = retained.firstIndex; i < end; ++i)
+        {
+            if (m_bodySources[i] != chunkSerial)
+                continue;
+
+            uint32_t offset = static_cast<uint32_t>(m_bodies.size());
+            m_bodies.insert(m_bodies.end(), data + m_bodyOffsets[i], data + m_bodyOffsets[i] + m_bodyLengths[i]);
+            m_bodyOffsets[i] = offset;
+            m_bodySources[i] = BODY_IN_ARENA;
+        }
+
+        m_retained.pop_front();
+    }
+}
+
+/**
+ * @brief Empreinte FNV-1a 32 bits d'un identifiant
+ *
+ * Calculée une seule fois à l'ajout : le rendu s'en sert comme ID ImGui
+ * sans re-hacher l'identifiant à chaque frame.
+ */
+static uint32_t HashId(std::string_view id)
+{
+    uint32_t hash = 2166136261u;
+    for (char c : id)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Remplit les colonnes communes à tous les messages
+ */
+void TimelineStore::AppendCommon(std::string_view id, std::string_view sender, std::string_view senderName,
+                                 long long timestamp, bool isOwn)
+{
+    if (m_idOffsets.empty())
+    {
+        m_idOffsets.push_back(0);
+    }
+
+    m_senders.push_back(InternSender(sender, senderName));
+    m_timestamps.push_back(timestamp);
+    m_flags.push_back(isOwn ? FLAG_OWN : 0);
+
+    m_ids.insert(m_ids.end(), id.begin(), id.end());
+    m_idOffsets.push_back(static_cast<uint32_t>(m_ids.size()));
+    m_idHashes.push_back(HashId(id));
+}
+
+/**
+ * @brief Retourne une vue sur le message à l'index donné
+ */
+MessageView TimelineStore::Get(size_t index) const
+{
+    MessageView view;
+    uint32_t sender = m_senders[index];
+
+    view.id = std::string_view(m_ids.data() + m_idOffsets[index],
+                               m_idOffsets[index + 1] - m_idOffsets[index]);
+    view.sender = m_senderIds[sender];
+    view.senderName = m_senderNames[sender];
+    view.content = Content(index);
+    view.timestamp = m_timestamps[index];
+    view.idHash = m_idHashes[index];
+    view.isOwn = (m_flags[index] & FLAG_OWN) != 0;
+    return view;
+}
+
+/**
+ * @brief Retourne le corps du message à l'index donné
+ */
+std::string_view TimelineStore::Content(size_t index) const
+{
+    const uint32_t source = m_bodySources[index];
+    if (source == BODY_IN_ARENA)
+        return std::string_view(m_bodies.data() + m_bodyOffsets[index], m_bodyLengths[index]);
+
+    // Peu de lots sont retenus à la fois : recherche depuis le plus récent,
+    // qui contient les messages affichés en bas de l'écran
+    for (size_t c = m_retained.size(); c-- > 0;)
+    {
+        if (m_retained[c].chunk->serial == source)
+            return std::string_view(m_retained[c].chunk->data.data() + m_bodyOffsets[index], m_bodyLengths[index]);
+    }
+    return std::string_view();
+}
+
+/**
+ * @brief Recherche un texte dans les corps des messages
+ *
+ * Parcourt les messages un à un par Content() : l'arène n'est pas dans
+ * l'ordre de la timeline (les corps compactés y sont ajoutés après les
+ * plus récents) et les corps encore retenus sont dans leur réponse de sync.
+ * Seules les colonnes de corps sont lues, sans construire de MessageView.
+ */
+size_t TimelineStore::Find(std::string_view needle, size_t from) const
+{
+    for (size_t i = from; i < Size(); ++i)
+    {
+        if (Content(i).find(needle) != std::string_view::npos)
+            return i;
+    }
+    return Size();
+}
+
+/**
+ * @brief Mémoire occupée par la timeline
+ */
+size_t TimelineStore::BytesUsed() const
+{
+    size_t bytes = m_senders.capacity() * sizeof(uint32_t)
+                 + m_timestamps.capacity() * sizeof(long long)
+                 + m_flags.capacity() * sizeof(uint8_t)
+                 + m_bodyOffsets.capacity() * sizeof(uint32_t)
+                 + m_bodyLengths.capacity() * sizeof(uint32_t)
+                 + m_bodySources.capacity() * sizeof(uint32_t)
+                 + m_idOffsets.capacity() * sizeof(uint32_t)
+                 + m_idHashes.capacity() * sizeof(uint32_t)
+                 + m_bodies.capacity()
+                 + m_ids.capacity();
+
+    for (size_t i = 0; i < m_senderIds.size(); ++i)
+    {
+        bytes += sizeof(std::string) * 2 + m_senderIds[i].capacity() + m_senderNames[i].capacity();
+    }
+    return bytes;
+}
+
+/**
+ * @brief Vide la timeline
+ */
+void TimelineStore::Clear()
+{
+    m_senders.clear();
+    m_timestamps.clear();
+    m_flags.clear();
+    m_bodyOffsets.clear();
+    m_bodyLengths.clear();
+    m_bodySources.clear();
+    m_idOffsets.clear();
+    m_idHashes.clear();
+    m_retained.clear();
+    m_bodies.clear();
+    m_ids.clear();
+    m_senderIds.clear();
+    m_senderNames.clear();
+    m_senderIndex.clear();
+}
+
+/**
+ * @brief Retourne l'index d'un expéditeur, en l'ajoutant si nécessaire
+ */
+uint32_t TimelineStore::InternSender(std::string_view sender, std::string_view senderName)
+{
+    // Cas courant : plusieurs messages d'affilée du même expéditeur
+    if (!m_senders.empty() && m_senderIds[m_senders.back()] == sender)
+        return m_senders.back();
+
+    auto it = m_senderIndex.find(std::string(sender));
+    if (it != m_senderIndex.end())
+        return it->second;
+
+    uint32_t index = static_cast<uint32_t>(m_senderIds.size());
+    m_senderIds.emplace_back(sender);
+    m_senderNames.emplace_back(senderName);
+    m_senderIndex.emplace(m_senderIds.back(), index);
+    return index;
+}
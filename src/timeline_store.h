@@ -0,0 +1,191 @@
+/**
+ * @file timeline_store.h
+ * @brief Stockage en colonnes des messages d'un salon
+ *
+ * Les messages ne sont plus stockés comme un tableau de structures de
+ * std::string : chaque champ a sa propre colonne contiguë et les textes
+ * sont regroupés dans une arène en ajout seul. Parcourir la timeline pour
+ * le rendu ou une recherche ne touche ainsi que quelques blocs mémoire.
+ *
+ * Les corps récents peuvent aussi pointer directement dans la réponse de
+ * synchronisation d'origine (PayloadChunk) : ils ne sont recopiés dans
+ * l'arène qu'au moment où ce lot vieillit et que la réponse est libérée.
+ *
+ * Auteurs: Enzo Dupuy, Eric Deswarte, Mathis abbadie
+ */
+
+#ifndef TIMELINE_STORE_H
+#define TIMELINE_STORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct PayloadChunk
+ * @brief Réponse de synchronisation brute, immuable, partagée par les messages
+ *
+ * Tant qu'un message y fait référence, le bloc reste en vie (shared_ptr).
+ */
+struct PayloadChunk
+{
+    uint32_t serial = 0;    // Numéro du lot de synchronisation (croissant)
+    std::string data;       // Corps JSON tel que reçu du serveur
+};
+
+/**
+ * @struct MessageView
+ * @brief Vue en lecture seule d'un message de la timeline
+ *
+ * Les string_view pointent dans les arènes du TimelineStore ou dans une
+ * réponse de sync retenue : elles ne sont valides que jusqu'au prochain
+ * ajout ou compactage dans ce salon.
+ */
+struct MessageView
+{
+    std::string_view id;          // Identifiant unique du message
+    std::string_view sender;      // Identifiant de l'expéditeur (@user:server)
+    std::string_view senderName;  // Nom d'affichage de l'expéditeur
+    std::string_view content;     // Contenu du message
+    long long timestamp;          // Horodatage serveur (ms depuis epoch)
+    uint32_t idHash;              // Empreinte de l'identifiant (calculée à l'ajout)
+    bool isOwn;                   // true si c'est notre propre message
+};
+
+/**
+ * @class TimelineStore
+ * @brief Timeline d'un salon au format structure-de-tableaux
+ */
+class TimelineStore
+{
+public:
+    /**
+     * @brief Ajoute un message à la fin de la timeline
+     * @param id Identifiant de l'événement
+     * @param sender Identifiant de l'expéditeur
+     * @param senderName Nom d'affichage de l'expéditeur
+     * @param content Corps du message
+     * @param timestamp Horodatage serveur en millisecondes
+     * @param isOwn true si c'est notre propre message
+     */
+    void Append(std::string_view id, std::string_view sender, std::string_view senderName,
+                std::string_view content, long long timestamp, bool isOwn);
+
+    /**
+     * @brief Ajoute un message dont le corps reste dans la réponse de sync
+     * 
+     * Aucune copie du corps : seul un décalage dans le bloc est conservé.
+     * @param chunk Réponse de synchronisation contenant le corps
+     * @param bodyOffset Position du corps dans chunk->data
+     * @param bodyLength Longueur du corps
+     */
+    void AppendRetained(std::string_view id, std::string_view sender, std::string_view senderName,
+                        const std::shared_ptr<const PayloadChunk>& chunk,
+                        uint32_t bodyOffset, uint32_t bodyLength,
+                        long long timestamp, bool isOwn);
+
+    /**
+     * @brief Recopie dans l'arène les corps des lots plus anciens que serial
+     * 
+     * Libère la référence de la timeline sur ces réponses de synchronisation.
+     * @param serial Premier numéro de lot à conserver tel quel
+     */
+    void CompactChunksBefore(uint32_t serial);
+
+    /**
+     * @brief Nombre de messages
+     */
+    size_t Size() const { return m_timestamps.size(); }
+
+    /**
+     * @brief Indique si la timeline est vide
+     */
+    bool Empty() const { return m_timestamps.empty(); }
+
+    /**
+     * @brief Retourne une vue sur le message à l'index donné
+     */
+    MessageView Get(size_t index) const;
+
+    /**
+     * @brief Accès direct aux colonnes pour les parcours rapides
+     */
+    const std::vector<long long>& Timestamps() const { return m_timestamps; }
+    const std::vector<uint8_t>& Flags() const { return m_flags; }
+    std::string_view Content(size_t index) const;
+
+    /**
+     * @brief Recherche un texte dans les corps des messages
+     * @param needle Texte recherché (sensible à la casse)
+     * @param from Index de départ
+     * @return Index du premier message correspondant, ou Size() si absent
+     */
+    size_t Find(std::string_view needle, size_t from = 0) const;
+
+    /**
+     * @brief Mémoire occupée par la timeline (colonnes + arènes + expéditeurs)
+     * 
+     * Les réponses de synchronisation encore référencées ne sont pas comptées :
+     * elles sont partagées entre tous les salons du lot.
+     */
+    size_t BytesUsed() const;
+
+    /**
+     * @brief Vide la timeline
+     */
+    void Clear();
+
+    // Bits de la colonne de flags
+    static constexpr uint8_t FLAG_OWN = 0x01;
+
+private:
+    // Colonnes (une entrée par message)
+    std::vector<uint32_t> m_senders;      // Index dans la table des expéditeurs
+    std::vector<long long> m_timestamps;  // Horodatage serveur (ms)
+    std::vector<uint8_t> m_flags;         // FLAG_OWN...
+    std::vector<uint32_t> m_bodyOffsets;  // Début du corps (dans m_bodies ou dans le bloc)
+    std::vector<uint32_t> m_bodyLengths;  // Longueur du corps
+    std::vector<uint32_t> m_bodySources;  // BODY_IN_ARENA ou numéro du bloc retenu
+    std::vector<uint32_t> m_idOffsets;    // Début de l'identifiant dans m_ids (+ sentinelle)
+    std::vector<uint32_t> m_idHashes;     // Empreinte FNV-1a de l'identifiant
+
+    // Arènes en ajout seul
+    std::vector<char> m_bodies;
+    std::vector<char> m_ids;
+
+    /**
+     * @struct RetainedChunk
+     * @brief Réponse de sync encore référencée et premier message qui y pointe
+     */
+    struct RetainedChunk
+    {
+        std::shared_ptr<const PayloadChunk> chunk;
+        size_t firstIndex;
+    };
+    std::deque<RetainedChunk> m_retained;   // Par numéro de lot croissant
+
+    static constexpr uint32_t BODY_IN_ARENA = 0xFFFFFFFFu;
+
+    // Table des expéditeurs : un salon a peu d'expéditeurs pour beaucoup de messages
+    std::vector<std::string> m_senderIds;
+    std::vector<std::string> m_senderNames;
+    std::unordered_map<std::string, uint32_t> m_senderIndex;
+
+    /**
+     * @brief Retourne l'index d'un expéditeur, en l'ajoutant si nécessaire
+     */
+    uint32_t InternSender(std::string_view sender, std::string_view senderName);
+
+    /**
+     * @brief Remplit les colonnes communes (identifiant, expéditeur, date, flags)
+     */
+    void AppendCommon(std::string_view id, std::string_view sender, std::string_view senderName,
+                      long long timestamp, bool isOwn);
+};
+
+#endif // TIMELINE_STORE_H